@@ -0,0 +1,172 @@
+/*
+  BusBenchmark: Capture Throughput per Mode and Format
+
+  Captures FRAMES_PER_PAIR frames for every resolution and pixel format and
+  prints one CSV line per pair, so results of two releases or two boards
+  can be diffed.
+
+  Hardware Connections:
+    QWIIC --> QWIIC
+
+  Serial:
+    Baudrate: 115200
+
+  Columns:
+    mode, format     CAM_IMAGE_MODE and CAM_IMAGE_PIX_FMT values
+    status           ok, or the CamStatus of the failed capture
+    frames, bytes    Frames measured and image bytes read
+    fps, bytes_s     Measured frame and byte rate
+    bus_util_pct     Share of the time spent in bus transactions
+    capture_us       Trigger to done, per frame
+    drain_us         FIFO read-out, per frame
+    other_us         Everything else, per frame
+    bus_us           Measured bus time, per frame
+    fps_100k, fps_400k, fps_1m
+                     Frame rate with the bus time replaced by the model
+                     of the same traffic at 100 kHz, 400 kHz and 1 MHz
+
+  Notes:
+    The sensor time (exposure and compression) is measured, only the bus
+    part is modelled. Set BUS_OVERHEAD_US to the per-transaction gap seen
+    on your board.
+
+  License: MIT License (https://en.wikipedia.org/wiki/MIT_License)
+  Web: http://www.ArduCAM.com
+*/
+
+#include "Arducam_Qwiic_CAM.h"
+#include "Arducam_Qwiic_TimedBus.h"
+
+#define FRAMES_PER_PAIR   5
+#define READ_LENGTH       255
+#define BUS_OVERHEAD_US   20
+
+Arducam_Qwiic_WireBus wireBus(QWIIC_WIRE);
+Arducam_Qwiic_TimedBus timedBus(wireBus);
+Arducam_Qwiic_CAM myCAM(timedBus);
+
+const CAM_IMAGE_MODE modes[] = {
+  CAM_IMAGE_MODE_96X96, CAM_IMAGE_MODE_128X128, CAM_IMAGE_MODE_QVGA, CAM_IMAGE_MODE_320X320,
+  CAM_IMAGE_MODE_VGA, CAM_IMAGE_MODE_HD, CAM_IMAGE_MODE_UXGA, CAM_IMAGE_MODE_FHD, CAM_IMAGE_MODE_WQXGA2,
+};
+const CAM_IMAGE_PIX_FMT formats[] = {
+  CAM_IMAGE_PIX_FMT_JPG, CAM_IMAGE_PIX_FMT_RGB565, CAM_IMAGE_PIX_FMT_Y8,
+};
+
+uint8_t readBuf[READ_LENGTH];
+
+void runPair(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt);
+CamStatus captureAndDrain(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt, uint32_t* bytes);
+void printModelFps(uint32_t otherUs, uint8_t frames, uint32_t hz);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+
+  if (myCAM.begin() != CAM_ERR_NONE) {
+    Serial.println(F("# camera init failed"));
+    while (true);
+  }
+
+  // Each pair starts with its own discarded frame, retries would skew the numbers
+  myCAM.setCapturePolicy(CAM_POLICY_NONE);
+  timedBus.setOverheadUs(BUS_OVERHEAD_US);
+
+  Serial.print(F("# clock_hz="));
+  Serial.print(timedBus.getClock());
+  Serial.print(F(" overhead_us="));
+  Serial.println(BUS_OVERHEAD_US);
+  Serial.println(F("mode,format,status,frames,bytes,fps,bytes_s,bus_util_pct,"
+                   "capture_us,drain_us,other_us,bus_us,fps_100k,fps_400k,fps_1m"));
+
+  for (uint8_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+    for (uint8_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+      runPair(modes[m], formats[f]);
+    }
+  }
+  Serial.println(F("# done"));
+}
+
+void loop() {
+}
+
+CamStatus captureAndDrain(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt, uint32_t* bytes) {
+  CamStatus ret = myCAM.takePicture(mode, fmt);
+  if (ret != CAM_ERR_NONE) {
+    return ret;
+  }
+  while (myCAM.getUnreceivedLength() > 0) {
+    size_t n = myCAM.readImageBuf(readBuf, sizeof(readBuf));
+    if (n == 0) {
+      break;
+    }
+    *bytes += n;
+  }
+  return CAM_ERR_NONE;
+}
+
+void runPair(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt) {
+  uint32_t bytes = 0;
+  uint32_t captureUs = 0;
+  uint32_t drainUs = 0;
+
+  // Settle the sensor in the new mode and format first
+  CamStatus ret = captureAndDrain(mode, fmt, &bytes);
+  bytes = 0;
+  timedBus.reset();
+
+  unsigned long startUs = micros();
+  uint8_t frames = 0;
+  while (ret == CAM_ERR_NONE && frames < FRAMES_PER_PAIR) {
+    ret = captureAndDrain(mode, fmt, &bytes);
+    if (ret == CAM_ERR_NONE) {
+      const CamFrameInfo& info = myCAM.getFrameInfo();
+      captureUs += info.doneUs - info.triggerUs;
+      drainUs += info.drainEndUs - info.drainStartUs;
+      frames++;
+    }
+  }
+  uint32_t elapsedUs = micros() - startUs;
+
+  Serial.print(mode);
+  Serial.print(',');
+  Serial.print(fmt);
+  Serial.print(',');
+  if (ret != CAM_ERR_NONE || frames == 0) {
+    Serial.print(F("err"));
+    Serial.println(ret);
+    return;
+  }
+
+  const CamBusCounters& bus = timedBus.getCounters();
+  uint32_t otherUs = (elapsedUs > bus.busyUs) ? elapsedUs - bus.busyUs : 0;
+
+  Serial.print(F("ok,"));
+  Serial.print(frames);
+  Serial.print(',');
+  Serial.print(bytes);
+  Serial.print(',');
+  Serial.print(frames * 1000000.0 / elapsedUs, 2);
+  Serial.print(',');
+  Serial.print((uint32_t)(bytes * 1000000.0 / elapsedUs));
+  Serial.print(',');
+  Serial.print(bus.busyUs * 100.0 / elapsedUs, 1);
+  Serial.print(',');
+  Serial.print(captureUs / frames);
+  Serial.print(',');
+  Serial.print(drainUs / frames);
+  Serial.print(',');
+  Serial.print((elapsedUs - captureUs - drainUs) / frames);
+  Serial.print(',');
+  Serial.print(bus.busyUs / frames);
+  printModelFps(otherUs, frames, 100000);
+  printModelFps(otherUs, frames, 400000);
+  printModelFps(otherUs, frames, 1000000);
+  Serial.println();
+}
+
+void printModelFps(uint32_t otherUs, uint8_t frames, uint32_t hz) {
+  uint32_t frameUs = (otherUs + timedBus.modelUs(hz)) / frames;
+  Serial.print(',');
+  Serial.print(frameUs > 0 ? 1000000.0 / frameUs : 0.0, 2);
+}
@@ -4,7 +4,10 @@
   A full-featured web interface for the Arducam Qwiic CAM.
   Left sidebar with all camera controls, right pane with
   live image preview. Supports single capture and polling
-  live view modes.
+  live view modes. /stream serves MJPEG to up to STREAM_CLIENTS
+  viewers at once, each frame is read from the camera once.
+  Captures and stream parts carry X-Frame-Seq and X-Capture-Us
+  headers for latency and dropped frame measurements.
 
   Hardware Connections:
     QWIIC --> QWIIC
@@ -26,14 +29,25 @@
   Web: http://www.ArduCAM.com
 */
 #include "Arducam_Qwiic_CAM.h"
+#include "Arducam_Qwiic_Broadcaster.h"
 #include <WiFiS3.h>
 
 Arducam_Qwiic_CAM myCAM;
 
-#define IMAGE_BUF_SIZE 2000
+#define STREAM_CLIENTS 3
+
+// WiFiS3 does not report free send space, a viewer whose writes block skips frames
+WiFiClient streamClients[STREAM_CLIENTS];
+Arducam_Qwiic_ClientSink streamSinks[STREAM_CLIENTS] = {
+  Arducam_Qwiic_ClientSink(streamClients[0], false),
+  Arducam_Qwiic_ClientSink(streamClients[1], false),
+  Arducam_Qwiic_ClientSink(streamClients[2], false),
+};
+Arducam_Qwiic_Broadcaster broadcaster;
+bool streamVideo = false;
+CAM_IMAGE_MODE streamMode = CAM_IMAGE_MODE_QVGA;
 
 uint32_t imageLength = 0;
-uint8_t imageBuf[IMAGE_BUF_SIZE];
 
 const char* ssid = "Arducam_Qwiic_CAM";
 const char* pass = "123456789";
@@ -50,7 +64,11 @@ CAM_COLOR_FX currentColorFx            = CAM_COLOR_FX_NONE;
 
 void handleCapture(WiFiClient& client, const String& path);
 void handleSet(WiFiClient& client, const String& path);
-void handleStream(WiFiClient& client);
+void handleRequest(WiFiClient& client);
+bool handleStream(WiFiClient& client);
+void serveStream(void);
+void stopStream(void);
+void printFrameHeaders(WiFiClient& client);
 void applyCurrentSettings(void);
 
 bool isSmallRawMode(CAM_IMAGE_MODE mode);
@@ -348,6 +366,7 @@ void setup() {
   }
 
   applyCurrentSettings();
+  broadcaster.setFrameHeaders(true);
 
   WiFi.config(IPAddress(192, 168, 4, 1));
 
@@ -361,8 +380,14 @@ void setup() {
 
 void loop() {
   WiFiClient client = server.available();
-  if (!client) return;
+  if (client) {
+    handleRequest(client);
+  }
 
+  serveStream();
+}
+
+void handleRequest(WiFiClient& client) {
   String reqLine = client.readStringUntil('\n');
   reqLine.trim();
 
@@ -383,7 +408,9 @@ void loop() {
   } else if (path.startsWith("/capture")) {
     handleCapture(client, path);
   } else if (path.startsWith("/stream")) {
-    handleStream(client);
+    if (handleStream(client)) {
+      return; // Kept open for the broadcaster
+    }
   } else if (path.startsWith("/set")) {
     handleSet(client, path);
   } else {
@@ -400,6 +427,8 @@ void loop() {
 }
 
 void handleCapture(WiFiClient& client, const String& path) {
+  stopStream(); // Restarted by serveStream() for the next stream frame
+
   CAM_IMAGE_MODE mode = currentMode;
   CAM_IMAGE_PIX_FMT pixFmt = currentPixelFormat;
 
@@ -451,22 +480,13 @@ void handleCapture(WiFiClient& client, const String& path) {
                    "Content-Type: image/jpeg\r\n"
                    "Content-Length: "));
     client.print(imageLength);
-    client.print(F("\r\n"
-                   "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+    client.print(F("\r\n"));
+    printFrameHeaders(client);
+    client.print(F("Cache-Control: no-cache, no-store, must-revalidate\r\n"
                    "Pragma: no-cache\r\n"
                    "Connection: close\r\n\r\n"));
 
-    uint32_t totalRead = 0;
-    while (totalRead < imageLength) {
-      uint32_t toRead = IMAGE_BUF_SIZE;
-      if (toRead > imageLength - totalRead) toRead = imageLength - totalRead;
-
-      uint32_t actual = myCAM.readImageBuf(imageBuf, toRead);
-      if (actual == 0) break;
-
-      client.write(imageBuf, actual);
-      totalRead += actual;
-    }
+    uint32_t totalRead = myCAM.readImageTo(client);
 
     Serial.print(F("Image bytes sent: "));
     Serial.println(totalRead);
@@ -489,74 +509,78 @@ void handleCapture(WiFiClient& client, const String& path) {
   client.print(height);
   client.print(F("\r\nX-Raw-Length: "));
   client.print(imageLength);
-  client.print(F("\r\nCache-Control: no-cache, no-store, must-revalidate\r\n"
+  client.print(F("\r\n"));
+  printFrameHeaders(client);
+  client.print(F("Cache-Control: no-cache, no-store, must-revalidate\r\n"
                  "Pragma: no-cache\r\n"
                  "Connection: close\r\n\r\n"));
 
-  uint32_t totalRead = 0;
-  while (totalRead < imageLength) {
-    uint32_t toRead = IMAGE_BUF_SIZE;
-    if (toRead > imageLength - totalRead) toRead = imageLength - totalRead;
-
-    uint32_t actual = myCAM.readImageBuf(imageBuf, toRead);
-    if (actual == 0) break;
-
-    client.write(imageBuf, actual);
-    totalRead += actual;
-  }
+  uint32_t totalRead = myCAM.readImageTo(client);
 
   Serial.print(F("RAW bytes sent to browser: "));
   Serial.println(totalRead);
 }
 
-void handleStream(WiFiClient& client) {
-  client.print(F("HTTP/1.1 200 OK\r\n"
-                  "Content-Type: multipart/x-mixed-replace; boundary=frame\r\n"
-                  "Cache-Control: no-cache, no-store, must-revalidate\r\n"
-                  "Pragma: no-cache\r\n"
-                  "Connection: keep-alive\r\n\r\n"));
-
-  while (client.connected()) {
-    CamStatus ret = myCAM.takePicture(currentMode, CAM_IMAGE_PIX_FMT_JPG);
+void printFrameHeaders(WiFiClient& client) {
+  const CamFrameInfo& info = myCAM.getFrameInfo();
+  client.print(F("X-Frame-Seq: "));
+  client.print(info.seq);
+  client.print(F("\r\nX-Capture-Us: "));
+  client.print(info.triggerUs);
+  client.print(F("\r\n"));
+}
 
-    if (ret != CAM_ERR_NONE) {
-      Serial.println(F("Stream capture failed!"));
-      break;
+bool handleStream(WiFiClient& client) {
+  for (uint8_t i = 0; i < STREAM_CLIENTS; i++) {
+    if (broadcaster.contains(&streamSinks[i])) {
+      continue;
     }
+    streamClients[i] = client;
+    if (broadcaster.add(streamSinks[i]) < 0) {
+      return false;
+    }
+    Serial.print(F("Stream viewer added, viewers: "));
+    Serial.println(broadcaster.getClientCount());
+    return true;
+  }
 
-    uint32_t len = myCAM.getTotalLength();
-
-    client.print(F("--frame\r\nContent-Type: "));
-    client.print(F("image/jpeg"));
-    client.print(F("\r\nContent-Length: "));
-    client.print(len);
-    client.print(F("\r\nX-Pixel-Format: "));
-    client.print(F("JPEG"));
-    client.print(F("\r\n\r\n"));
-
-    uint32_t totalRead = 0;
-
-    while (totalRead < len) {
-      uint32_t toRead = IMAGE_BUF_SIZE;
+  client.print(F("HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n"));
+  return false;
+}
 
-      if (toRead > len - totalRead) {
-        toRead = len - totalRead;
-      }
+void serveStream(void) {
+  if (broadcaster.prune() == 0) {
+    stopStream();
+    return;
+  }
 
-      uint32_t actual = myCAM.readImageBuf(imageBuf, toRead);
+  // QVGA and VGA keep the sensor in video mode, other resolutions capture frame by frame
+  bool videoMode = (currentMode == CAM_IMAGE_MODE_QVGA || currentMode == CAM_IMAGE_MODE_VGA);
+  if (streamVideo && (!videoMode || streamMode != currentMode)) {
+    stopStream();
+  }
+  if (videoMode && !streamVideo) {
+    myCAM.startVideo(currentMode == CAM_IMAGE_MODE_VGA ? CAM_VIDEO_MODE_1 : CAM_VIDEO_MODE_0);
+    streamVideo = true;
+    streamMode = currentMode;
+  }
 
-      if (actual == 0) {
-        break;
-      }
+  CamStatus ret = streamVideo ? myCAM.nextFrame()
+                              : myCAM.takePicture(currentMode, CAM_IMAGE_PIX_FMT_JPG);
+  if (ret != CAM_ERR_NONE) {
+    Serial.println(F("Stream capture failed!"));
+    return;
+  }
 
-      client.write(imageBuf, actual);
-      totalRead += actual;
-    }
+  // Each frame is read once and written to every viewer
+  broadcaster.broadcast(myCAM);
+}
 
-    client.print(F("\r\n"));
+void stopStream(void) {
+  if (streamVideo) {
+    myCAM.stopVideo();
+    streamVideo = false;
   }
-
-  Serial.println(F("Stream ended"));
 }
 
 void handleSet(WiFiClient& client, const String& path) {
@@ -605,38 +629,46 @@ void handleSet(WiFiClient& client, const String& path) {
 
     } else if (key == "quality") {
       currentQuality = (IMAGE_QUALITY)val;
-      myCAM.setImageQuality(currentQuality);
 
     } else if (key == "brightness") {
       currentBrightness = (CAM_BRIGHTNESS_LEVEL)val;
-      myCAM.setBrightness(currentBrightness);
 
     } else if (key == "contrast") {
       currentContrast = (CAM_CONTRAST_LEVEL)val;
-      myCAM.setContrast(currentContrast);
 
     } else if (key == "saturation") {
       currentSaturation = (CAM_SATURATION_LEVEL)val;
-      myCAM.setSaturation(currentSaturation);
 
     } else if (key == "wb") {
       currentWB = (CAM_WHITE_BALANCE)val;
-      myCAM.setAutoWhiteBalanceMode(currentWB);
 
     } else if (key == "colorfx") {
       currentColorFx = (CAM_COLOR_FX)val;
-      myCAM.setColorEffect(currentColorFx);
     }
   }
 
+  applyCurrentSettings();
+
   client.print(F("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nOK"));
 }
 
 void applyCurrentSettings(void) {
-  myCAM.setImageQuality(currentQuality);
-  myCAM.setBrightness(currentBrightness);
-  myCAM.setContrast(currentContrast);
-  myCAM.setSaturation(currentSaturation);
-  myCAM.setAutoWhiteBalanceMode(currentWB);
-  myCAM.setColorEffect(currentColorFx);
+  CameraSettings settings = Arducam_Qwiic_CAM::defaultSettings();
+  settings.quality = currentQuality;
+  settings.brightness = currentBrightness;
+  settings.contrast = currentContrast;
+  settings.saturation = currentSaturation;
+  settings.whiteBalance = currentWB;
+  settings.colorEffect = currentColorFx;
+
+  uint8_t failed = 0;
+  myCAM.applySettings(settings,
+                      CAM_SETTING_QUALITY | CAM_SETTING_BRIGHTNESS |
+                      CAM_SETTING_CONTRAST | CAM_SETTING_SATURATION |
+                      CAM_SETTING_WHITE_BALANCE | CAM_SETTING_COLOR_EFFECT,
+                      &failed);
+  if (failed) {
+    Serial.print(F("Settings not applied, mask 0x"));
+    Serial.println(failed, HEX);
+  }
 }
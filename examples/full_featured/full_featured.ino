@@ -17,13 +17,16 @@
     Camera to Host:
       0x55 0xAA [packet type] [payload length, little-endian] [payload] 0x55 0xBB
 
+    Define PROTOCOL_CRC as 1 to add a CRC-32 before the tail of every packet
+    (packet type | 0x80). The host software must support it.
+
   Capture:
     Format: JPEG / RGB565 / Y8
     Resolution: 96x96 / 128x128 / QVGA / VGA / HD / UXGA / FHD / WQXGA2
     Quality: High / Default / Low
 
   Video:
-    Stream mode is implemented by repeatedly calling takePicture().
+    Stream mode keeps the sensor in video mode (startVideo() / nextFrame()).
     Supports JPEG stream preview:
       1: 320x240
       2: 640x480
@@ -48,21 +51,19 @@
 */
 
 #include "Arducam_Qwiic_CAM.h"
+#include "Arducam_Qwiic_Protocol.h"
 #include <string.h>
 
-Arducam_Qwiic_CAM myCAM;
-
 #define SERIAL_BAUD              921600
 #define READ_IMAGE_LENGTH        255
-#define COMMAND_BUF_SIZE         32
-#define COMMAND_TIMEOUT_MS       200
-#define CAPTURE_RETRY_COUNT      3
 
-#define FORCE_RECONFIG_ON_FORMAT_CHANGE   1
-
-#define DISCARD_FIRST_CAPTURE_AFTER_START 1
+#if !defined(PROTOCOL_CRC)
+#define PROTOCOL_CRC             0
+#endif
 
-#define FORCE_RECONFIG_MODE ((CAM_IMAGE_MODE)0)
+Arducam_Qwiic_CAM myCAM;
+Arducam_Qwiic_CommandDecoder commandDecoder;
+Arducam_Qwiic_PacketWriter packetWriter(Serial, PROTOCOL_CRC);
 
 #define RESET_CAMERA                0xFF
 #define SET_PICTURE_RESOLUTION      0x01
@@ -90,13 +91,6 @@ Arducam_Qwiic_CAM myCAM;
 #define PACKET_TEXT                 0x07
 #define PACKET_STARTUP              0x08
 
-uint8_t commandBuff[COMMAND_BUF_SIZE];
-uint8_t commandLength = 0;
-bool receivingCommand = false;
-uint32_t lastCommandByteMs = 0;
-
-uint8_t imageBuf[READ_IMAGE_LENGTH];
-
 CAM_IMAGE_MODE currentPictureMode = CAM_IMAGE_MODE_QVGA;
 CAM_IMAGE_PIX_FMT currentPixelFormat = CAM_IMAGE_PIX_FMT_JPG;
 IMAGE_QUALITY currentImageQuality = DEFAULT_QUALITY;
@@ -104,33 +98,21 @@ IMAGE_QUALITY currentImageQuality = DEFAULT_QUALITY;
 bool streamActive = false;
 CAM_IMAGE_MODE currentStreamMode = CAM_IMAGE_MODE_QVGA;
 
-bool forceReconfigBeforeNextCapture = false;
-
-bool discardFirstCaptureAfterStart = true;
-
 void handleSerialProtocol(void);
 void processCommand(const uint8_t* command, uint8_t length);
 
 bool initCamera(void);
-bool takePictureWithRetry(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt);
 bool takeOnePicture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt);
-void forceReconfigBeforeCaptureIfNeeded(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt);
-void discardFirstCaptureIfNeeded(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt);
 
 void sendCurrentPicture(void);
+void startStream(void);
 void sendStreamFrame(void);
 void stopStreamAndReply(void);
-void sendRawFifoPayload(uint32_t imageLength);
 
 bool protocolVideoParamToMode(uint8_t param, CAM_IMAGE_MODE* mode);
 bool protocolPictureParamToMode(uint8_t param, CAM_IMAGE_MODE* mode);
 bool protocolPixelFormatToFmt(uint8_t fmt, CAM_IMAGE_PIX_FMT* pixelFmt);
 
-void sendFrameHeader(uint8_t packetType, uint32_t length);
-void sendFrameTail(void);
-void writeU32LE(uint32_t value);
-void writeByte(uint8_t value);
-void writeBytes(const uint8_t* data, uint32_t length);
 void sendDataPack(uint8_t packetType, const char* msg);
 void sendCameraInfo(void);
 void sendFirmwareVersion(void);
@@ -149,8 +131,8 @@ void setup() {
 
   myCAM.setImageQuality(currentImageQuality);
 
-  discardFirstCaptureAfterStart = true;
-  forceReconfigBeforeNextCapture = false;
+  // Warm-up, format reconfiguration and retries are handled by takePicture()
+  myCAM.setCapturePolicy(CAM_POLICY_DEFAULT);
 
   sendDataPack(PACKET_TEXT, "Hello Arduino UNO R4 WiFi!");
   sendDataPack(PACKET_STARTUP, "Qwiic CAM start!");
@@ -184,38 +166,15 @@ bool initCamera(void) {
 void handleSerialProtocol(void) {
   while (Serial.available() > 0) {
     uint8_t b = (uint8_t)Serial.read();
-    lastCommandByteMs = millis();
-
-    if (!receivingCommand) {
-      if (b == 0x55) {
-        receivingCommand = true;
-        commandLength = 0;
-      }
-      continue;
-    }
-
-    if (b == 0xAA) {
-      if (commandLength > 0) {
-        processCommand(commandBuff, commandLength);
-      }
-      receivingCommand = false;
-      commandLength = 0;
-      continue;
-    }
-
-    if (commandLength < COMMAND_BUF_SIZE) {
-      commandBuff[commandLength++] = b;
-    } else {
-      receivingCommand = false;
-      commandLength = 0;
+    CAM_PROTO_CMD_RESULT result = commandDecoder.feed(b, millis());
+    if (result == CAM_PROTO_CMD_READY) {
+      processCommand(commandDecoder.getCommand(), commandDecoder.getLength());
+    } else if (result == CAM_PROTO_CMD_OVERFLOW) {
       sendDataPack(PACKET_TEXT, "Command buffer overflow");
     }
   }
 
-  if (receivingCommand && (millis() - lastCommandByteMs > COMMAND_TIMEOUT_MS)) {
-    receivingCommand = false;
-    commandLength = 0;
-  }
+  commandDecoder.checkTimeout(millis());
 }
 
 void processCommand(const uint8_t* command, uint8_t length) {
@@ -241,12 +200,6 @@ void processCommand(const uint8_t* command, uint8_t length) {
         break;
       }
 
-#if FORCE_RECONFIG_ON_FORMAT_CHANGE
-      if (mappedFmt != currentPixelFormat) {
-        forceReconfigBeforeNextCapture = true;
-      }
-#endif
-
       currentPictureMode = mappedMode;
       currentPixelFormat = mappedFmt;
 
@@ -257,17 +210,10 @@ void processCommand(const uint8_t* command, uint8_t length) {
       if (length >= 2) {
         CAM_IMAGE_MODE mode;
         if (protocolVideoParamToMode(command[1], &mode)) {
-#if FORCE_RECONFIG_ON_FORMAT_CHANGE
-          if (currentPixelFormat != CAM_IMAGE_PIX_FMT_JPG ||
-              currentPictureMode != mode) {
-            forceReconfigBeforeNextCapture = true;
-          }
-#endif
-
           currentStreamMode = mode;
           currentPictureMode = mode;
           currentPixelFormat = CAM_IMAGE_PIX_FMT_JPG;
-          streamActive = true;
+          startStream();
         }
       }
       break;
@@ -301,13 +247,24 @@ void processCommand(const uint8_t* command, uint8_t length) {
       sendCameraInfo();
       break;
 
-    case TAKE_PICTURE:
-      if (takePictureWithRetry(currentPictureMode, currentPixelFormat)) {
+    case TAKE_PICTURE: {
+      bool resumeStream = streamActive;
+      if (resumeStream) {
+        myCAM.stopVideo();
+        streamActive = false;
+      }
+
+      if (takeOnePicture(currentPictureMode, currentPixelFormat)) {
         sendCurrentPicture();
       } else {
         sendDataPack(PACKET_TEXT, "Capture failed");
       }
+
+      if (resumeStream) {
+        startStream();
+      }
       break;
+    }
 
     case SET_SHARPNESS:
       if (length >= 2) myCAM.setSharpness((CAM_SHARPNESS_LEVEL)command[1]);
@@ -334,12 +291,13 @@ void processCommand(const uint8_t* command, uint8_t length) {
       break;
 
     case RESET_CAMERA:
-      streamActive = false;
+      if (streamActive) {
+        myCAM.stopVideo();
+        streamActive = false;
+      }
       myCAM.reset();
-      delay(200);
-
-      discardFirstCaptureAfterStart = true;
-      forceReconfigBeforeNextCapture = true;
+      // Brightness, quality and the other controls survive the reset
+      myCAM.restoreSettings();
 
       sendDataPack(PACKET_STARTUP, "Camera reset");
       break;
@@ -364,53 +322,6 @@ bool takeOnePicture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt) {
   return (status == CAM_ERR_NONE && len > 0);
 }
 
-void discardFirstCaptureIfNeeded(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt) {
-#if DISCARD_FIRST_CAPTURE_AFTER_START
-  if (!discardFirstCaptureAfterStart) {
-    return;
-  }
-
-  discardFirstCaptureAfterStart = false;
-
-  myCAM.takePicture(mode, fmt);
-  delay(80);
-#else
-  (void)mode;
-  (void)fmt;
-#endif
-}
-
-void forceReconfigBeforeCaptureIfNeeded(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt) {
-#if FORCE_RECONFIG_ON_FORMAT_CHANGE
-  if (!forceReconfigBeforeNextCapture) {
-    return;
-  }
-
-  forceReconfigBeforeNextCapture = false;
-
-  myCAM.takePicture(FORCE_RECONFIG_MODE, fmt);
-  delay(80);
-#else
-  (void)mode;
-  (void)fmt;
-#endif
-}
-
-bool takePictureWithRetry(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt) {
-
-  discardFirstCaptureIfNeeded(mode, fmt);
-  forceReconfigBeforeCaptureIfNeeded(mode, fmt);
-
-  for (uint8_t i = 0; i < CAPTURE_RETRY_COUNT; i++) {
-    if (takeOnePicture(mode, fmt)) {
-      return true;
-    }
-    delay(50);
-  }
-
-  return false;
-}
-
 void sendCurrentPicture(void) {
   uint32_t imageLength = myCAM.getTotalLength();
   if (imageLength == 0) {
@@ -418,21 +329,18 @@ void sendCurrentPicture(void) {
     return;
   }
 
-  sendFrameHeader(PACKET_IMAGE, imageLength);
-  sendRawFifoPayload(imageLength);
-  sendFrameTail();
+  packetWriter.sendImage(myCAM, PACKET_IMAGE, READ_IMAGE_LENGTH);
 }
 
-void sendRawFifoPayload(uint32_t imageLength) {
-  uint32_t remaining = imageLength;
-  while (remaining > 0) {
-    uint8_t block = (remaining > READ_IMAGE_LENGTH) ? READ_IMAGE_LENGTH : (uint8_t)remaining;
-    uint32_t n = myCAM.readImageBuf(imageBuf, block);
-    if (n == 0) {
-      break;
-    }
-    writeBytes(imageBuf, n);
-    remaining -= n;
+void startStream(void) {
+  if (streamActive) {
+    myCAM.stopVideo();
+  }
+
+  CAM_VIDEO_MODE videoMode = (currentStreamMode == CAM_IMAGE_MODE_VGA) ? CAM_VIDEO_MODE_1 : CAM_VIDEO_MODE_0;
+  streamActive = (myCAM.startVideo(videoMode) == CAM_ERR_NONE);
+  if (!streamActive) {
+    sendDataPack(PACKET_TEXT, "Video start failed");
   }
 }
 
@@ -440,17 +348,7 @@ void sendStreamFrame(void) {
   handleSerialProtocol();
   if (!streamActive) return;
 
-#if FORCE_RECONFIG_ON_FORMAT_CHANGE
-  if (currentPixelFormat != CAM_IMAGE_PIX_FMT_JPG ||
-      currentPictureMode != currentStreamMode) {
-    forceReconfigBeforeNextCapture = true;
-  }
-#endif
-
-  currentPixelFormat = CAM_IMAGE_PIX_FMT_JPG;
-  currentPictureMode = currentStreamMode;
-
-  if (takePictureWithRetry(currentStreamMode, CAM_IMAGE_PIX_FMT_JPG)) {
+  if (myCAM.nextFrame() == CAM_ERR_NONE) {
     sendCurrentPicture();
   }
 
@@ -458,6 +356,9 @@ void sendStreamFrame(void) {
 }
 
 void stopStreamAndReply(void) {
+  if (streamActive) {
+    myCAM.stopVideo();
+  }
   streamActive = false;
   sendStreamOff();
 }
@@ -481,71 +382,30 @@ void sendCameraInfo(void) {
            sensorId, yearId, monthId, dayId);
 
   uint32_t len = strlen(info);
-  sendFrameHeader(PACKET_CAMERA_INFO, len);
-  writeBytes((const uint8_t*)info, len);
-  sendFrameTail();
+  packetWriter.send(PACKET_CAMERA_INFO, (const uint8_t*)info, len);
 }
 
 void sendFirmwareVersion(void) {
   uint8_t ver[4] = {0x25, 0x06, 0x15, 0x10};
-  sendFrameHeader(PACKET_FW_VERSION, sizeof(ver));
-  writeBytes(ver, sizeof(ver));
-  sendFrameTail();
+  packetWriter.send(PACKET_FW_VERSION, ver, sizeof(ver));
 }
 
 void sendSdkVersion(void) {
   const char sdk[] = "2.0.0\r\n";
-  sendFrameHeader(PACKET_SDK_VERSION, strlen(sdk));
-  writeBytes((const uint8_t*)sdk, strlen(sdk));
-  sendFrameTail();
+  packetWriter.send(PACKET_SDK_VERSION, (const uint8_t*)sdk, strlen(sdk));
 }
 
 void sendStreamOff(void) {
   const char msg[] = "streamoff";
-  sendFrameHeader(PACKET_STATUS, strlen(msg));
-  writeBytes((const uint8_t*)msg, strlen(msg));
-  sendFrameTail();
+  packetWriter.send(PACKET_STATUS, (const uint8_t*)msg, strlen(msg));
 }
 
 void sendDataPack(uint8_t packetType, const char* msg) {
-  uint32_t len = strlen(msg) + 2;
-  sendFrameHeader(packetType, len);
-  writeBytes((const uint8_t*)msg, strlen(msg));
-  writeByte('\r');
-  writeByte('\n');
-  sendFrameTail();
-}
-
-void sendFrameHeader(uint8_t packetType, uint32_t length) {
-  writeByte(0x55);
-  writeByte(0xAA);
-  writeByte(packetType);
-  writeU32LE(length);
-}
-
-void sendFrameTail(void) {
-  writeByte(0x55);
-  writeByte(0xBB);
-}
-
-void writeU32LE(uint32_t value) {
-  writeByte((uint8_t)(value & 0xFF));
-  writeByte((uint8_t)((value >> 8) & 0xFF));
-  writeByte((uint8_t)((value >> 16) & 0xFF));
-  writeByte((uint8_t)((value >> 24) & 0xFF));
-}
-
-void writeByte(uint8_t value) {
-  Serial.write(value);
-}
-
-void writeBytes(const uint8_t* data, uint32_t length) {
-  while (length > 0) {
-    size_t chunk = (length > 64) ? 64 : (size_t)length;
-    Serial.write(data, chunk);
-    data += chunk;
-    length -= chunk;
-  }
+  uint32_t len = strlen(msg);
+  packetWriter.begin(packetType, len + 2);
+  packetWriter.write((const uint8_t*)msg, len);
+  packetWriter.write((const uint8_t*)"\r\n", 2);
+  packetWriter.end();
 }
 
 bool protocolVideoParamToMode(uint8_t param, CAM_IMAGE_MODE* mode) {
@@ -0,0 +1,169 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// RLE compression ratio and throughput per format and frame content
+//
+// Compresses QVGA frames chunk by chunk, the way readImageBuf() hands them
+// out, decompresses them again and prints one CSV line per format and
+// content. Unlike the other benchmarks the throughput is host CPU time, so
+// compare the rows with each other rather than with a microcontroller.
+//
+// Usage: bench_compress [--repeat N] [--chunk N]
+
+#include "Arducam_Qwiic_Compress.h"
+#include "Arducam_Qwiic_SimBus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FRAME_WIDTH   320
+#define FRAME_HEIGHT  240
+#define FRAME_SIZE    (FRAME_WIDTH * FRAME_HEIGHT * 2)
+
+static uint8_t frame[FRAME_SIZE];
+static uint8_t packed[CAM_RLE_MAX_OUTPUT(FRAME_SIZE) + FRAME_SIZE / 8];
+static uint8_t unpacked[FRAME_SIZE];
+
+static uint32_t rngState = 0x2545f491;
+
+static uint32_t rng(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+typedef enum {
+    CONTENT_SIM = 0,   // Block pattern of the simulated module
+    CONTENT_GRADIENT,  // Smooth shading with sensor noise in the low bits
+    CONTENT_NOISE,     // Random bytes, the worst case
+    CONTENT_COUNT
+} Content;
+
+static const char* contentNames[CONTENT_COUNT] = {"sim", "gradient", "noise"};
+
+static size_t fillFrame(CAM_IMAGE_PIX_FMT fmt, Content content)
+{
+    size_t bpp = (fmt == CAM_IMAGE_PIX_FMT_RGB565) ? 2 : 1;
+    size_t length = (size_t)FRAME_WIDTH * FRAME_HEIGHT * bpp;
+
+    if (content == CONTENT_SIM) {
+        Arducam_Qwiic_SimBus sim;
+        Arducam_Qwiic_CAM cam(sim);
+        if (cam.begin() != CAM_ERR_NONE || cam.takePicture(CAM_IMAGE_MODE_QVGA, fmt) != CAM_ERR_NONE) {
+            return 0;
+        }
+        for (size_t i = 0; i < length; i++) {
+            frame[i] = sim.fifoByte((uint32_t)i);
+        }
+        return length;
+    }
+
+    for (size_t y = 0; y < FRAME_HEIGHT; y++) {
+        for (size_t x = 0; x < FRAME_WIDTH; x++) {
+            size_t pos = (y * FRAME_WIDTH + x) * bpp;
+            if (content == CONTENT_NOISE) {
+                for (size_t b = 0; b < bpp; b++) {
+                    frame[pos + b] = (uint8_t)rng();
+                }
+                continue;
+            }
+            uint8_t level = (uint8_t)((x + y) / 2 + (rng() & 1));
+            if (bpp == 1) {
+                frame[pos] = level;
+            } else {
+                // RGB565 big endian, grey
+                uint16_t pixel = (uint16_t)(((level >> 3) << 11) | ((level >> 2) << 5) | (level >> 3));
+                frame[pos] = (uint8_t)(pixel >> 8);
+                frame[pos + 1] = (uint8_t)pixel;
+            }
+        }
+    }
+    return length;
+}
+
+static double seconds(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static bool runRow(CAM_IMAGE_PIX_FMT fmt, Content content, uint32_t repeat, size_t chunk)
+{
+    const char* name = (fmt == CAM_IMAGE_PIX_FMT_RGB565) ? "rgb565" : "y8";
+    printf("%s,%s,%lu,", name, contentNames[content], (unsigned long)chunk);
+    size_t length = fillFrame(fmt, content);
+    if (length == 0) {
+        printf("err\n");
+        return false;
+    }
+
+    Arducam_Qwiic_RleEncoder encoder;
+    size_t out = 0;
+    clock_t start = clock();
+    for (uint32_t r = 0; r < repeat; r++) {
+        encoder.begin(fmt);
+        out = 0;
+        for (size_t in = 0; in < length; in += chunk) {
+            size_t n = (length - in < chunk) ? length - in : chunk;
+            out += encoder.process(frame + in, n, packed + out);
+        }
+        out += encoder.finish(packed + out);
+    }
+    double encodeS = seconds(start);
+
+    Arducam_Qwiic_RleDecoder decoder;
+    size_t restored = 0;
+    start = clock();
+    for (uint32_t r = 0; r < repeat; r++) {
+        decoder.begin(fmt);
+        size_t consumed = 0;
+        restored = decoder.process(packed, out, unpacked, sizeof(unpacked), &consumed);
+    }
+    double decodeS = seconds(start);
+
+    bool ok = (restored == length && memcmp(frame, unpacked, length) == 0);
+    double mb = (double)length * repeat / 1e6;
+    printf("%s,%lu,%lu,%.3f,%.1f,%.1f\n", ok ? "ok" : "mismatch", (unsigned long)length, (unsigned long)out,
+           (double)length / out, encodeS > 0 ? mb / encodeS : 0.0, decodeS > 0 ? mb / decodeS : 0.0);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t repeat = 20;
+    size_t chunk = I2C_BUFFER_SIZE;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (!strcmp(argv[i], "--repeat") && hasValue) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--chunk") && hasValue) {
+            chunk = (size_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (repeat == 0 || chunk == 0) {
+        fprintf(stderr, "repeat and chunk must be at least 1\n");
+        return 2;
+    }
+
+    printf("format,content,chunk,status,bytes_in,bytes_out,ratio,encode_mb_s,decode_mb_s\n");
+    static const CAM_IMAGE_PIX_FMT formats[] = {CAM_IMAGE_PIX_FMT_Y8, CAM_IMAGE_PIX_FMT_RGB565};
+    bool ok = true;
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        for (int c = 0; c < CONTENT_COUNT; c++) {
+            ok = runRow(formats[f], (Content)c, repeat, chunk) && ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
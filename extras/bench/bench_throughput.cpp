@@ -0,0 +1,171 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Capture throughput per clock, mode and format, in simulated time
+//
+// Runs takePicture() and readImageBuf() against Arducam_Qwiic_SimBus with
+// bus timing, exposure and sensor readout modelled, and prints one CSV line
+// per clock, mode and format. The columns follow the BusBenchmark example,
+// with the bus time split by transaction kind.
+//
+// Usage: bench_throughput [--frames N] [--exposure-us N] [--pixel-rate N]
+//                         [--overhead-us N] [--read-length N] [clock_hz ...]
+
+#include "Arducam_Qwiic_SimBus.h"
+#include "Arducam_Qwiic_TimedBus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const CAM_IMAGE_MODE modes[] = {
+    CAM_IMAGE_MODE_96X96, CAM_IMAGE_MODE_128X128, CAM_IMAGE_MODE_QVGA, CAM_IMAGE_MODE_320X320,
+    CAM_IMAGE_MODE_VGA, CAM_IMAGE_MODE_HD, CAM_IMAGE_MODE_UXGA, CAM_IMAGE_MODE_FHD, CAM_IMAGE_MODE_WQXGA2,
+};
+static const CAM_IMAGE_PIX_FMT formats[] = {
+    CAM_IMAGE_PIX_FMT_JPG, CAM_IMAGE_PIX_FMT_RGB565, CAM_IMAGE_PIX_FMT_Y8,
+};
+
+typedef struct {
+    uint32_t frames;
+    uint32_t exposureUs;
+    uint32_t pixelRate;
+    uint16_t overheadUs;
+    size_t readLength;
+} BenchConfig;
+
+static CamStatus captureAndDrain(Arducam_Qwiic_CAM& cam, CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt,
+                                 uint8_t* buf, size_t length, uint64_t* bytes)
+{
+    CamStatus ret = cam.takePicture(mode, fmt);
+    if (ret != CAM_ERR_NONE) {
+        return ret;
+    }
+    while (cam.getUnreceivedLength() > 0) {
+        size_t n = cam.readImageBuf(buf, length);
+        if (n == 0) {
+            return CAM_ERR_NO_CALLBACK;
+        }
+        *bytes += n;
+    }
+    return CAM_ERR_NONE;
+}
+
+static void runPair(const BenchConfig& config, uint32_t hz, CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT fmt)
+{
+    Arducam_Qwiic_VirtualClock clock;
+    Arducam_Qwiic_HostClock::install(&clock);
+
+    Arducam_Qwiic_SimBus sim;
+    sim.setMaxReadLength(config.readLength);
+    sim.setExposureUs(config.exposureUs);
+    sim.setPixelRate(config.pixelRate);
+    sim.setBusTiming(true, config.overheadUs);
+    sim.setJpegLayout(0, 64, false);
+    Arducam_Qwiic_TimedBus timedBus(sim);
+    timedBus.setOverheadUs(config.overheadUs);
+    Arducam_Qwiic_CAM cam(timedBus);
+
+    static uint8_t buf[4096];
+    uint64_t bytes = 0;
+    CamStatus ret = cam.begin();
+    if (ret == CAM_ERR_NONE) {
+        timedBus.setClock(hz);
+        cam.setCapturePolicy(CAM_POLICY_NONE);
+        // Settle the sensor in the new mode and format first
+        ret = captureAndDrain(cam, mode, fmt, buf, sizeof(buf), &bytes);
+    }
+    bytes = 0;
+    timedBus.reset();
+    sim.resetCounters();
+
+    uint64_t captureUs = 0;
+    uint64_t drainUs = 0;
+    uint64_t startUs = clock.nowUs();
+    uint32_t frames = 0;
+    while (ret == CAM_ERR_NONE && frames < config.frames) {
+        ret = captureAndDrain(cam, mode, fmt, buf, sizeof(buf), &bytes);
+        if (ret == CAM_ERR_NONE) {
+            const CamFrameInfo& info = cam.getFrameInfo();
+            captureUs += info.doneUs - info.triggerUs;
+            drainUs += info.drainEndUs - info.drainStartUs;
+            frames++;
+        }
+    }
+    uint64_t elapsedUs = clock.nowUs() - startUs;
+    Arducam_Qwiic_HostClock::install(NULL);
+
+    printf("%lu,%d,%d,", (unsigned long)hz, mode, fmt);
+    if (ret != CAM_ERR_NONE || frames == 0 || elapsedUs == 0) {
+        printf("err%d\n", ret);
+        return;
+    }
+
+    const CamBusCounters& bus = timedBus.getCounters();
+    const CamSimCounters& sc = sim.getCounters();
+    printf("ok,%lu,%llu,%.2f,%.0f,%.1f,%llu,%llu,%llu,%lu,%lu,%lu,%lu,%lu\n",
+           (unsigned long)frames, (unsigned long long)bytes,
+           frames * 1000000.0 / elapsedUs, bytes * 1000000.0 / elapsedUs, bus.busyUs * 100.0 / elapsedUs,
+           (unsigned long long)(captureUs / frames), (unsigned long long)(drainUs / frames),
+           (unsigned long long)((elapsedUs - captureUs - drainUs) / frames),
+           (unsigned long)(bus.busyUs / frames), (unsigned long)(sc.commandUs / frames),
+           (unsigned long)(sc.pollUs / frames), (unsigned long)(sc.fifoUs / frames),
+           (unsigned long)((bus.writes + bus.reads) / frames));
+}
+
+int main(int argc, char** argv)
+{
+    BenchConfig config;
+    config.frames = 3;
+    config.exposureUs = 10000;
+    config.pixelRate = 12000000;
+    config.overheadUs = QWIIC_CAM_BUS_OVERHEAD_US;
+    config.readLength = I2C_BUFFER_SIZE;
+
+    uint32_t clocks[8];
+    uint8_t clockCount = 0;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (!strcmp(argv[i], "--frames") && hasValue) {
+            config.frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--exposure-us") && hasValue) {
+            config.exposureUs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--pixel-rate") && hasValue) {
+            config.pixelRate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--overhead-us") && hasValue) {
+            config.overheadUs = (uint16_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--read-length") && hasValue) {
+            config.readLength = (size_t)strtoul(argv[++i], NULL, 0);
+        } else if (argv[i][0] != '-' && clockCount < sizeof(clocks) / sizeof(clocks[0])) {
+            clocks[clockCount++] = (uint32_t)strtoul(argv[i], NULL, 0);
+        } else {
+            fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (clockCount == 0) {
+        clocks[clockCount++] = 100000;
+        clocks[clockCount++] = 400000;
+        clocks[clockCount++] = 1000000;
+    }
+
+    printf("# exposure_us=%lu pixel_rate=%lu overhead_us=%u read_length=%lu\n",
+           (unsigned long)config.exposureUs, (unsigned long)config.pixelRate, config.overheadUs,
+           (unsigned long)config.readLength);
+    printf("clock_hz,mode,format,status,frames,bytes,fps,bytes_s,bus_util_pct,"
+           "capture_us,drain_us,other_us,bus_us,command_us,poll_us,fifo_us,transactions\n");
+    for (uint8_t c = 0; c < clockCount; c++) {
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+            for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+                runPair(config, clocks[c], modes[m], formats[f]);
+            }
+        }
+    }
+    return 0;
+}
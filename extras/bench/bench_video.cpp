@@ -0,0 +1,175 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// takePicture() loop against video mode, in simulated time
+//
+// Streams JPEG frames at QVGA and VGA, once with a takePicture() per frame
+// and once with startVideo()/nextFrame(), and prints one CSV line per clock,
+// resolution, path and per-frame processing time. The processing time stands
+// for the caller shipping the frame after the drain; video mode exposes the
+// next frame meanwhile, a takePicture() loop only after it.
+//
+// Usage: bench_video [--frames N] [--exposure-us N] [--pixel-rate N]
+//                    [--overhead-us N] [--process-us N] [clock_hz ...]
+
+#include "Arducam_Qwiic_SimBus.h"
+#include "Arducam_Qwiic_TimedBus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    CAM_IMAGE_MODE imageMode;
+    CAM_VIDEO_MODE videoMode;
+    const char* name;
+} VideoSize;
+
+static const VideoSize sizes[] = {
+    {CAM_IMAGE_MODE_QVGA, CAM_VIDEO_MODE_0, "qvga"},
+    {CAM_IMAGE_MODE_VGA, CAM_VIDEO_MODE_1, "vga"},
+};
+
+typedef struct {
+    uint32_t frames;
+    uint32_t exposureUs;
+    uint32_t pixelRate;
+    uint16_t overheadUs;
+} BenchConfig;
+
+static CamStatus drain(Arducam_Qwiic_CAM& cam, uint8_t* buf, size_t length, uint64_t* bytes)
+{
+    while (cam.getUnreceivedLength() > 0) {
+        size_t n = cam.readImageBuf(buf, length);
+        if (n == 0) {
+            return CAM_ERR_NO_CALLBACK;
+        }
+        *bytes += n;
+    }
+    return CAM_ERR_NONE;
+}
+
+static void runPath(const BenchConfig& config, uint32_t hz, const VideoSize& size, bool video, uint32_t processUs)
+{
+    Arducam_Qwiic_VirtualClock clock;
+    Arducam_Qwiic_HostClock::install(&clock);
+
+    Arducam_Qwiic_SimBus sim;
+    sim.setExposureUs(config.exposureUs);
+    sim.setPixelRate(config.pixelRate);
+    sim.setBusTiming(true, config.overheadUs);
+    sim.setJpegLayout(0, 64, false);
+    Arducam_Qwiic_CAM cam(sim);
+
+    static uint8_t buf[I2C_BUFFER_SIZE];
+    uint64_t bytes = 0;
+    CamStatus ret = cam.begin(hz);
+    if (ret == CAM_ERR_NONE) {
+        cam.setCapturePolicy(CAM_POLICY_NONE);
+        // Settle the sensor in the format and size first
+        ret = cam.takePicture(size.imageMode, CAM_IMAGE_PIX_FMT_JPG);
+    }
+    if (ret == CAM_ERR_NONE) {
+        ret = drain(cam, buf, sizeof(buf), &bytes);
+    }
+    if (ret == CAM_ERR_NONE && video) {
+        ret = cam.startVideo(size.videoMode);
+    }
+    bytes = 0;
+    sim.resetCounters();
+
+    uint64_t waitUs = 0;
+    uint64_t drainUs = 0;
+    uint64_t startUs = clock.nowUs();
+    uint32_t frames = 0;
+    while (ret == CAM_ERR_NONE && frames < config.frames) {
+        uint64_t frameStartUs = clock.nowUs();
+        ret = video ? cam.nextFrame() : cam.takePicture(size.imageMode, CAM_IMAGE_PIX_FMT_JPG);
+        uint64_t readyUs = clock.nowUs();
+        if (ret == CAM_ERR_NONE) {
+            ret = drain(cam, buf, sizeof(buf), &bytes);
+        }
+        if (ret == CAM_ERR_NONE) {
+            waitUs += readyUs - frameStartUs;
+            drainUs += clock.nowUs() - readyUs;
+            // The caller ships the frame
+            delayMicroseconds(processUs);
+            frames++;
+        }
+    }
+    uint64_t elapsedUs = clock.nowUs() - startUs;
+    if (video) {
+        cam.stopVideo();
+    }
+    Arducam_Qwiic_HostClock::install(NULL);
+
+    printf("%lu,%s,%s,%lu,", (unsigned long)hz, size.name, video ? "video" : "picture", (unsigned long)processUs);
+    if (ret != CAM_ERR_NONE || frames == 0 || elapsedUs == 0) {
+        printf("err%d\n", ret);
+        return;
+    }
+
+    const CamSimCounters& sc = sim.getCounters();
+    printf("ok,%lu,%llu,%.2f,%llu,%llu,%llu,%lu,%lu,%lu\n",
+           (unsigned long)frames, (unsigned long long)bytes, frames * 1000000.0 / elapsedUs,
+           (unsigned long long)(elapsedUs / frames), (unsigned long long)(waitUs / frames),
+           (unsigned long long)(drainUs / frames), (unsigned long)(sc.busUs / frames),
+           (unsigned long)((sc.writes + sc.reads) / frames), (unsigned long)(sc.triggers / frames));
+}
+
+int main(int argc, char** argv)
+{
+    BenchConfig config;
+    config.frames = 5;
+    config.exposureUs = 30000;
+    config.pixelRate = 12000000;
+    config.overheadUs = QWIIC_CAM_BUS_OVERHEAD_US;
+    uint32_t processUs = 20000;
+
+    uint32_t clocks[8];
+    uint8_t clockCount = 0;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (!strcmp(argv[i], "--frames") && hasValue) {
+            config.frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--exposure-us") && hasValue) {
+            config.exposureUs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--pixel-rate") && hasValue) {
+            config.pixelRate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--overhead-us") && hasValue) {
+            config.overheadUs = (uint16_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--process-us") && hasValue) {
+            processUs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (argv[i][0] != '-' && clockCount < sizeof(clocks) / sizeof(clocks[0])) {
+            clocks[clockCount++] = (uint32_t)strtoul(argv[i], NULL, 0);
+        } else {
+            fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (clockCount == 0) {
+        clocks[clockCount++] = 400000;
+        clocks[clockCount++] = 1000000;
+    }
+
+    printf("# exposure_us=%lu pixel_rate=%lu overhead_us=%u\n",
+           (unsigned long)config.exposureUs, (unsigned long)config.pixelRate, config.overheadUs);
+    printf("clock_hz,size,path,process_us,status,frames,bytes,fps,frame_us,wait_us,drain_us,"
+           "bus_us,transactions,triggers\n");
+    for (uint8_t c = 0; c < clockCount; c++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            for (uint8_t p = 0; p < 2; p++) {
+                uint32_t process = p ? processUs : 0;
+                runPath(config, clocks[c], sizes[s], false, process);
+                runPath(config, clocks[c], sizes[s], true, process);
+            }
+        }
+    }
+    return 0;
+}
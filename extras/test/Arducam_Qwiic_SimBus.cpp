@@ -0,0 +1,481 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_SimBus.h"
+#include <string.h>
+
+// SOI and a JFIF APP0 segment
+static const uint8_t jpegHead[] = {
+    0xFF, 0xD8,
+    0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+};
+
+// EXIF APP1 segment holding a complete thumbnail, SOI to EOI
+static const uint8_t thumbnailSegment[] = {
+    0xFF, 0xE1, 0x00, 0x10, 'E', 'x', 'i', 'f', 0x00, 0x00,
+    0xFF, 0xD8, 0x10, 0x10, 0x10, 0x10, 0xFF, 0xD9,
+};
+
+// Start of scan, the entropy data follows
+static const uint8_t jpegScan[] = {
+    0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3F, 0x00,
+};
+
+Arducam_Qwiic_SimBus::Arducam_Qwiic_SimBus(uint8_t address)
+{
+    this->address = address;
+    clockHz = 0;
+    maxClockHz = 0;
+    maxRead = I2C_BUFFER_SIZE;
+    memset(regs, 0, sizeof(regs));
+    regs[CAM_REG_POWER_CONTROL] = CAM_POWER_NORMAL;
+    static const uint8_t defaultIds[CAM_SIM_ID_COUNT] = {0x81, 26, 6, 12};
+    memcpy(ids, defaultIds, sizeof(ids));
+    busyStartUs = 0;
+    busyUs = 0;
+    busy = false;
+    exposureStartUs = 0;
+    exposureUs = 0;
+    pixelRate = 0;
+    captureUs = 0;
+    exposing = false;
+    done = false;
+    frameFormat = CAM_IMAGE_PIX_FMT_NONE;
+    frameWidth = 0;
+    frameHeight = 0;
+    frameCount = 0;
+    frameSpan = 0;
+    jpegLength = 0;
+    frameSeq = 0;
+    fifoLength = 0;
+    readPos = 0;
+    jpegJunk = 0;
+    jpegPadding = 0;
+    jpegThumbnail = false;
+    failPending = 0;
+    timing = false;
+    overheadUs = 0;
+    resetCounters();
+}
+
+bool Arducam_Qwiic_SimBus::begin(void)
+{
+    return true;
+}
+
+void Arducam_Qwiic_SimBus::setClock(uint32_t hz)
+{
+    clockHz = hz;
+}
+
+bool Arducam_Qwiic_SimBus::failTransfer(uint8_t addr)
+{
+    if (addr != address) {
+        return true; // Nobody acknowledges the address
+    }
+    if (failPending > 0) {
+        failPending--;
+        counters.failures++;
+        return true;
+    }
+    if (maxClockHz != 0 && clockHz > maxClockHz) {
+        counters.failures++;
+        return true;
+    }
+    return false;
+}
+
+void Arducam_Qwiic_SimBus::spend(uint32_t bytes, uint32_t* category)
+{
+    if (!timing || clockHz == 0) {
+        return;
+    }
+    uint32_t us = (uint32_t)(((uint64_t)bytes * 9 * 1000000ULL + clockHz - 1) / clockHz) + overheadUs;
+    counters.busUs += us;
+    if (category != NULL) {
+        *category += us;
+    }
+    // delayMicroseconds() is only accurate for short delays on some cores
+    while (us > 0) {
+        unsigned int step = (us > 10000) ? 10000 : (unsigned int)us;
+        delayMicroseconds(step);
+        us -= step;
+    }
+}
+
+bool Arducam_Qwiic_SimBus::write(uint8_t addr, const uint8_t* data, size_t length)
+{
+    if (failTransfer(addr)) {
+        return false;
+    }
+    counters.writes++;
+    spend(1 + (uint32_t)length, &counters.commandUs);
+    if (length >= 2) {
+        writeReg(data[0], data[1]);
+    }
+    return true;
+}
+
+size_t Arducam_Qwiic_SimBus::writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length)
+{
+    if (failTransfer(addr)) {
+        return 0;
+    }
+    counters.reads++;
+    if (length > maxRead) {
+        length = maxRead;
+    }
+
+    if (reg == BURST_FIFO_READ || reg == SINGLE_FIFO_READ) {
+        counters.fifoReads++;
+        if (reg == SINGLE_FIFO_READ && length > 1) {
+            length = 1;
+        }
+        // Address, register, address again after the repeated start
+        spend(3 + (uint32_t)length, &counters.fifoUs);
+        if (readPos >= fifoLength) {
+            counters.violations++;
+            return 0;
+        }
+        if (length > fifoLength - readPos) {
+            counters.violations++;
+            length = fifoLength - readPos;
+        }
+        for (size_t i = 0; i < length; i++) {
+            buf[i] = fifoByte(readPos++);
+        }
+        counters.fifoBytes += length;
+        return length;
+    }
+
+    spend(3 + (uint32_t)length, (reg == ARDUCHIP_TRIG) ? &counters.pollUs : NULL);
+    if (length > 0) {
+        uint8_t value = readReg(reg);
+        memset(buf, value, length);
+    }
+    return length;
+}
+
+size_t Arducam_Qwiic_SimBus::maxReadLength(void) const
+{
+    return maxRead;
+}
+
+void Arducam_Qwiic_SimBus::writeReg(uint8_t reg, uint8_t value)
+{
+    if (reg != ARDUCHIP_TEST1) {
+        // The driver waits for idle after every command it sends
+        if (busy && micros() - busyStartUs < busyUs) {
+            counters.violations++;
+        }
+        busy = (busyUs > 0);
+        busyStartUs = micros();
+    }
+
+    if (reg == ARDUCHIP_FIFO) {
+        if (value & FIFO_CLEAR_ID_MASK) {
+            done = false;
+        }
+        if (value & FIFO_START_MASK) {
+            startCapture();
+        }
+        if (value & FIFO_RDPTR_RST_MASK) {
+            readPos = 0;
+        }
+        if (value & FIFO_WRPTR_RST_MASK) {
+            fifoLength = 0;
+        }
+        if (value & FIFO_CLEAR_MASK) {
+            exposing = false;
+            done = false;
+            fifoLength = 0;
+            readPos = 0;
+        }
+        return;
+    }
+
+    if (reg == CAM_REG_SENSOR_RESET && (value & CAM_SENSOR_RESET_ENABLE)) {
+        // The sensor drops back to its defaults, the control registers
+        // start at CAM_REG_FORMAT
+        memset(regs + CAM_REG_FORMAT, 0, CAM_SIM_REG_COUNT - CAM_REG_FORMAT);
+        regs[ARDUCHIP_FRAMES] = 0;
+        regs[CAM_REG_POWER_CONTROL] = CAM_POWER_NORMAL;
+        exposing = false;
+        done = false;
+        fifoLength = 0;
+        readPos = 0;
+        return;
+    }
+
+    if (reg < CAM_SIM_REG_COUNT) {
+        regs[reg] = value;
+    }
+}
+
+uint8_t Arducam_Qwiic_SimBus::readReg(uint8_t reg)
+{
+    switch (reg) {
+    case ARDUCHIP_TRIG: // Also CAM_REG_SENSOR_STATE
+        counters.statusReads++;
+        updateCapture();
+        return ((busy && micros() - busyStartUs < busyUs) ? 0 : CAM_REG_SENSOR_STATE_IDLE) |
+               (done ? CAP_DONE_MASK : 0);
+    case FIFO_SIZE1:
+        counters.sizeReads++;
+        return (uint8_t)fifoLength;
+    case FIFO_SIZE2:
+        counters.sizeReads++;
+        return (uint8_t)(fifoLength >> 8);
+    case FIFO_SIZE3:
+        counters.sizeReads++;
+        return (uint8_t)(fifoLength >> 16);
+    default:
+        break;
+    }
+    if (reg >= CAM_REG_SENSOR_ID && reg <= CAM_REG_DAY_ID) {
+        return ids[reg - CAM_REG_SENSOR_ID];
+    }
+    return (reg < CAM_SIM_REG_COUNT) ? regs[reg] : 0;
+}
+
+bool Arducam_Qwiic_SimBus::modeSize(uint8_t mode, uint16_t* width, uint16_t* height)
+{
+    // The module's own table, independent of the driver's
+    static const uint16_t sizes[][2] = {
+        {160, 120},   // 0, only used to reload the sensor pipeline
+        {320, 240},   // CAM_IMAGE_MODE_QVGA
+        {640, 480},   // CAM_IMAGE_MODE_VGA
+        {1280, 720},  // CAM_IMAGE_MODE_HD
+        {1600, 1200}, // CAM_IMAGE_MODE_UXGA
+        {1920, 1080}, // CAM_IMAGE_MODE_FHD
+        {2592, 1944}, // CAM_IMAGE_MODE_WQXGA2
+        {96, 96},     // CAM_IMAGE_MODE_96X96
+        {128, 128},   // CAM_IMAGE_MODE_128X128
+        {320, 320},   // CAM_IMAGE_MODE_320X320
+    };
+    if (mode >= sizeof(sizes) / sizeof(sizes[0])) {
+        return false;
+    }
+    *width = sizes[mode][0];
+    *height = sizes[mode][1];
+    return true;
+}
+
+void Arducam_Qwiic_SimBus::startCapture(void)
+{
+    uint8_t format = regs[CAM_REG_FORMAT];
+    uint16_t width = 0;
+    uint16_t height = 0;
+
+    // Video modes use the numbers of the image modes of the same size
+    if (!modeSize(regs[CAM_REG_CAPTURE_RESOLUTION] & ~CAM_SET_VIDEO_MODE, &width, &height) ||
+        format < CAM_IMAGE_PIX_FMT_JPG || format > CAM_IMAGE_PIX_FMT_Y8 ||
+        regs[CAM_REG_POWER_CONTROL] == CAM_POWER_STANDBY) {
+        counters.violations++;
+        return;
+    }
+
+    counters.triggers++;
+    frameSeq++;
+    frameFormat = format;
+    frameWidth = width;
+    frameHeight = height;
+    frameCount = regs[ARDUCHIP_FRAMES] + 1;
+    captureUs = exposureUs;
+    if (pixelRate > 0) {
+        captureUs += (uint32_t)((uint64_t)width * height * 1000000ULL / pixelRate);
+    }
+    captureUs *= frameCount;
+    if (format == CAM_IMAGE_PIX_FMT_JPG) {
+        // Compressed size follows the quality setting and varies between captures
+        static const uint8_t ratio[] = {5, 8, 12};
+        uint8_t quality = regs[CAM_REG_IMAGE_QUALITY];
+        uint32_t entropy = (uint32_t)width * height / ratio[(quality <= LOW_QUALITY) ? quality : (uint8_t)DEFAULT_QUALITY];
+        jpegLength = jpegHeaderLength() + entropy + (frameSeq * 13) % 64 + 2;
+        frameSpan = (uint32_t)jpegJunk + jpegLength + jpegPadding;
+    } else {
+        frameSpan = (uint32_t)width * height * ((format == CAM_IMAGE_PIX_FMT_RGB565) ? 2 : 1);
+    }
+    fifoLength = 0;
+    readPos = 0;
+    done = false;
+    exposing = true;
+    exposureStartUs = micros();
+    updateCapture();
+}
+
+void Arducam_Qwiic_SimBus::updateCapture(void)
+{
+    if (exposing && micros() - exposureStartUs >= captureUs) {
+        exposing = false;
+        done = true;
+        fifoLength = (uint32_t)frameCount * frameSpan;
+    }
+}
+
+uint32_t Arducam_Qwiic_SimBus::jpegHeaderLength(void) const
+{
+    return sizeof(jpegHead) + (jpegThumbnail ? sizeof(thumbnailSegment) : 0) + sizeof(jpegScan);
+}
+
+uint8_t Arducam_Qwiic_SimBus::entropyByte(uint32_t index, uint32_t length) const
+{
+    // Stuffed 0xFF 0x00 pairs
+    uint32_t stuff = index % 97;
+    if (stuff == 95 && index + 1 < length) {
+        return 0xFF;
+    }
+    if (stuff == 96) {
+        return 0x00;
+    }
+    // Restart markers
+    uint32_t restart = index % 211;
+    if (restart == 150 && index + 1 < length) {
+        return 0xFF;
+    }
+    if (restart == 151) {
+        return (uint8_t)(0xD0 + ((index / 211) & 7));
+    }
+    uint8_t value = (uint8_t)(((index + frameSeq * 7919UL) * 2654435761UL) >> 24);
+    return (value == 0xFF) ? 0x7F : value;
+}
+
+uint8_t Arducam_Qwiic_SimBus::fifoByte(uint32_t offset) const
+{
+    if (offset >= (uint32_t)frameCount * frameSpan) {
+        return 0;
+    }
+    uint32_t frame = offset / frameSpan;
+    uint32_t pos = offset % frameSpan;
+
+    if (frameFormat != CAM_IMAGE_PIX_FMT_JPG) {
+        // Block pattern, 16x16 pixel tiles that shift with every frame
+        uint32_t pixel = (frameFormat == CAM_IMAGE_PIX_FMT_RGB565) ? pos / 2 : pos;
+        uint16_t x = (uint16_t)(pixel % frameWidth);
+        uint16_t y = (uint16_t)(pixel / frameWidth);
+        uint8_t luma = (uint8_t)((x >> 4) * 7 + (y >> 4) * 13 + (frameSeq + frame) * 3);
+        if (frameFormat == CAM_IMAGE_PIX_FMT_Y8) {
+            return luma;
+        }
+        uint16_t rgb = (uint16_t)(((luma >> 3) << 11) | ((luma >> 2) << 5) | (luma >> 3));
+        return (pos & 1) ? (uint8_t)rgb : (uint8_t)(rgb >> 8);
+    }
+
+    if (pos < jpegJunk) {
+        return (pos & 1) ? 0xFF : 0x12;
+    }
+    pos -= jpegJunk;
+    if (pos < sizeof(jpegHead)) {
+        return jpegHead[pos];
+    }
+    pos -= sizeof(jpegHead);
+    if (jpegThumbnail) {
+        if (pos < sizeof(thumbnailSegment)) {
+            return thumbnailSegment[pos];
+        }
+        pos -= sizeof(thumbnailSegment);
+    }
+    if (pos < sizeof(jpegScan)) {
+        return jpegScan[pos];
+    }
+    pos -= sizeof(jpegScan);
+
+    uint32_t entropy = jpegLength - jpegHeaderLength() - 2;
+    if (pos < entropy) {
+        return entropyByte(pos, entropy);
+    }
+    pos -= entropy;
+    if (pos < 2) {
+        return (pos == 0) ? 0xFF : 0xD9;
+    }
+    return 0x00; // Padding up to the next frame
+}
+
+uint32_t Arducam_Qwiic_SimBus::getJpegImage(uint8_t frame, uint32_t* start) const
+{
+    if (frameFormat != CAM_IMAGE_PIX_FMT_JPG || frame >= frameCount) {
+        return 0;
+    }
+    *start = (uint32_t)frame * frameSpan + jpegJunk;
+    return jpegLength;
+}
+
+uint32_t Arducam_Qwiic_SimBus::getFifoLength(void) const
+{
+    return fifoLength;
+}
+
+uint8_t Arducam_Qwiic_SimBus::peekReg(uint8_t reg) const
+{
+    return (reg < CAM_SIM_REG_COUNT) ? regs[reg] : 0;
+}
+
+void Arducam_Qwiic_SimBus::setMaxReadLength(size_t length)
+{
+    maxRead = (length == 0) ? 1 : length;
+}
+
+void Arducam_Qwiic_SimBus::setBusyUs(uint32_t us)
+{
+    busyUs = us;
+}
+
+void Arducam_Qwiic_SimBus::setExposureUs(uint32_t us)
+{
+    exposureUs = us;
+}
+
+void Arducam_Qwiic_SimBus::setPixelRate(uint32_t pixelsPerSecond)
+{
+    pixelRate = pixelsPerSecond;
+}
+
+void Arducam_Qwiic_SimBus::setBusTiming(bool enable, uint16_t overheadUs)
+{
+    timing = enable;
+    this->overheadUs = overheadUs;
+}
+
+void Arducam_Qwiic_SimBus::setJpegLayout(uint8_t junk, uint16_t padding, bool thumbnail)
+{
+    jpegJunk = junk;
+    jpegPadding = padding;
+    jpegThumbnail = thumbnail;
+}
+
+void Arducam_Qwiic_SimBus::setIds(const uint8_t* id)
+{
+    memcpy(ids, id, sizeof(ids));
+}
+
+void Arducam_Qwiic_SimBus::failTransfers(uint16_t count)
+{
+    failPending = count;
+}
+
+void Arducam_Qwiic_SimBus::setMaxClock(uint32_t hz)
+{
+    maxClockHz = hz;
+}
+
+uint32_t Arducam_Qwiic_SimBus::getClock(void) const
+{
+    return clockHz;
+}
+
+const CamSimCounters& Arducam_Qwiic_SimBus::getCounters() const
+{
+    return counters;
+}
+
+void Arducam_Qwiic_SimBus::resetCounters(void)
+{
+    memset(&counters, 0, sizeof(counters));
+}
@@ -0,0 +1,320 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_SIMBUS_H
+#define __ARDUCAM_QWIIC_SIMBUS_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+/**
+* @file Arducam_Qwiic_SimBus.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*
+* Test scaffolding of the host build, not part of the Arduino library.
+*/
+
+#define CAM_SIM_REG_COUNT 0x40 // ARDUCHIP_TEST1 .. CAM_REG_SINGLE_FIFO_READ_OPERATION
+#define CAM_SIM_ID_COUNT  4    // CAM_REG_SENSOR_ID .. CAM_REG_DAY_ID
+
+/**
+ * @struct CamSimCounters
+ * @brief Transactions seen by Arducam_Qwiic_SimBus
+ */
+typedef struct {
+    uint32_t writes;           /**< Write transactions */
+    uint32_t reads;            /**< Write-read transactions, FIFO reads included */
+    uint32_t statusReads;      /**< Reads of ARDUCHIP_TRIG / CAM_REG_SENSOR_STATE */
+    uint32_t sizeReads;        /**< Reads of FIFO_SIZE1..3 */
+    uint32_t fifoReads;        /**< BURST_FIFO_READ and SINGLE_FIFO_READ transactions */
+    uint32_t fifoBytes;        /**< Bytes read out of the FIFO */
+    uint32_t triggers;         /**< Captures started with FIFO_START_MASK */
+    uint32_t failures;         /**< Transactions failed on purpose, see failTransfers() */
+    uint32_t violations;       /**< Writes while busy, reads of an empty FIFO or past its end */
+    uint32_t busUs;            /**< Modelled time of all transactions, see setBusTiming() */
+    uint32_t commandUs;        /**< Part of busUs spent on writes */
+    uint32_t pollUs;           /**< Part of busUs spent on status reads */
+    uint32_t fifoUs;           /**< Part of busUs spent on FIFO reads */
+} CamSimCounters;
+
+/**
+* @brief Bus backend that simulates the camera module
+*
+* Runs the driver without hardware. The simulated module answers the
+* ArduChip FIFO control (ARDUCHIP_FIFO), capture completion (ARDUCHIP_TRIG
+* CAP_DONE), FIFO length (FIFO_SIZE1..3), FIFO reads (BURST_FIFO_READ,
+* SINGLE_FIFO_READ) and the idle state (CAM_REG_SENSOR_STATE).
+*
+* Frames are generated from their FIFO offset, so no frame buffer is kept:
+* Y8 and RGB565 frames are a block pattern, JPEG frames a well formed
+* marker sequence with stuffed and restart bytes in the entropy data. The
+* pattern changes with every capture.
+*
+* With setBusTiming() every transaction takes the time it would take on
+* the wire, 9 clocks per byte plus a fixed overhead, and a capture takes
+* its exposure plus the sensor readout. Time passes through
+* delayMicroseconds(), so an installed Arducam_Qwiic_VirtualClock gives
+* the time a capture would take on real hardware.
+*/
+class Arducam_Qwiic_SimBus : public Arducam_Qwiic_Bus
+{
+private:
+	uint8_t address;                                /**< Address the module answers */
+	uint32_t clockHz;                               /**< Clock last set with setClock() */
+	uint32_t maxClockHz;                            /**< Fastest clock the link survives, 0 for any */
+	size_t maxRead;                                 /**< Longest read, like the Wire buffer */
+	uint8_t regs[CAM_SIM_REG_COUNT];                /**< Register file */
+	uint8_t ids[CAM_SIM_ID_COUNT];                  /**< Sensor ID and firmware date */
+	unsigned long busyStartUs;                      /**< Time of the last write */
+	uint32_t busyUs;                                /**< Time the module stays busy after a write */
+	bool busy;                                      /**< Module was busy at the last write */
+	unsigned long exposureStartUs;                  /**< Time the capture was started */
+	uint32_t exposureUs;                            /**< Sensor exposure time */
+	uint32_t pixelRate;                             /**< Sensor readout in pixels per second, 0 for instant */
+	uint32_t captureUs;                             /**< Trigger to CAP_DONE time of the current capture */
+	bool exposing;                                  /**< Capture started, not done yet */
+	bool done;                                      /**< CAP_DONE is set */
+	uint8_t frameFormat;                            /**< CAM_IMAGE_PIX_FMT of the FIFO content */
+	uint16_t frameWidth;                            /**< Width of the FIFO frames */
+	uint16_t frameHeight;                           /**< Height of the FIFO frames */
+	uint8_t frameCount;                             /**< Frames in the FIFO */
+	uint32_t frameSpan;                             /**< FIFO bytes per frame */
+	uint32_t jpegLength;                            /**< SOI to EOI length of the JPEG frames */
+	uint32_t frameSeq;                              /**< Captures since power-up, seeds the pattern */
+	uint32_t fifoLength;                            /**< Bytes in the FIFO */
+	uint32_t readPos;                               /**< FIFO read pointer */
+	uint8_t jpegJunk;                               /**< Bytes in front of each JPEG SOI */
+	uint16_t jpegPadding;                           /**< Bytes after each JPEG EOI */
+	bool jpegThumbnail;                             /**< JPEG frames carry an EXIF thumbnail */
+	uint16_t failPending;                           /**< Transactions still to fail */
+	bool timing;                                    /**< Transactions take their modelled time */
+	uint16_t overheadUs;                            /**< Modelled cost per transaction beyond its bits */
+	CamSimCounters counters;                        /**< Traffic since resetCounters() */
+
+	/**
+	* @brief Run a register write
+	*
+	* @param  reg Register address
+	* @param  value Value written
+	*/
+	void writeReg(uint8_t reg, uint8_t value);
+
+	/**
+	* @brief Run a register read
+	*
+	* @param  reg Register address
+	*
+	* @return Returns the register value
+	*/
+	uint8_t readReg(uint8_t reg);
+
+	/**
+	* @brief Latch the capture requested by the format, resolution and
+	* ARDUCHIP_FRAMES registers
+	*/
+	void startCapture(void);
+
+	/**
+	* @brief Set CAP_DONE and the FIFO length once the capture time is over
+	*/
+	void updateCapture(void);
+
+	/**
+	* @brief Get the size of a capture resolution
+	*
+	* @param  mode Value of CAM_REG_CAPTURE_RESOLUTION without the video bit
+	* @param  width Set to the width in pixels
+	* @param  height Set to the height in pixels
+	*
+	* @return Returns false if the module has no such resolution
+	*/
+	static bool modeSize(uint8_t mode, uint16_t* width, uint16_t* height);
+
+	/**
+	* @brief Get the JPEG header length, SOI to the end of SOS
+	*
+	* @return Return the length in bytes
+	*/
+	uint32_t jpegHeaderLength(void) const;
+
+	/**
+	* @brief Get a byte of the JPEG entropy data
+	*
+	* @param  index Offset in the entropy data
+	* @param  length Length of the entropy data
+	*
+	* @return Returns the byte
+	*/
+	uint8_t entropyByte(uint32_t index, uint32_t length) const;
+
+	/**
+	* @brief Check whether a transaction is to fail
+	*
+	* @param  addr Address the transaction is sent to
+	*
+	* @return Returns true if nobody answers the address, a failure is
+	* pending (see failTransfers()) or the clock is too fast (see
+	* setMaxClock())
+	*/
+	bool failTransfer(uint8_t addr);
+
+	/**
+	* @brief Let the modelled duration of a transaction pass
+	*
+	* @param  bytes Bytes on the wire, address bytes included
+	* @param  category Counter the time is added to, besides busUs
+	*/
+	void spend(uint32_t bytes, uint32_t* category);
+
+public:
+	/**
+	* @brief Constructor of the simulated module
+	*
+	* @param  address Address the module answers
+	*/
+	explicit Arducam_Qwiic_SimBus(uint8_t address = QWIIC_CAM_I2C_ADDRESS);
+
+	bool begin(void);
+	void setClock(uint32_t hz);
+	bool write(uint8_t addr, const uint8_t* data, size_t length);
+	size_t writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length);
+	size_t maxReadLength(void) const;
+
+	/**
+	* @brief Set the longest read
+	*
+	* @param  length Length in bytes, I2C_BUFFER_SIZE by default
+	*/
+	void setMaxReadLength(size_t length);
+
+	/**
+	* @brief Set the time the module stays busy after a write
+	*
+	* @param  us Time in microseconds, 0 by default
+	*/
+	void setBusyUs(uint32_t us);
+
+	/**
+	* @brief Set the sensor exposure, the first part of the time from
+	* FIFO_START_MASK to CAP_DONE
+	*
+	* @param  us Time in microseconds, 0 by default
+	*/
+	void setExposureUs(uint32_t us);
+
+	/**
+	* @brief Set the sensor readout rate, the frame is in the FIFO after
+	* exposure and readout
+	*
+	* @param  pixelsPerSecond Readout rate, 0 (default) for no readout time
+	*/
+	void setPixelRate(uint32_t pixelsPerSecond);
+
+	/**
+	* @brief Make every transaction take its modelled time
+	*
+	* @param  enable Spend the time, off by default
+	* @param  overheadUs Start/stop gap and driver time per transaction
+	*
+	* @note A byte costs 9 clocks of the clock set with setClock(), like
+	* Arducam_Qwiic_TimedBus::modelUs()
+	*/
+	void setBusTiming(bool enable, uint16_t overheadUs);
+
+	/**
+	* @brief Shape the JPEG frames of the next captures
+	*
+	* @param  junk Bytes in front of each SOI
+	* @param  padding Bytes after each EOI
+	* @param  thumbnail Add an APP1 segment holding a complete thumbnail JPEG
+	*/
+	void setJpegLayout(uint8_t junk, uint16_t padding, bool thumbnail);
+
+	/**
+	* @brief Set the sensor ID and firmware date registers
+	*
+	* @param  id CAM_REG_SENSOR_ID .. CAM_REG_DAY_ID values
+	*/
+	void setIds(const uint8_t* id);
+
+	/**
+	* @brief Fail the next transactions, writes are not acknowledged and
+	* reads return nothing
+	*
+	* @param  count Number of transactions
+	*/
+	void failTransfers(uint16_t count);
+
+	/**
+	* @brief Fail every transaction while the clock is above a limit, like
+	* a bus with too much capacitance
+	*
+	* @param  hz Fastest working clock, 0 (default) for no limit
+	*/
+	void setMaxClock(uint32_t hz);
+
+	/**
+	* @brief Get the clock last set with setClock()
+	*
+	* @return Return the clock in Hz, 0 before the first setClock()
+	*/
+	uint32_t getClock(void) const;
+
+	/**
+	* @brief Get a register value as the module holds it
+	*
+	* @param  reg Register address
+	*
+	* @return Return the value
+	*/
+	uint8_t peekReg(uint8_t reg) const;
+
+	/**
+	* @brief Get a byte of the last capture as it was stored in the FIFO,
+	* also after the FIFO has been cleared
+	*
+	* @param  offset Offset from the start of the FIFO
+	*
+	* @return Return the byte, 0 past the end
+	*/
+	uint8_t fifoByte(uint32_t offset) const;
+
+	/**
+	* @brief Get the FIFO length of the last completed capture
+	*
+	* @return Return the length in bytes, 0 if the FIFO is empty
+	*/
+	uint32_t getFifoLength(void) const;
+
+	/**
+	* @brief Get where a JPEG image, SOI to EOI, sits in the FIFO
+	*
+	* @param  frame Frame index of a burst capture, 0 otherwise
+	* @param  start Set to the offset of the SOI
+	*
+	* @return Return the image length, 0 if there is no such JPEG frame
+	*/
+	uint32_t getJpegImage(uint8_t frame, uint32_t* start) const;
+
+	/**
+	* @brief Get the traffic since resetCounters()
+	*
+	* @return Return the counters
+	*/
+	const CamSimCounters& getCounters() const;
+
+	/**
+	* @brief Clear the counters
+	*/
+	void resetCounters(void);
+};
+
+#endif /*__ARDUCAM_QWIIC_SIMBUS_H*/
@@ -0,0 +1,141 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Broadcast frames of the simulated module to viewers on local TCP
+// connections through Arducam_Qwiic_SocketSink
+
+#include "Arducam_Qwiic_Broadcaster.h"
+#include "Arducam_Qwiic_SimBus.h"
+#include "test_common.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const char partHeader[] = "\r\n--frame\r\nContent-Type: image/jpeg\r\n\r\n";
+
+// Connect a viewer to the listening socket, returns the server side
+static int connectViewer(int listener, int* viewer, int rcvbuf)
+{
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    getsockname(listener, (struct sockaddr*)&addr, &len);
+
+    *viewer = socket(AF_INET, SOCK_STREAM, 0);
+    if (rcvbuf > 0) {
+        setsockopt(*viewer, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    if (connect(*viewer, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        return -1;
+    }
+    int fd = accept(listener, NULL, NULL);
+    if (fd >= 0 && rcvbuf > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    return fd;
+}
+
+// Read what the viewer has been sent so far
+static size_t receive(int viewer, uint8_t* buf, size_t length)
+{
+    size_t total = 0;
+    while (total < length) {
+        ssize_t n = recv(viewer, buf + total, length - total, MSG_DONTWAIT);
+        if (n <= 0) {
+            break;
+        }
+        total += (size_t)n;
+    }
+    return total;
+}
+
+static void testBroadcast(void)
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    CHECK(bind(listener, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    CHECK(listen(listener, 4) == 0);
+
+    // The fast viewer reads every frame, the slow one never reads and has
+    // small socket buffers
+    int fastViewer = -1;
+    int slowViewer = -1;
+    int fastFd = connectViewer(listener, &fastViewer, 0);
+    int slowFd = connectViewer(listener, &slowViewer, 4096);
+    CHECK(fastFd >= 0);
+    CHECK(slowFd >= 0);
+    Arducam_Qwiic_SocketSink fastSink(fastFd);
+    Arducam_Qwiic_SocketSink slowSink(slowFd);
+
+    Arducam_Qwiic_Broadcaster broadcaster;
+    int8_t fast = broadcaster.add(fastSink, false);
+    int8_t slow = broadcaster.add(slowSink, false);
+    CHECK_EQ(fast, 0);
+    CHECK_EQ(slow, 1);
+
+    Arducam_Qwiic_SimBus sim;
+    sim.setJpegLayout(4, 40, true);
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setJpegTrim(true);
+
+    const uint8_t frames = 20;
+    uint32_t mismatches = 0;
+    static uint8_t buf[64 * 1024];
+    for (uint8_t f = 0; f < frames; f++) {
+        CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_JPG), CAM_ERR_NONE);
+        uint32_t start = 0;
+        uint32_t image = sim.getJpegImage(0, &start);
+        CHECK_EQ(broadcaster.broadcast(cam), CAM_ERR_NONE);
+        CHECK_EQ(cam.getUnreceivedLength(), 0);
+
+        // The part is the header and the image, nothing more
+        size_t expected = sizeof(partHeader) - 1 + image;
+        CHECK(expected <= sizeof(buf));
+        size_t n = receive(fastViewer, buf, expected + 1);
+        CHECK_EQ(n, expected);
+        CHECK(memcmp(buf, partHeader, sizeof(partHeader) - 1) == 0);
+        for (uint32_t i = 0; i < image && sizeof(partHeader) - 1 + i < n; i++) {
+            mismatches += (buf[sizeof(partHeader) - 1 + i] != sim.fifoByte(start + i));
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(broadcaster.getFramesRead(), frames);
+    CHECK_EQ(broadcaster.getClientStats(fast).framesSent, frames);
+    CHECK_EQ(broadcaster.getClientStats(fast).framesDropped, 0);
+
+    // The slow viewer fell behind without holding up the fast one
+    CHECK(broadcaster.getClientStats(slow).framesDropped > 0);
+    CHECK(broadcaster.getClientStats(slow).framesSent < frames);
+
+    // A viewer that hung up is removed and its socket closed
+    close(slowViewer);
+    CHECK_EQ(broadcaster.prune(), 1);
+    CHECK(!broadcaster.contains(&slowSink));
+    CHECK(!slowSink.connected());
+    CHECK(fastSink.connected());
+
+    broadcaster.remove(fast);
+    CHECK_EQ(broadcaster.getClientCount(), 0);
+    close(fastViewer);
+    close(listener);
+}
+
+int main(void)
+{
+    testBroadcast();
+    return testResult("test_broadcaster");
+}
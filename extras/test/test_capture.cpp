@@ -0,0 +1,668 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Capture and drain frames through the driver against the simulated module
+
+#include "Arducam_Qwiic_CameraGroup.h"
+#include "Arducam_Qwiic_Motion.h"
+#include "Arducam_Qwiic_SimBus.h"
+#include "test_common.h"
+
+// Read the frame out with readImageBuf() and compare it with the FIFO content
+static uint32_t drain(Arducam_Qwiic_CAM& cam, Arducam_Qwiic_SimBus& sim, uint32_t offset, size_t chunk)
+{
+    uint8_t buf[1024];
+    uint32_t start = offset;
+    uint32_t mismatches = 0;
+    size_t n;
+    while ((n = cam.readImageBuf(buf, chunk)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            mismatches += (buf[i] != sim.fifoByte(offset + i));
+        }
+        offset += n;
+    }
+    CHECK_EQ(mismatches, 0);
+    return offset - start;
+}
+
+static void testRawCapture(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK_EQ(cam.getTotalLength(), 320 * 240);
+    CHECK_EQ(sim.getCounters().triggers, 1);
+    CHECK_EQ(drain(cam, sim, 0, 4 * 255), 320 * 240);
+    CHECK_EQ(sim.getCounters().fifoReads, (320 * 240 + 254) / 255);
+    CHECK_EQ(cam.getCaptureState(), CAM_CAPTURE_IDLE);
+    CHECK_EQ(cam.getUnreceivedLength(), 0);
+
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_VGA, CAM_IMAGE_PIX_FMT_RGB565), CAM_ERR_NONE);
+    CHECK_EQ(cam.getTotalLength(), 640 * 480 * 2);
+    CHECK_EQ(sim.peekReg(CAM_REG_FORMAT), CAM_IMAGE_PIX_FMT_RGB565);
+    CHECK_EQ(drain(cam, sim, 0, 100), 640 * 480 * 2);
+    CHECK_EQ(sim.getCounters().triggers, 2);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testJpegCapture(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+    sim.setJpegLayout(0, 40, false);
+
+    // Untrimmed, the FIFO padding is handed out too
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_JPG), CAM_ERR_NONE);
+    CHECK_EQ(cam.getTotalLength(), sim.getFifoLength());
+    CHECK_EQ(drain(cam, sim, 0, 255), cam.getTotalLength());
+
+    // Trimmed, reading stops at EOI
+    cam.setJpegTrim(true);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_JPG), CAM_ERR_NONE);
+    uint32_t start = 0;
+    uint32_t image = sim.getJpegImage(0, &start);
+    CHECK(image > 0);
+    CHECK_EQ(drain(cam, sim, start, 255), image);
+    CHECK(cam.isImageComplete());
+    CHECK_EQ(cam.getImageLength(), image);
+
+    // Junk in front of the SOI is dropped and the EOI of the thumbnail does
+    // not end the image, whatever the chunk boundaries
+    sim.setJpegLayout(8, 40, true);
+    static const size_t chunks[] = {1, 2, 3, 5, 255};
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_JPG), CAM_ERR_NONE);
+        image = sim.getJpegImage(0, &start);
+        CHECK_EQ(start, 8);
+        CHECK_EQ(drain(cam, sim, start, chunks[c]), image);
+        CHECK(cam.isImageComplete());
+        CHECK_EQ(cam.getImageLength(), image);
+    }
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testJpegBurstCapture(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+    sim.setJpegLayout(7, 40, true);
+
+    CHECK_EQ(cam.takeBurst(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_JPG, 3), CAM_ERR_NONE);
+    uint8_t frames = 0;
+    uint32_t mismatches = 0;
+    while (cam.nextBurstFrame()) {
+        uint32_t start = 0;
+        uint32_t image = sim.getJpegImage(frames, &start);
+        uint8_t buf[77];
+        uint32_t pos = 0;
+        size_t n;
+        while ((n = cam.readBurstFrame(buf, sizeof(buf))) > 0) {
+            for (size_t i = 0; i < n; i++) {
+                mismatches += (buf[i] != sim.fifoByte(start + pos + i));
+            }
+            pos += n;
+        }
+        CHECK(image > 0);
+        CHECK_EQ(pos, image);
+        CHECK_EQ(cam.getBurstFrameLength(), image);
+        frames++;
+    }
+    CHECK_EQ(frames, 3);
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testBurstCapture(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+
+    CHECK_EQ(cam.takeBurst(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8, 3), CAM_ERR_NONE);
+    CHECK_EQ(cam.getTotalLength(), 3 * 96 * 96);
+    uint8_t frames = 0;
+    uint32_t mismatches = 0;
+    while (cam.nextBurstFrame()) {
+        uint8_t buf[77];
+        uint32_t pos = 0;
+        size_t n;
+        while ((n = cam.readBurstFrame(buf, sizeof(buf))) > 0) {
+            for (size_t i = 0; i < n; i++) {
+                mismatches += (buf[i] != sim.fifoByte(frames * 96 * 96 + pos + i));
+            }
+            pos += n;
+        }
+        CHECK_EQ(pos, 96 * 96);
+        frames++;
+    }
+    CHECK_EQ(frames, 3);
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(sim.getCounters().triggers, 1);
+    CHECK_EQ(sim.peekReg(ARDUCHIP_FRAMES), 0);
+
+    // Refused before ARDUCHIP_FRAMES is written
+    uint32_t writes = sim.getCounters().writes;
+    CHECK_EQ(cam.takeBurst(CAM_IMAGE_MODE_NONE, CAM_IMAGE_PIX_FMT_Y8, 3), CAM_ERR_INVALID);
+    CHECK_EQ(cam.takeBurst(CAM_IMAGE_MODE_12, CAM_IMAGE_PIX_FMT_Y8, 3), CAM_ERR_INVALID);
+    CHECK_EQ(sim.getCounters().writes, writes);
+    CHECK_EQ(cam.startCapture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    writes = sim.getCounters().writes;
+    CHECK_EQ(cam.takeBurst(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8, 3), CAM_ERR_BUSY);
+    CHECK_EQ(sim.getCounters().writes, writes);
+    while (cam.poll() != CAM_CAPTURE_READY && cam.getCaptureState() != CAM_CAPTURE_ERROR) {
+    }
+    CHECK_EQ(drain(cam, sim, 0, 255), 96 * 96);
+    CHECK_EQ(cam.startVideo(CAM_VIDEO_MODE_1), CAM_ERR_NONE);
+    writes = sim.getCounters().writes;
+    CHECK_EQ(cam.takeBurst(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8, 3), CAM_ERR_BUSY);
+    CHECK_EQ(sim.getCounters().writes, writes);
+    CHECK_EQ(cam.stopVideo(), CAM_ERR_NONE);
+    CHECK_EQ(cam.standby(), CAM_ERR_NONE);
+    writes = sim.getCounters().writes;
+    CHECK_EQ(cam.takeBurst(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8, 3), CAM_ERR_BUSY);
+    CHECK_EQ(sim.getCounters().writes, writes);
+    CHECK_EQ(sim.peekReg(ARDUCHIP_FRAMES), 0);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testAsyncDrain(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_128X128, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    uint8_t buf[200];
+    uint32_t offset = 0;
+    uint32_t mismatches = 0;
+    while (cam.readImageBufAsync(buf, sizeof(buf)) > 0) {
+        size_t n = 0;
+        CHECK_EQ(cam.waitImageBuf(&n), CAM_ERR_NONE);
+        for (size_t i = 0; i < n; i++) {
+            mismatches += (buf[i] != sim.fifoByte(offset + i));
+        }
+        offset += n;
+    }
+    CHECK_EQ(offset, 128 * 128);
+    CHECK_EQ(mismatches, 0);
+
+    // Trimmed JPEG chunks, the SOI may straddle two of them
+    sim.setJpegLayout(8, 40, true);
+    cam.setJpegTrim(true);
+    static const size_t chunks[] = {2, 3, 7};
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_JPG), CAM_ERR_NONE);
+        uint32_t start = 0;
+        uint32_t image = sim.getJpegImage(0, &start);
+        offset = 0;
+        while (cam.readImageBufAsync(buf, chunks[c]) > 0) {
+            size_t n = 0;
+            CHECK_EQ(cam.waitImageBuf(&n), CAM_ERR_NONE);
+            for (size_t i = 0; i < n; i++) {
+                mismatches += (buf[i] != sim.fifoByte(start + offset + i));
+            }
+            offset += n;
+        }
+        CHECK_EQ(offset, image);
+        CHECK(cam.isImageComplete());
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testVideo(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+
+    CHECK_EQ(cam.startVideo(CAM_VIDEO_MODE_1), CAM_ERR_NONE);
+    CHECK_EQ(sim.peekReg(CAM_REG_CAPTURE_RESOLUTION), CAM_SET_VIDEO_MODE | CAM_VIDEO_MODE_1);
+    for (uint32_t i = 1; i <= 3; i++) {
+        uint32_t seq = 0;
+        CHECK_EQ(cam.nextFrame(&seq), CAM_ERR_NONE);
+        CHECK_EQ(seq, i);
+        CHECK(cam.getFrameInfo().video);
+        CHECK_EQ(cam.getFrameInfo().mode, CAM_VIDEO_MODE_1);
+        // The last read triggers the next frame, so the FIFO content is
+        // compared up to the last chunk
+        uint32_t length = cam.getTotalLength();
+        CHECK_EQ(length, sim.getFifoLength());
+        uint8_t buf[255];
+        uint32_t offset = 0;
+        uint32_t mismatches = 0;
+        size_t n;
+        while ((n = cam.readImageBuf(buf, sizeof(buf))) > 0) {
+            for (size_t j = 0; j < n && cam.getUnreceivedLength() > 0; j++) {
+                mismatches += (buf[j] != sim.fifoByte(offset + j));
+            }
+            offset += n;
+        }
+        CHECK_EQ(offset, length);
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(sim.getCounters().triggers, i + 1);
+    }
+    // Every frame is triggered once, the next one right after the drain
+    CHECK_EQ(sim.getCounters().triggers, 4);
+    CHECK_EQ(cam.stopVideo(), CAM_ERR_NONE);
+    CHECK_EQ(sim.peekReg(CAM_REG_CAPTURE_RESOLUTION), CAM_SET_CAPTURE_MODE | CAM_IMAGE_MODE_VGA);
+
+    // A still capture of another size configures its own resolution
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK_EQ(sim.peekReg(CAM_REG_CAPTURE_RESOLUTION), CAM_SET_CAPTURE_MODE | CAM_IMAGE_MODE_QVGA);
+    CHECK_EQ(cam.getFrameInfo().mode, CAM_IMAGE_MODE_QVGA);
+    CHECK(!cam.getFrameInfo().video);
+    CHECK_EQ(drain(cam, sim, 0, 255), 320 * 240);
+
+    // reset() ends a running stream and the capture in progress
+    CHECK_EQ(cam.startVideo(CAM_VIDEO_MODE_1), CAM_ERR_NONE);
+    CHECK_EQ(cam.nextFrame(NULL), CAM_ERR_NONE);
+    uint8_t chunk[64];
+    CHECK(cam.readImageBufAsync(chunk, sizeof(chunk)) > 0);
+    CHECK_EQ(cam.reset(), CAM_ERR_NONE);
+    CHECK(!cam.isVideoActive());
+    CHECK_EQ(cam.getCaptureState(), CAM_CAPTURE_IDLE);
+    size_t received = 1;
+    CHECK_EQ(cam.waitImageBuf(&received), CAM_ERR_NONE);
+    CHECK_EQ(received, 0);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK(!cam.getFrameInfo().video);
+    CHECK_EQ(drain(cam, sim, 0, 255), 320 * 240);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testShadowCommit(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+    sim.setBusyUs(5000);
+
+    // A format written by poll() is only known once the camera is idle
+    CHECK_EQ(cam.startCapture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK_EQ(cam.poll(), CAM_CAPTURE_CONFIG);
+    CHECK_EQ(sim.peekReg(CAM_REG_FORMAT), CAM_IMAGE_PIX_FMT_Y8);
+    CHECK_EQ(cam.getCurrentPixelFormat(), CAM_IMAGE_PIX_FMT_NONE);
+    while (cam.poll() != CAM_CAPTURE_READY && cam.getCaptureState() != CAM_CAPTURE_ERROR) {
+    }
+    CHECK_EQ(cam.getCaptureState(), CAM_CAPTURE_READY);
+    CHECK_EQ(cam.getCurrentPixelFormat(), CAM_IMAGE_PIX_FMT_Y8);
+    CHECK_EQ(cam.getCurrentPictureMode(), CAM_IMAGE_MODE_QVGA);
+    CHECK_EQ(drain(cam, sim, 0, 255), 320 * 240);
+
+    // A blocking write is known after its idle wait
+    CHECK_EQ(cam.setBrightness(CAM_BRIGHTNESS_LEVEL_2), CAM_ERR_NONE);
+    CHECK(cam.getAppliedMask() & CAM_SETTING_BRIGHTNESS);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testApplySettings(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+
+    // Eight controls, eight writes and one idle wait
+    CameraSettings settings = Arducam_Qwiic_CAM::defaultSettings();
+    settings.quality = LOW_QUALITY;
+    settings.brightness = CAM_BRIGHTNESS_LEVEL_2;
+    settings.contrast = CAM_CONTRAST_LEVEL_MINUS_1;
+    settings.saturation = CAM_SATURATION_LEVEL_2;
+    settings.ev = CAM_EV_LEVEL_1;
+    settings.whiteBalance = CAM_WHITE_BALANCE_MODE_HOME;
+    settings.colorEffect = CAM_COLOR_FX_BW;
+    settings.sharpness = CAM_SHARPNESS_LEVEL_3;
+    uint8_t failed = 0xff;
+    sim.resetCounters();
+    CHECK_EQ(cam.applySettings(settings, CAM_SETTING_ALL, &failed), CAM_ERR_NONE);
+    CHECK_EQ(failed, 0);
+    CHECK_EQ(sim.getCounters().writes, 8);
+    CHECK_EQ(sim.getCounters().statusReads, 1);
+    CHECK_EQ(sim.peekReg(CAM_REG_BRIGHTNESS_CONTROL), CAM_BRIGHTNESS_LEVEL_2);
+    CHECK_EQ(sim.peekReg(CAM_REG_IMAGE_QUALITY), LOW_QUALITY);
+    CHECK_EQ(cam.getAppliedMask(), CAM_SETTING_ALL);
+    CHECK_EQ(cam.getAppliedSettings().sharpness, CAM_SHARPNESS_LEVEL_3);
+
+    // Unchanged controls are not written and need no wait
+    sim.resetCounters();
+    CHECK_EQ(cam.applySettings(settings), CAM_ERR_NONE);
+    CHECK_EQ(sim.getCounters().writes, 0);
+    CHECK_EQ(sim.getCounters().statusReads, 0);
+
+    // Brightness is written first, a failure is reported for it alone
+    settings.brightness = CAM_BRIGHTNESS_LEVEL_DEFAULT;
+    settings.contrast = CAM_CONTRAST_LEVEL_DEFAULT;
+    sim.resetCounters();
+    sim.failTransfers(1);
+    CHECK_EQ(cam.applySettings(settings, CAM_SETTING_ALL, &failed), CAM_ERR_NO_CALLBACK);
+    CHECK_EQ(failed, CAM_SETTING_BRIGHTNESS);
+    CHECK_EQ(sim.getCounters().failures, 1);
+    CHECK_EQ(sim.peekReg(CAM_REG_BRIGHTNESS_CONTROL), CAM_BRIGHTNESS_LEVEL_2);
+    CHECK_EQ(sim.peekReg(CAM_REG_CONTRAST_CONTROL), CAM_CONTRAST_LEVEL_DEFAULT);
+    CHECK_EQ(cam.getAppliedSettings().contrast, CAM_CONTRAST_LEVEL_DEFAULT);
+    CHECK(cam.getDirtyMask() != 0);
+
+    // Fields outside the mask are left alone, the failed one is retried
+    sim.resetCounters();
+    CHECK_EQ(cam.applySettings(settings, CAM_SETTING_BRIGHTNESS, &failed), CAM_ERR_NONE);
+    CHECK_EQ(failed, 0);
+    CHECK_EQ(sim.getCounters().writes, 1);
+    CHECK_EQ(sim.peekReg(CAM_REG_BRIGHTNESS_CONTROL), CAM_BRIGHTNESS_LEVEL_DEFAULT);
+    CHECK_EQ(cam.getAppliedSettings().brightness, CAM_BRIGHTNESS_LEVEL_DEFAULT);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testStats(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+    CHECK(cam.getStats() == NULL);
+
+    // The library counts, this file is built without QWIIC_CAM_ENABLE_STATS
+    static CamStats stats;
+    cam.setStats(&stats);
+    sim.resetCounters();
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK_EQ(drain(cam, sim, 0, 255), 320 * 240);
+    CHECK(cam.getStats() == &stats);
+    CHECK_EQ(stats.captures, 1);
+    CHECK_EQ(stats.fifoBytes, 320 * 240);
+    CHECK_EQ(stats.fifoBursts, sim.getCounters().fifoReads);
+    CHECK_EQ(stats.regWrites, sim.getCounters().writes);
+    CHECK_EQ(stats.latency[CAM_IMAGE_MODE_QVGA - 1][CAM_IMAGE_PIX_FMT_Y8 - 1][0], 1);
+
+    cam.resetStats();
+    CHECK_EQ(stats.captures, 0);
+    cam.setStats(NULL);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK_EQ(stats.captures, 0);
+    CHECK_EQ(cam.getDrainBytesPerSecond(), 0);
+}
+
+static void testCapturePolicy(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+
+    // Without a policy every takePicture() is one capture
+    CHECK_EQ(cam.getCapturePolicy(), CAM_POLICY_NONE);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK_EQ(sim.getCounters().triggers, 1);
+    CHECK_EQ(drain(cam, sim, 0, 255), 96 * 96);
+
+    // A format change costs one reconfig frame
+    cam.setCapturePolicy(CAM_POLICY_DEFAULT);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_RGB565), CAM_ERR_NONE);
+    CHECK_EQ(sim.getCounters().triggers, 3);
+    CHECK_EQ(cam.getPolicyCounters().reconfigFrames, 1);
+    CHECK_EQ(drain(cam, sim, 0, 255), 96 * 96 * 2);
+
+    // After reset() the warm-up frame is followed by a reconfig frame, also
+    // for the same format
+    CHECK_EQ(cam.reset(), CAM_ERR_NONE);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_RGB565), CAM_ERR_NONE);
+    CHECK_EQ(sim.getCounters().triggers, 6);
+    CHECK_EQ(cam.getPolicyCounters().warmupFrames, 1);
+    CHECK_EQ(cam.getPolicyCounters().reconfigFrames, 2);
+    CHECK_EQ(drain(cam, sim, 0, 255), 96 * 96 * 2);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_RGB565), CAM_ERR_NONE);
+    CHECK_EQ(sim.getCounters().triggers, 7);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testCameraGroup(void)
+{
+    Arducam_Qwiic_SimBus simA;
+    Arducam_Qwiic_SimBus simB;
+    simA.setExposureUs(2000);
+    simB.setExposureUs(3000);
+    Arducam_Qwiic_CAM camA(simA);
+    Arducam_Qwiic_CAM camB(simB);
+    CHECK_EQ(camA.begin(), CAM_ERR_NONE);
+    CHECK_EQ(camB.begin(), CAM_ERR_NONE);
+
+    Arducam_Qwiic_CameraGroup group;
+    CHECK(group.add(camA));
+    CHECK(group.add(camB));
+    CHECK_EQ(group.trigger(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    uint8_t ready = 0;
+    int8_t i;
+    while ((i = group.nextReady()) >= 0) {
+        // The group reports the camera's own timestamps, not when it looked
+        const CamFrameInfo& info = group.getCamera(i).getFrameInfo();
+        CHECK_EQ(group.getTriggerUs(i), info.triggerUs);
+        CHECK_EQ(group.getDoneUs(i), info.doneUs);
+        CHECK(info.doneUs - info.triggerUs >= (i == 0 ? 2000UL : 3000UL));
+        CHECK_EQ(drain(group.getCamera(i), i == 0 ? simA : simB, 0, 255), 96 * 96);
+        ready++;
+    }
+    CHECK_EQ(ready, 2);
+}
+
+static void testMotionCheck(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+
+    Arducam_Qwiic_MotionDetector detector;
+    bool motion = false;
+    CHECK_EQ(detector.check(cam, CAM_IMAGE_MODE_NONE, &motion), CAM_ERR_INVALID);
+    CHECK_EQ(sim.getCounters().triggers, 0);
+
+    // The first full frame becomes the reference and reports motion
+    CHECK_EQ(detector.check(cam, CAM_IMAGE_MODE_96X96, &motion), CAM_ERR_NONE);
+    CHECK(motion);
+    CHECK_EQ(cam.getUnreceivedLength(), 0);
+}
+
+static void testStandby(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    sim.setExposureUs(2000);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+
+    // Not while a capture or a video stream is running
+    CHECK_EQ(cam.startCapture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK_EQ(cam.standby(), CAM_ERR_BUSY);
+    while (cam.poll() != CAM_CAPTURE_READY && cam.getCaptureState() != CAM_CAPTURE_ERROR) {
+    }
+    CHECK_EQ(drain(cam, sim, 0, 255), 96 * 96);
+    CHECK_EQ(cam.startVideo(CAM_VIDEO_MODE_1), CAM_ERR_NONE);
+    CHECK_EQ(cam.standby(), CAM_ERR_BUSY);
+    CHECK_EQ(cam.stopVideo(), CAM_ERR_NONE);
+    CHECK(!cam.isStandby());
+    CHECK_EQ(sim.peekReg(CAM_REG_POWER_CONTROL), CAM_POWER_NORMAL);
+
+    // In standby captures are refused without touching the module
+    CHECK_EQ(cam.standby(), CAM_ERR_NONE);
+    CHECK(cam.isStandby());
+    CHECK_EQ(sim.peekReg(CAM_REG_POWER_CONTROL), CAM_POWER_STANDBY);
+    uint32_t triggers = sim.getCounters().triggers;
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_BUSY);
+    CHECK_EQ(sim.getCounters().triggers, triggers);
+
+    CHECK_EQ(cam.wake(), CAM_ERR_NONE);
+    CHECK(!cam.isStandby());
+    CHECK_EQ(sim.peekReg(CAM_REG_POWER_CONTROL), CAM_POWER_NORMAL);
+    CHECK_EQ(cam.getStartupLatencyUs(), 0);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK(cam.getStartupLatencyUs() >= 2000);
+    CHECK_EQ(drain(cam, sim, 0, 255), 96 * 96);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testRestoreSettings(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_RGB565), CAM_ERR_NONE);
+    CHECK_EQ(drain(cam, sim, 0, 255), 96 * 96 * 2);
+    CHECK_EQ(cam.setBrightness(CAM_BRIGHTNESS_LEVEL_2), CAM_ERR_NONE);
+    CHECK_EQ(cam.setContrast(CAM_CONTRAST_LEVEL_MINUS_1), CAM_ERR_NONE);
+    uint8_t brightness = sim.peekReg(CAM_REG_BRIGHTNESS_CONTROL);
+    uint8_t contrast = sim.peekReg(CAM_REG_CONTRAST_CONTROL);
+    CHECK(brightness != 0);
+    CHECK(contrast != 0);
+
+    // The sensor drops back to its defaults
+    CHECK_EQ(cam.reset(), CAM_ERR_NONE);
+    CHECK_EQ(sim.peekReg(CAM_REG_BRIGHTNESS_CONTROL), 0);
+    CHECK_EQ(sim.peekReg(CAM_REG_CONTRAST_CONTROL), 0);
+
+    // The control values come back, format and resolution are left to the
+    // next capture
+    CHECK_EQ(cam.restoreSettings(), CAM_ERR_NONE);
+    CHECK_EQ(sim.peekReg(CAM_REG_BRIGHTNESS_CONTROL), brightness);
+    CHECK_EQ(sim.peekReg(CAM_REG_CONTRAST_CONTROL), contrast);
+    CHECK_EQ(sim.peekReg(CAM_REG_FORMAT), 0);
+    CHECK_EQ(sim.peekReg(CAM_REG_CAPTURE_RESOLUTION), 0);
+
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_RGB565), CAM_ERR_NONE);
+    CHECK_EQ(sim.peekReg(CAM_REG_FORMAT), CAM_IMAGE_PIX_FMT_RGB565);
+    CHECK_EQ(sim.peekReg(CAM_REG_CAPTURE_RESOLUTION), CAM_SET_CAPTURE_MODE | CAM_IMAGE_MODE_96X96);
+    CHECK_EQ(drain(cam, sim, 0, 255), 96 * 96 * 2);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testTiming(void)
+{
+    // Real time: the driver has to wait for idle and for CAP_DONE
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    sim.setBusyUs(300);
+    sim.setExposureUs(5000);
+    CHECK_EQ(cam.begin(1000000), CAM_ERR_NONE);
+    CHECK_EQ(cam.getBusClock(), 1000000);
+
+    // Warm-up discards one frame, the next capture is used
+    cam.setCapturePolicy(CAM_POLICY_WARMUP);
+    unsigned long startUs = micros();
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK(micros() - startUs >= 2 * 5000);
+    CHECK_EQ(sim.getCounters().triggers, 2);
+    CHECK(sim.getCounters().statusReads > 2);
+    CHECK_EQ(drain(cam, sim, 0, 255), 320 * 240);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    CHECK_EQ(sim.getCounters().triggers, 3);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+static void testClockFallback(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(1000000), CAM_ERR_NONE);
+    CHECK_EQ(sim.getClock(), 1000000);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+
+    // Fewer errors in a row than the limit keep the clock
+    uint8_t buf[255];
+    sim.failTransfers(QWIIC_CAM_CLOCK_ERROR_LIMIT - 1);
+    for (uint8_t i = 0; i < QWIIC_CAM_CLOCK_ERROR_LIMIT - 1; i++) {
+        CHECK_EQ(cam.readImageBuf(buf, sizeof(buf)), 0);
+    }
+    CHECK_EQ(cam.readImageBuf(buf, sizeof(buf)), sizeof(buf));
+    sim.failTransfers(QWIIC_CAM_CLOCK_ERROR_LIMIT - 1);
+    for (uint8_t i = 0; i < QWIIC_CAM_CLOCK_ERROR_LIMIT - 1; i++) {
+        CHECK_EQ(cam.readImageBuf(buf, sizeof(buf)), 0);
+    }
+    CHECK_EQ(cam.getClockFallbacks(), 0);
+    CHECK_EQ(cam.getBusClock(), 1000000);
+
+    // The link breaks above 600 kHz: each run of errors steps one clock
+    // down until the reads work again, the frame is not lost
+    sim.setMaxClock(600000);
+    for (uint8_t i = 0; i < 2 * QWIIC_CAM_CLOCK_ERROR_LIMIT && cam.getBusClock() > 600000; i++) {
+        CHECK_EQ(cam.readImageBuf(buf, sizeof(buf)), 0);
+    }
+    CHECK_EQ(cam.getClockFallbacks(), 2);
+    CHECK_EQ(cam.getBusClock(), 600000);
+    CHECK_EQ(sim.getClock(), 600000);
+    uint32_t offset = 96 * 96 - cam.getUnreceivedLength();
+    CHECK_EQ(drain(cam, sim, offset, 255), 96 * 96 - offset);
+    CHECK_EQ(sim.getCounters().violations, 0);
+
+    // Link verification rejects the failing clocks and keeps 600 kHz
+    CHECK_EQ(cam.begin(1000000), CAM_ERR_NONE);
+    CHECK_EQ(cam.getBusClock(), 600000);
+    CHECK_EQ(sim.getClock(), 600000);
+
+    // The clock never drops below QWIIC_CAM_I2C_SPEED
+    sim.setMaxClock(1);
+    for (uint8_t i = 0; i < 4 * QWIIC_CAM_CLOCK_ERROR_LIMIT; i++) {
+        CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NO_CALLBACK);
+    }
+    CHECK_EQ(cam.getBusClock(), QWIIC_CAM_I2C_SPEED);
+    CHECK_EQ(sim.getClock(), QWIIC_CAM_I2C_SPEED);
+    CHECK_EQ(cam.getClockFallbacks(), 3);
+}
+
+static void testBusFailure(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+
+    // A failed FIFO read leaves the rest of the frame for the next call
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_96X96, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    uint8_t buf[255];
+    CHECK_EQ(cam.readImageBuf(buf, sizeof(buf)), sizeof(buf));
+    sim.failTransfers(1);
+    CHECK_EQ(cam.readImageBuf(buf, sizeof(buf)), 0);
+    CHECK_EQ(cam.getUnreceivedLength(), 96 * 96 - sizeof(buf));
+    CHECK_EQ(drain(cam, sim, sizeof(buf), 255), 96 * 96 - sizeof(buf));
+    CHECK_EQ(sim.getCounters().failures, 1);
+
+    // Another address is never acknowledged
+    Arducam_Qwiic_SimBus other(0x0D);
+    Arducam_Qwiic_CAM absent(other);
+    CHECK_EQ(absent.begin(1000000), CAM_ERR_NO_CALLBACK);
+}
+
+int main(void)
+{
+    testRawCapture();
+    testJpegCapture();
+    testBurstCapture();
+    testJpegBurstCapture();
+    testAsyncDrain();
+    testVideo();
+    testShadowCommit();
+    testApplySettings();
+    testStats();
+    testCapturePolicy();
+    testCameraGroup();
+    testMotionCheck();
+    testStandby();
+    testRestoreSettings();
+    testTiming();
+    testClockFallback();
+    testBusFailure();
+    return testResult("test_capture");
+}
@@ -0,0 +1,145 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Slot layout across the 2^32 index wrap, and a producer and a consumer
+// thread sharing one ring. Also built with ThreadSanitizer, see CMakeLists.txt.
+
+#include <thread>
+
+// Start head and tail just below the wrap
+#define private public
+#include "Arducam_Qwiic_ChunkRing.h"
+#undef private
+#include "test_common.h"
+
+#define CHUNK 48
+
+static uint8_t chunkByte(uint32_t chunk, uint16_t i)
+{
+    return (uint8_t)(chunk * 31 + i);
+}
+
+static uint16_t chunkLength(uint32_t chunk)
+{
+    return (uint16_t)(chunk % CHUNK + 1);
+}
+
+static void testSlotCount(void)
+{
+    static uint8_t arena[6 * (CHUNK + CAM_RING_SLOT_HEADER)];
+    Arducam_Qwiic_ChunkRing ring;
+    CHECK(ring.begin(arena, sizeof(arena), CHUNK));
+    CHECK_EQ(ring.getSlotCount(), 4);
+    CHECK(ring.begin(arena, 3 * (CHUNK + CAM_RING_SLOT_HEADER), CHUNK));
+    CHECK_EQ(ring.getSlotCount(), 2);
+    CHECK(!ring.begin(arena, 2 * (CHUNK + CAM_RING_SLOT_HEADER) - 1, CHUNK));
+}
+
+static void testWrap(void)
+{
+    static uint8_t arena[6 * (CHUNK + CAM_RING_SLOT_HEADER)];
+    Arducam_Qwiic_ChunkRing ring;
+    CHECK(ring.begin(arena, sizeof(arena), CHUNK));
+    ring.head = ring.tail = 0xfffffff0;
+
+    // Fill the ring and empty it again, over and over through the wrap
+    uint8_t data[CHUNK];
+    uint32_t pushed = 0;
+    uint32_t read = 0;
+    uint32_t mismatches = 0;
+    for (uint8_t round = 0; round < 12; round++) {
+        while (true) {
+            uint16_t length = chunkLength(pushed);
+            for (uint16_t i = 0; i < length; i++) {
+                data[i] = chunkByte(pushed, i);
+            }
+            if (!ring.push(data, length, 0)) {
+                break;
+            }
+            pushed++;
+        }
+        CHECK_EQ(ring.available(), ring.getSlotCount());
+        uint16_t length;
+        const uint8_t* chunk;
+        while ((chunk = ring.peek(&length, NULL)) != NULL) {
+            CHECK_EQ(length, chunkLength(read));
+            for (uint16_t i = 0; i < length; i++) {
+                mismatches += (chunk[i] != chunkByte(read, i));
+            }
+            ring.release();
+            read++;
+        }
+    }
+    CHECK_EQ(read, pushed);
+    CHECK_EQ(mismatches, 0);
+    CHECK(ring.head < 0xfffffff0);
+    CHECK_EQ(ring.getStats().chunksRead, read);
+}
+
+static void testThreads(void)
+{
+    static uint8_t arena[5 * (CHUNK + CAM_RING_SLOT_HEADER)];
+    Arducam_Qwiic_ChunkRing ring;
+    CHECK(ring.begin(arena, sizeof(arena), CHUNK));
+    ring.head = ring.tail = 0xffffff00;
+    const uint32_t chunks = 200000;
+
+    std::thread producer([&ring, chunks]() {
+        for (uint32_t c = 0; c < chunks;) {
+            uint8_t* dst = ring.acquire();
+            if (dst == NULL) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint16_t length = chunkLength(c);
+            for (uint16_t i = 0; i < length; i++) {
+                dst[i] = chunkByte(c, i);
+            }
+            ring.commit(length, (c % 10 == 9) ? CAM_RING_FRAME_END : 0);
+            c++;
+        }
+    });
+
+    uint32_t mismatches = 0;
+    uint32_t frames = 0;
+    for (uint32_t c = 0; c < chunks;) {
+        uint16_t length;
+        uint8_t flags;
+        const uint8_t* chunk = ring.peek(&length, &flags);
+        if (chunk == NULL) {
+            std::this_thread::yield();
+            continue;
+        }
+        mismatches += (length != chunkLength(c));
+        for (uint16_t i = 0; i < length && i < CHUNK; i++) {
+            mismatches += (chunk[i] != chunkByte(c, i));
+        }
+        frames += (flags & CAM_RING_FRAME_END) ? 1 : 0;
+        ring.release();
+        c++;
+    }
+    producer.join();
+
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(frames, chunks / 10);
+    CHECK_EQ(ring.available(), 0);
+    CamRingStats stats = ring.getStats();
+    CHECK_EQ(stats.chunksQueued, chunks);
+    CHECK_EQ(stats.chunksRead, chunks);
+    CHECK_EQ(stats.framesQueued, chunks / 10);
+}
+
+int main(void)
+{
+    testSlotCount();
+    testWrap();
+    testThreads();
+    return testResult("test_chunk_ring");
+}
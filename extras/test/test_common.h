@@ -0,0 +1,43 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_TEST_COMMON_H
+#define __ARDUCAM_QWIIC_TEST_COMMON_H
+
+#include <stdio.h>
+
+// Minimal checks for the host tests, a failed check does not stop the test
+static int testFailures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);  \
+            testFailures++;                                                  \
+        }                                                                    \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                       \
+    do {                                                                     \
+        unsigned long long _a = (unsigned long long)(a);                     \
+        unsigned long long _b = (unsigned long long)(b);                     \
+        if (_a != _b) {                                                      \
+            printf("%s:%d: check failed: %s == %s (%llu != %llu)\n",         \
+                   __FILE__, __LINE__, #a, #b, _a, _b);                      \
+            testFailures++;                                                  \
+        }                                                                    \
+    } while (0)
+
+static inline int testResult(const char* name)
+{
+    printf("%s: %s\n", name, testFailures ? "FAILED" : "passed");
+    return testFailures ? 1 : 0;
+}
+
+#endif /*__ARDUCAM_QWIIC_TEST_COMMON_H*/
@@ -0,0 +1,166 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// RLE encoder to decoder round trips over arbitrary chunk boundaries, odd
+// ones included so RGB565 chunks split pixels
+
+#include "Arducam_Qwiic_Compress.h"
+#include "Arducam_Qwiic_SimBus.h"
+#include "test_common.h"
+#include <string.h>
+
+#define FRAME_SIZE  (320 * 240 * 2)
+
+static uint32_t rngState = 0x9e3779b9;
+
+static uint32_t rng(void)
+{
+    // xorshift32, the same stream on every run
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static uint8_t frame[FRAME_SIZE];
+static uint8_t packed[CAM_RLE_MAX_OUTPUT(FRAME_SIZE) + FRAME_SIZE / 8];
+static uint8_t unpacked[FRAME_SIZE + 1];
+
+// Compress the frame in chunks of maxChunk bytes with fixed, of 1..maxChunk
+// bytes otherwise, and return the compressed length
+static size_t encode(CAM_IMAGE_PIX_FMT format, size_t length, size_t maxChunk, bool fixed)
+{
+    Arducam_Qwiic_RleEncoder encoder;
+    CHECK(encoder.begin(format));
+    size_t in = 0;
+    size_t out = 0;
+    while (in < length) {
+        size_t chunk = fixed ? maxChunk : 1 + rng() % maxChunk;
+        if (chunk > length - in) {
+            chunk = length - in;
+        }
+        size_t n = encoder.process(frame + in, chunk, packed + out);
+        CHECK(n <= Arducam_Qwiic_RleEncoder::getMaxOutputLength(chunk));
+        in += chunk;
+        out += n;
+    }
+    size_t n = encoder.finish(packed + out);
+    CHECK(n <= Arducam_Qwiic_RleEncoder::getMaxOutputLength(0));
+    out += n;
+    CHECK_EQ(encoder.getInputLength(), length);
+    CHECK_EQ(encoder.getOutputLength(), out);
+    return out;
+}
+
+// Decompress in input pieces of 1..maxIn bytes into output room of
+// 1..maxOut bytes and compare with the frame
+static void decodeAndCompare(CAM_IMAGE_PIX_FMT format, size_t length, size_t packedLength, size_t maxIn, size_t maxOut)
+{
+    Arducam_Qwiic_RleDecoder decoder;
+    CHECK(decoder.begin(format));
+    size_t in = 0;
+    size_t out = 0;
+    for (;;) {
+        size_t piece = 1 + rng() % maxIn;
+        if (piece > packedLength - in) {
+            piece = packedLength - in;
+        }
+        size_t room = 1 + rng() % maxOut;
+        if (room > sizeof(unpacked) - out) {
+            room = sizeof(unpacked) - out;
+        }
+        size_t consumed = 0;
+        size_t n = decoder.process(packed + in, piece, unpacked + out, room, &consumed);
+        CHECK(consumed <= piece);
+        in += consumed;
+        out += n;
+        // Runs held by the decoder come out without more input
+        if ((in >= packedLength && n == 0) || room == 0) {
+            break;
+        }
+    }
+    CHECK_EQ(out, length);
+    CHECK(memcmp(frame, unpacked, length) == 0);
+}
+
+static void roundTrip(CAM_IMAGE_PIX_FMT format, size_t length)
+{
+    static const size_t fixedChunks[] = {1, 2, 3, 127, 128, 129, 255};
+    size_t reference = encode(format, length, length, true);
+    for (size_t c = 0; c < sizeof(fixedChunks) / sizeof(fixedChunks[0]); c++) {
+        // The output does not depend on the chunk boundaries
+        CHECK_EQ(encode(format, length, fixedChunks[c], true), reference);
+        decodeAndCompare(format, length, reference, 1 + rng() % 300, 1 + rng() % 300);
+    }
+    for (uint8_t round = 0; round < 4; round++) {
+        CHECK_EQ(encode(format, length, 1 + rng() % 600, false), reference);
+        decodeAndCompare(format, length, reference, 1 + rng() % 40, 1 + rng() % 40);
+    }
+}
+
+static void testSimFrames(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    Arducam_Qwiic_CAM cam(sim);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    static const CAM_IMAGE_PIX_FMT formats[] = {CAM_IMAGE_PIX_FMT_Y8, CAM_IMAGE_PIX_FMT_RGB565};
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, formats[f]), CAM_ERR_NONE);
+        size_t length = sim.getFifoLength();
+        CHECK(length <= FRAME_SIZE);
+        for (size_t i = 0; i < length; i++) {
+            frame[i] = sim.fifoByte((uint32_t)i);
+        }
+        CHECK_EQ(cam.clearFIFO(), CAM_ERR_NONE);
+        roundTrip(formats[f], length);
+        // The block pattern compresses
+        CHECK(encode(formats[f], length, 255, true) < length / 2);
+    }
+}
+
+static void testSyntheticFrames(void)
+{
+    static const CAM_IMAGE_PIX_FMT formats[] = {CAM_IMAGE_PIX_FMT_Y8, CAM_IMAGE_PIX_FMT_RGB565};
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        // Noise, the worst case for the literal blocks
+        for (size_t i = 0; i < 20000; i++) {
+            frame[i] = (uint8_t)rng();
+        }
+        roundTrip(formats[f], 20000);
+        CHECK(encode(formats[f], 20000, 255, true) <= Arducam_Qwiic_RleEncoder::getMaxOutputLength(20000));
+
+        // Runs around the run and literal limits
+        size_t length = 0;
+        for (size_t run = 1; run < 300 && length + run <= 30000; run++) {
+            memset(frame + length, (int)(rng() & 0xff), run);
+            length += run;
+        }
+        roundTrip(formats[f], length);
+
+        // A ramp is all equal deltas, an odd length ends inside a pixel
+        for (size_t i = 0; i < 10001; i++) {
+            frame[i] = (uint8_t)(i * 3);
+        }
+        roundTrip(formats[f], 10001);
+    }
+
+    // A JPEG frame is refused
+    Arducam_Qwiic_RleEncoder encoder;
+    Arducam_Qwiic_RleDecoder decoder;
+    CHECK(!encoder.begin(CAM_IMAGE_PIX_FMT_JPG));
+    CHECK(!decoder.begin(CAM_IMAGE_PIX_FMT_JPG));
+}
+
+int main(void)
+{
+    testSimFrames();
+    testSyntheticFrames();
+    return testResult("test_compress");
+}
@@ -0,0 +1,124 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Message shapes of the i2c-dev backend, run against the simulated module
+// through an overridden transfer()
+
+#include "Arducam_Qwiic_LinuxBus.h"
+#include "Arducam_Qwiic_SimBus.h"
+#include "test_common.h"
+#include <linux/i2c.h>
+
+class FakeLinuxBus : public Arducam_Qwiic_LinuxBus
+{
+public:
+    Arducam_Qwiic_SimBus& sim;
+    uint32_t transfers;
+    uint32_t malformed;
+    uint16_t longestRead;
+    bool fail;
+
+    explicit FakeLinuxBus(Arducam_Qwiic_SimBus& sim)
+        : Arducam_Qwiic_LinuxBus("/dev/null"), sim(sim), transfers(0), malformed(0), longestRead(0), fail(false) {}
+
+protected:
+    bool transfer(struct i2c_msg* msgs, uint32_t count)
+    {
+        transfers++;
+        if (fail) {
+            return false;
+        }
+        if (count == 1 && msgs[0].flags == 0) {
+            return sim.write((uint8_t)msgs[0].addr, msgs[0].buf, msgs[0].len);
+        }
+        // A register read is one combined transfer: the address byte, then
+        // the read after a repeated start
+        if (count != 2 || msgs[0].flags != 0 || msgs[0].len != 1 || msgs[1].flags != I2C_M_RD ||
+            msgs[0].addr != msgs[1].addr) {
+            malformed++;
+            return false;
+        }
+        if (msgs[1].len > longestRead) {
+            longestRead = msgs[1].len;
+        }
+        return sim.writeRead((uint8_t)msgs[1].addr, msgs[0].buf[0], msgs[1].buf, msgs[1].len) == msgs[1].len;
+    }
+};
+
+static void testMessages(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    FakeLinuxBus bus(sim);
+    CHECK(bus.begin());
+
+    uint8_t packet[2] = {ARDUCHIP_TEST1, 0x5A};
+    CHECK(bus.write(QWIIC_CAM_I2C_ADDRESS, packet, sizeof(packet)));
+    uint8_t data = 0;
+    CHECK_EQ(bus.writeRead(QWIIC_CAM_I2C_ADDRESS, ARDUCHIP_TEST1, &data, 1), 1);
+    CHECK_EQ(data, 0x5A);
+    CHECK_EQ(bus.transfers, 2);
+    CHECK_EQ(sim.getCounters().writes, 1);
+    CHECK_EQ(sim.getCounters().reads, 1);
+
+    // Lengths past one message are not truncated to 16 bits: a long write
+    // is refused, a long read returns one message
+    static uint8_t big[70000];
+    sim.setMaxReadLength(QWIIC_CAM_I2C_DEV_MAX_MSG);
+    big[0] = ARDUCHIP_TEST1;
+    CHECK(!bus.write(QWIIC_CAM_I2C_ADDRESS, big, sizeof(big)));
+    CHECK_EQ(bus.transfers, 2);
+    CHECK_EQ(sim.getCounters().writes, 1);
+    CHECK_EQ(bus.writeRead(QWIIC_CAM_I2C_ADDRESS, ARDUCHIP_TEST1, big, sizeof(big)), QWIIC_CAM_I2C_DEV_MAX_MSG);
+    CHECK_EQ(bus.longestRead, QWIIC_CAM_I2C_DEV_MAX_MSG);
+    CHECK_EQ(big[QWIIC_CAM_I2C_DEV_MAX_MSG - 1], 0x5A);
+
+    // A failed transfer reads nothing
+    bus.fail = true;
+    CHECK(!bus.write(QWIIC_CAM_I2C_ADDRESS, packet, sizeof(packet)));
+    CHECK_EQ(bus.writeRead(QWIIC_CAM_I2C_ADDRESS, ARDUCHIP_TEST1, &data, 1), 0);
+    CHECK_EQ(bus.malformed, 0);
+}
+
+static void testCapture(void)
+{
+    Arducam_Qwiic_SimBus sim;
+    sim.setMaxReadLength(QWIIC_CAM_I2C_DEV_MAX_MSG);
+    FakeLinuxBus bus(sim);
+    Arducam_Qwiic_CAM cam(bus);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_VGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    static uint8_t frame[640 * 480];
+    size_t total = 0;
+    size_t n;
+    while ((n = cam.readImageBuf(frame + total, sizeof(frame) - total)) > 0) {
+        total += n;
+    }
+    CHECK_EQ(total, sizeof(frame));
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < total; i++) {
+        mismatches += (frame[i] != sim.fifoByte(i));
+    }
+    CHECK_EQ(mismatches, 0);
+
+    // Bursts use the whole i2c-dev message and no more
+    CHECK_EQ(bus.longestRead, QWIIC_CAM_I2C_DEV_MAX_MSG);
+    CHECK_EQ(sim.getCounters().fifoReads, (sizeof(frame) + QWIIC_CAM_I2C_DEV_MAX_MSG - 1) / QWIIC_CAM_I2C_DEV_MAX_MSG);
+    CHECK_EQ(bus.malformed, 0);
+    CHECK_EQ(sim.getCounters().violations, 0);
+}
+
+int main(void)
+{
+    testMessages();
+    testCapture();
+    return testResult("test_linux_bus");
+}
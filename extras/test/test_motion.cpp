@@ -0,0 +1,136 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Motion detector verdicts and tile masks for synthetic Y8 frames fed in
+// odd chunk sizes. Also built with a large tile grid, see CMakeLists.txt.
+
+#include "Arducam_Qwiic_Motion.h"
+#include "test_common.h"
+#include <string.h>
+
+// Four pixels per cell, two cells per tile in each direction
+#define FRAME_W  (CAM_MOTION_CELLS_X * 4)
+#define FRAME_H  (CAM_MOTION_CELLS_Y * 4)
+#define TILE_W   (FRAME_W / QWIIC_CAM_MOTION_TILES_X)
+#define TILE_H   (FRAME_H / QWIIC_CAM_MOTION_TILES_Y)
+
+static uint8_t frame[FRAME_W * FRAME_H];
+
+static void fillBackground(void)
+{
+    for (uint32_t y = 0; y < FRAME_H; y++) {
+        for (uint32_t x = 0; x < FRAME_W; x++) {
+            frame[y * FRAME_W + x] = (uint8_t)(64 + (x * 3 + y * 5) % 64);
+        }
+    }
+}
+
+static void fillTile(uint16_t tx, uint16_t ty, uint8_t value)
+{
+    for (uint32_t y = ty * TILE_H; y < (uint32_t)(ty + 1) * TILE_H; y++) {
+        memset(frame + y * FRAME_W + tx * TILE_W, value, TILE_W);
+    }
+}
+
+// Feed the frame in chunks of 1, 2, .. 17 bytes and return the verdict
+static bool feed(Arducam_Qwiic_MotionDetector& detector)
+{
+    detector.startFrame();
+    size_t in = 0;
+    size_t chunk = 1;
+    while (in < sizeof(frame)) {
+        size_t n = (chunk > sizeof(frame) - in) ? sizeof(frame) - in : chunk;
+        detector.process(frame + in, n);
+        in += n;
+        chunk = chunk % 17 + 1;
+    }
+    return detector.endFrame();
+}
+
+static uint16_t maskBits(const Arducam_Qwiic_MotionDetector& detector)
+{
+    uint16_t bits = 0;
+    for (uint16_t i = 0; i < CAM_MOTION_TILE_COUNT; i++) {
+        bits += (detector.getChangedMask()[i / 8] >> (i % 8)) & 1;
+    }
+    return bits;
+}
+
+static void testUnchangedFrame(void)
+{
+    Arducam_Qwiic_MotionDetector detector;
+    CHECK(detector.begin(FRAME_W, FRAME_H));
+    fillBackground();
+
+    // The first frame becomes the reference and reports every tile
+    CHECK(feed(detector));
+    CHECK_EQ(detector.getChangedTiles(), CAM_MOTION_TILE_COUNT);
+
+    // The same frame again is no motion
+    CHECK(!feed(detector));
+    CHECK(!detector.isChanged());
+    CHECK_EQ(detector.getChangedTiles(), 0);
+    CHECK_EQ(maskBits(detector), 0);
+    CHECK_EQ(detector.getTileSad(0, 0), 0);
+}
+
+static void testChangedRegion(void)
+{
+    Arducam_Qwiic_MotionDetector detector;
+    CHECK(detector.begin(FRAME_W, FRAME_H));
+    detector.setThreshold(CAM_MOTION_DEFAULT_TILE_SAD, 1, 0);
+    fillBackground();
+    CHECK(feed(detector));
+
+    // One tile turns white, only its bit is set
+    const uint16_t tx = QWIIC_CAM_MOTION_TILES_X - 3;
+    const uint16_t ty = QWIIC_CAM_MOTION_TILES_Y / 2;
+    fillTile(tx, ty, 255);
+    CHECK(feed(detector));
+    CHECK_EQ(detector.getChangedTiles(), 1);
+    CHECK_EQ(maskBits(detector), 1);
+    uint16_t index = ty * QWIIC_CAM_MOTION_TILES_X + tx;
+    CHECK_EQ((detector.getChangedMask()[index / 8] >> (index % 8)) & 1, 1);
+    CHECK(detector.isTileChanged(tx, ty));
+    CHECK(!detector.isTileChanged(tx - 1, ty));
+    CHECK(detector.getTileSad(tx, ty) > CAM_MOTION_DEFAULT_TILE_SAD);
+
+    // The tile turns back and another one changes, two tiles are below a
+    // threshold of three
+    detector.setThreshold(CAM_MOTION_DEFAULT_TILE_SAD, 3, 0);
+    fillBackground();
+    fillTile(0, 0, 255);
+    CHECK(!feed(detector));
+    CHECK_EQ(detector.getChangedTiles(), 2);
+    CHECK(detector.isTileChanged(0, 0));
+    CHECK(detector.isTileChanged(tx, ty));
+}
+
+static void testWholeFrameChanged(void)
+{
+    // Every tile changes, the count must not wrap on large grids
+    Arducam_Qwiic_MotionDetector detector;
+    CHECK(detector.begin(FRAME_W, FRAME_H));
+    detector.setThreshold(CAM_MOTION_DEFAULT_TILE_SAD, CAM_MOTION_TILE_COUNT, 0);
+    memset(frame, 0, sizeof(frame));
+    CHECK(feed(detector));
+    memset(frame, 255, sizeof(frame));
+    CHECK(feed(detector));
+    CHECK_EQ(detector.getChangedTiles(), CAM_MOTION_TILE_COUNT);
+    CHECK_EQ(maskBits(detector), CAM_MOTION_TILE_COUNT);
+}
+
+int main(void)
+{
+    testUnchangedFrame();
+    testChangedRegion();
+    testWholeFrameChanged();
+    return testResult("test_motion");
+}
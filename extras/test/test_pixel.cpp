@@ -0,0 +1,206 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Pixel kernels fed in odd chunk sizes, so rows and RGB565 pixels split
+// across chunks, compared with a whole-frame reference
+
+#include "Arducam_Qwiic_Pixel.h"
+#include "test_common.h"
+#include <string.h>
+
+#define MAX_FRAME  (160 * 120 * 2)
+
+static uint32_t rngState = 0x2545f491;
+
+static uint32_t rng(void)
+{
+    // xorshift32, the same stream on every run
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static uint8_t frame[MAX_FRAME];
+static uint8_t expected[MAX_FRAME / 2 * 3];
+static uint8_t streamed[MAX_FRAME / 2 * 3 + 8];
+
+static uint8_t expand5(uint8_t v)
+{
+    return (uint8_t)((v << 3) | (v >> 2));
+}
+
+static uint8_t expand6(uint8_t v)
+{
+    return (uint8_t)((v << 2) | (v >> 4));
+}
+
+// Crop, decimate and convert the whole frame pixel by pixel
+static size_t reference(uint16_t w, uint16_t h, CAM_IMAGE_PIX_FMT format, CAM_PIXEL_OUT out,
+                        uint16_t cx, uint16_t cy, uint16_t cw, uint16_t ch, uint8_t step)
+{
+    uint8_t bpp = (format == CAM_IMAGE_PIX_FMT_RGB565) ? 2 : 1;
+    size_t n = 0;
+    for (uint32_t y = cy; y < (uint32_t)cy + ch && y < h; y += step) {
+        for (uint32_t x = cx; x < (uint32_t)cx + cw && x < w; x += step) {
+            const uint8_t* p = frame + (y * w + x) * bpp;
+            if (bpp == 1) {
+                int copies = (out == CAM_PIXEL_OUT_RGB888) ? 3 : 1;
+                for (int i = 0; i < copies; i++) {
+                    expected[n++] = p[0];
+                }
+                continue;
+            }
+            uint16_t v = (uint16_t)((p[0] << 8) | p[1]);
+            uint8_t r = expand5(v >> 11);
+            uint8_t g = expand6((v >> 5) & 0x3f);
+            uint8_t b = expand5(v & 0x1f);
+            switch (out) {
+            case CAM_PIXEL_OUT_Y8:
+                expected[n++] = (uint8_t)((77 * r + 150 * g + 29 * b) >> 8);
+                break;
+            case CAM_PIXEL_OUT_RGB888:
+                expected[n++] = r;
+                expected[n++] = g;
+                expected[n++] = b;
+                break;
+            case CAM_PIXEL_OUT_RGB565_LE:
+                expected[n++] = p[1];
+                expected[n++] = p[0];
+                break;
+            default:
+                expected[n++] = p[0];
+                expected[n++] = p[1];
+                break;
+            }
+        }
+    }
+    return n;
+}
+
+// Stream the frame in chunks of 1..maxChunk bytes and compare with the
+// reference
+static void streamAndCompare(uint16_t w, uint16_t h, CAM_IMAGE_PIX_FMT format, CAM_PIXEL_OUT out,
+                             uint16_t cx, uint16_t cy, uint16_t cw, uint16_t ch, uint8_t step, size_t maxChunk)
+{
+    size_t length = (size_t)w * h * ((format == CAM_IMAGE_PIX_FMT_RGB565) ? 2 : 1);
+    for (size_t i = 0; i < length; i++) {
+        frame[i] = (uint8_t)rng();
+    }
+
+    Arducam_Qwiic_PixelStream pixels;
+    CHECK(pixels.begin(w, h, format, out));
+    pixels.setCrop(cx, cy, cw, ch);
+    CHECK(pixels.setDecimation(step));
+
+    size_t want = reference(w, h, format, out, cx, cy, cw, ch, step);
+    CHECK_EQ(pixels.getOutputLength(), want);
+
+    size_t in = 0;
+    size_t produced = 0;
+    while (in < length) {
+        size_t chunk = 1 + rng() % maxChunk;
+        if (chunk > length - in) {
+            chunk = length - in;
+        }
+        size_t n = pixels.process(frame + in, chunk, streamed + produced);
+        CHECK(n <= pixels.getMaxOutputLength(chunk));
+        in += chunk;
+        produced += n;
+    }
+    CHECK_EQ(produced, want);
+    CHECK(memcmp(streamed, expected, want) == 0);
+}
+
+static void testConversions(void)
+{
+    static const CAM_PIXEL_OUT outputs[] = {
+        CAM_PIXEL_OUT_NATIVE, CAM_PIXEL_OUT_Y8, CAM_PIXEL_OUT_RGB888, CAM_PIXEL_OUT_RGB565_LE
+    };
+    for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); i++) {
+        streamAndCompare(37, 23, CAM_IMAGE_PIX_FMT_RGB565, outputs[i], 0, 0, 37, 23, 1, 1);
+        streamAndCompare(37, 23, CAM_IMAGE_PIX_FMT_RGB565, outputs[i], 0, 0, 37, 23, 1, 77);
+    }
+    streamAndCompare(37, 23, CAM_IMAGE_PIX_FMT_Y8, CAM_PIXEL_OUT_NATIVE, 0, 0, 37, 23, 1, 13);
+    streamAndCompare(37, 23, CAM_IMAGE_PIX_FMT_Y8, CAM_PIXEL_OUT_RGB888, 0, 0, 37, 23, 1, 13);
+
+    // Y8 has no RGB565 output, JPEG no pixels at all
+    Arducam_Qwiic_PixelStream pixels;
+    CHECK(!pixels.begin(37, 23, CAM_IMAGE_PIX_FMT_Y8, CAM_PIXEL_OUT_RGB565_LE));
+    CHECK(!pixels.begin(37, 23, CAM_IMAGE_PIX_FMT_JPG, CAM_PIXEL_OUT_NATIVE));
+}
+
+static void testCropAndDecimation(void)
+{
+    static const uint8_t steps[] = {1, 2, 4};
+    for (size_t i = 0; i < sizeof(steps); i++) {
+        // Odd crop edges, so the decimation phase differs from row to row
+        streamAndCompare(160, 120, CAM_IMAGE_PIX_FMT_RGB565, CAM_PIXEL_OUT_NATIVE, 13, 7, 101, 77, steps[i], 255);
+        streamAndCompare(160, 120, CAM_IMAGE_PIX_FMT_RGB565, CAM_PIXEL_OUT_RGB565_LE, 13, 7, 101, 77, steps[i], 33);
+        streamAndCompare(160, 120, CAM_IMAGE_PIX_FMT_RGB565, CAM_PIXEL_OUT_Y8, 1, 0, 158, 119, steps[i], 511);
+        streamAndCompare(160, 120, CAM_IMAGE_PIX_FMT_Y8, CAM_PIXEL_OUT_NATIVE, 13, 7, 101, 77, steps[i], 9);
+        streamAndCompare(160, 120, CAM_IMAGE_PIX_FMT_Y8, CAM_PIXEL_OUT_RGB888, 13, 7, 101, 77, steps[i], 300);
+    }
+
+    // A crop past the frame edge is clipped
+    streamAndCompare(160, 120, CAM_IMAGE_PIX_FMT_RGB565, CAM_PIXEL_OUT_NATIVE, 150, 110, 40, 40, 2, 17);
+    CHECK(!Arducam_Qwiic_PixelStream().setDecimation(3));
+}
+
+static void testModeSize(void)
+{
+    Arducam_Qwiic_PixelStream pixels;
+    CHECK(pixels.begin(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_RGB565, CAM_PIXEL_OUT_Y8));
+    CHECK_EQ(pixels.getOutputWidth(), 320);
+    CHECK_EQ(pixels.getOutputHeight(), 240);
+    CHECK(pixels.setDecimation(4));
+    CHECK_EQ(pixels.getOutputLength(), 80 * 60);
+}
+
+static void testInputBound(void)
+{
+    // A chunk of getMaxInputLength(space) bytes never writes past space,
+    // also with a byte carried over from the previous chunk
+    Arducam_Qwiic_PixelStream pixels;
+    CHECK(pixels.begin(64, 64, CAM_IMAGE_PIX_FMT_RGB565, CAM_PIXEL_OUT_RGB888));
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        frame[i] = (uint8_t)rng();
+    }
+    size_t in = 0;
+    size_t length = 64 * 64 * 2;
+    while (in < length) {
+        size_t space = 1 + rng() % 64;
+        size_t chunk = pixels.getMaxInputLength(space);
+        if (chunk == 0) {
+            // Not even one RGB888 pixel fits
+            CHECK(space < 3);
+            continue;
+        }
+        if (chunk > length - in) {
+            chunk = length - in;
+        }
+        memset(streamed, 0xa5, space + 8);
+        size_t n = pixels.process(frame + in, chunk, streamed);
+        CHECK(n <= space);
+        CHECK_EQ(streamed[space], 0xa5);
+        in += chunk;
+    }
+    CHECK_EQ(pixels.getMaxInputLength(2), 0);
+    CHECK_EQ(pixels.getMaxInputLength(6), 3);
+}
+
+int main(void)
+{
+    testConversions();
+    testCropAndDecimation();
+    testModeSize();
+    testInputBound();
+    return testResult("test_pixel");
+}
@@ -0,0 +1,275 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Round trips and damaged streams through Arducam_Qwiic_PacketDecoder, fed
+// in random pieces
+
+#include "Arducam_Qwiic_Protocol.h"
+#include "test_common.h"
+#include <string.h>
+
+#define STREAM_SIZE  (64 * 1024)
+#define MAX_PACKETS  256
+#define MAX_PAYLOAD  300
+
+static uint32_t rngState = 0x12345678;
+
+static uint32_t rng(void)
+{
+    // xorshift32, the same stream on every run
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+typedef struct {
+    uint8_t type;
+    bool crc;
+    uint32_t offset;           /**< Payload position in the stream */
+    uint32_t length;
+} SentPacket;
+
+typedef struct {
+    uint8_t stream[STREAM_SIZE];
+    uint32_t size;
+    SentPacket packets[MAX_PACKETS];
+    uint16_t count;
+} Stream;
+
+// Append an encoded packet with a random payload
+static SentPacket* appendPacket(Stream* s, uint8_t type, uint32_t length, bool crc)
+{
+    SentPacket* p = &s->packets[s->count++];
+    p->type = type;
+    p->crc = crc;
+    p->length = length;
+    s->size += Arducam_Qwiic_PacketEncoder::encodeHeader(s->stream + s->size, type, length, crc);
+    p->offset = s->size;
+    for (uint32_t i = 0; i < length; i++) {
+        s->stream[s->size++] = (uint8_t)rng();
+    }
+    uint32_t value = Arducam_Qwiic_PacketEncoder::crc32(0, s->stream + p->offset, length);
+    s->size += Arducam_Qwiic_PacketEncoder::encodeTail(s->stream + s->size, crc, value);
+    return p;
+}
+
+static void appendRandomPackets(Stream* s, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        appendPacket(s, (uint8_t)(rng() & 0x7f), rng() % MAX_PAYLOAD, (rng() & 1) != 0);
+    }
+}
+
+typedef struct {
+    uint32_t ends;
+    uint32_t errors;
+    uint32_t mismatches;       /**< END packets that differ from the packet sent */
+    uint32_t unknown;          /**< END packets that match no packet sent */
+    uint8_t payload[MAX_PAYLOAD + 1];
+    uint32_t received;
+    uint32_t announced;
+    uint16_t next;             /**< Next packet expected in order */
+} Decoded;
+
+// Feed the stream in random pieces of 1..maxPiece bytes. With inOrder every
+// END must be the next packet sent, otherwise any packet sent.
+static void decode(const Stream* s, Arducam_Qwiic_PacketDecoder& decoder, uint32_t maxPiece, bool inOrder, Decoded* d)
+{
+    memset(d, 0, sizeof(*d));
+    uint32_t pos = 0;
+    while (pos < s->size) {
+        uint32_t piece = 1 + rng() % maxPiece;
+        if (piece > s->size - pos) {
+            piece = s->size - pos;
+        }
+        const uint8_t* data = s->stream + pos;
+        size_t left = piece;
+        while (left > 0) {
+            CamPacketEvent ev;
+            size_t used = decoder.feed(data, left, &ev);
+            // Every call makes progress and stays within the input
+            CHECK(used > 0 && used <= left);
+            if (used == 0 || used > left) {
+                return;
+            }
+            if (ev.event == CAM_PROTO_EVENT_HEADER) {
+                d->received = 0;
+                d->announced = ev.length;
+            } else if (ev.event == CAM_PROTO_EVENT_PAYLOAD) {
+                CHECK(ev.data >= data && ev.data + ev.length <= data + used);
+                CHECK(d->received + ev.length <= d->announced);
+                if (d->received + ev.length <= MAX_PAYLOAD) {
+                    memcpy(d->payload + d->received, ev.data, ev.length);
+                }
+                d->received += ev.length;
+            } else if (ev.event == CAM_PROTO_EVENT_END) {
+                d->ends++;
+                CHECK_EQ(ev.length, d->received);
+                bool found = false;
+                for (uint16_t i = inOrder ? d->next : 0; i < s->count && !found; i++) {
+                    const SentPacket* p = &s->packets[i];
+                    found = (p->type == ev.type && p->crc == ev.hasCrc && p->length == ev.length &&
+                             memcmp(s->stream + p->offset, d->payload, p->length) == 0);
+                    if (inOrder) {
+                        d->mismatches += !found;
+                        d->next = i + 1;
+                        break;
+                    }
+                }
+                d->unknown += !found;
+            } else if (ev.event == CAM_PROTO_EVENT_ERROR) {
+                d->errors++;
+            }
+            data += used;
+            left -= used;
+        }
+        pos += piece;
+    }
+}
+
+static void testRoundTrip(void)
+{
+    static Stream s;
+    static const uint32_t pieces[] = {1, 2, 7, 64, 4096};
+    for (size_t p = 0; p < sizeof(pieces) / sizeof(pieces[0]); p++) {
+        memset(&s, 0, sizeof(s));
+        appendPacket(&s, 0x01, 0, false);
+        appendPacket(&s, 0x02, 0, true);
+        appendRandomPackets(&s, 150);
+
+        Arducam_Qwiic_PacketDecoder decoder(MAX_PAYLOAD);
+        Decoded d;
+        decode(&s, decoder, pieces[p], true, &d);
+        CHECK_EQ(d.ends, s.count);
+        CHECK_EQ(d.errors, 0);
+        CHECK_EQ(d.mismatches, 0);
+    }
+}
+
+static void testCorruptCrc(void)
+{
+    static Stream s;
+    memset(&s, 0, sizeof(s));
+    appendRandomPackets(&s, 20);
+    SentPacket* bad = appendPacket(&s, 0x03, 100, true);
+    appendRandomPackets(&s, 20);
+
+    // One flipped payload bit fails the CRC of that packet only
+    s.stream[bad->offset + 50] ^= 0x10;
+    bad->type = 0xff;
+    Arducam_Qwiic_PacketDecoder decoder(MAX_PAYLOAD);
+    Decoded d;
+    decode(&s, decoder, 16, false, &d);
+    CHECK_EQ(d.errors, 1);
+    CHECK_EQ(d.ends, s.count - 1);
+    CHECK_EQ(d.unknown, 0);
+
+    // So does a flipped bit in the CRC itself
+    s.stream[bad->offset + 50] ^= 0x10;
+    s.stream[bad->offset + bad->length] ^= 0x01;
+    decode(&s, decoder, 16, false, &d);
+    CHECK_EQ(d.errors, 1);
+    CHECK_EQ(d.ends, s.count - 1);
+    CHECK_EQ(d.unknown, 0);
+}
+
+static void testTruncated(void)
+{
+    static Stream s;
+
+    // A packet without its tail: the next header is taken for the tail and
+    // the decoder resyncs on it
+    memset(&s, 0, sizeof(s));
+    appendRandomPackets(&s, 5);
+    SentPacket* cut = appendPacket(&s, 0x04, 40, false);
+    s.size -= 2;
+    cut->type = 0xff;
+    appendRandomPackets(&s, 5);
+    Arducam_Qwiic_PacketDecoder decoder(MAX_PAYLOAD);
+    Decoded d;
+    decode(&s, decoder, 5, false, &d);
+    CHECK_EQ(d.errors, 1);
+    CHECK_EQ(d.ends, s.count - 1);
+    CHECK_EQ(d.unknown, 0);
+
+    // Packets cut anywhere, payload included: CRC packets never come out
+    // damaged and the decoder finds its way back
+    for (uint8_t round = 0; round < 50; round++) {
+        memset(&s, 0, sizeof(s));
+        for (uint16_t i = 0; i < 30; i++) {
+            SentPacket* p = appendPacket(&s, (uint8_t)(rng() & 0x7f), rng() % MAX_PAYLOAD, true);
+            if (rng() % 4 == 0) {
+                uint32_t full = CAM_PROTO_HEADER_SIZE + p->length + CAM_PROTO_TAIL_SIZE;
+                s.size -= 1 + rng() % (full - 1);
+                p->type = 0xff;
+            }
+        }
+        // Clean packets behind the damage
+        for (uint16_t i = 0; i < 20; i++) {
+            appendPacket(&s, (uint8_t)(rng() & 0x7f), rng() % MAX_PAYLOAD, true);
+        }
+        decoder.reset();
+        decode(&s, decoder, 33, false, &d);
+        CHECK_EQ(d.unknown, 0);
+        CHECK(d.ends > 0);
+    }
+}
+
+static void testOverLength(void)
+{
+    static Stream s;
+    memset(&s, 0, sizeof(s));
+    appendPacket(&s, 0x05, 20, false);
+    SentPacket* big = appendPacket(&s, 0x06, MAX_PAYLOAD, true);
+    big->type = 0xff;
+    appendPacket(&s, 0x07, 20, true);
+
+    // The header over maxLength is an error at once; its payload is
+    // skipped as noise and the packet behind it decodes
+    Arducam_Qwiic_PacketDecoder decoder(MAX_PAYLOAD - 1);
+    Decoded d;
+    decode(&s, decoder, 3, false, &d);
+    CHECK(d.errors >= 1);
+    CHECK_EQ(d.ends, 2);
+    CHECK_EQ(d.unknown, 0);
+}
+
+static void testNoise(void)
+{
+    // Random bytes with the sync bytes over-represented
+    static Stream s;
+    memset(&s, 0, sizeof(s));
+    for (uint32_t i = 0; i < STREAM_SIZE / 2; i++) {
+        uint32_t r = rng();
+        s.stream[s.size++] = (r & 3) == 0 ? CAM_PROTO_SYNC : (r & 3) == 1 ? CAM_PROTO_HEADER_SYNC : (uint8_t)(r >> 8);
+    }
+    Arducam_Qwiic_PacketDecoder decoder(MAX_PAYLOAD);
+    Decoded d;
+    decode(&s, decoder, 50, false, &d);
+
+    // The decoder is usable after the noise
+    memset(&s, 0, sizeof(s));
+    appendRandomPackets(&s, 10);
+    decoder.reset();
+    decode(&s, decoder, 9, true, &d);
+    CHECK_EQ(d.ends, s.count);
+    CHECK_EQ(d.mismatches, 0);
+}
+
+int main(void)
+{
+    testRoundTrip();
+    testCorruptCrc();
+    testTruncated();
+    testOverLength();
+    testNoise();
+    return testResult("test_protocol");
+}
@@ -0,0 +1,86 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+// Simulated time: the bus model of the simulated module, the timed bus and
+// the driver's frame timestamps must agree
+
+#include "Arducam_Qwiic_SimBus.h"
+#include "Arducam_Qwiic_TimedBus.h"
+#include "test_common.h"
+
+static void testVirtualClock(void)
+{
+    Arducam_Qwiic_VirtualClock clock;
+    Arducam_Qwiic_HostClock::install(&clock);
+    CHECK_EQ(micros(), 0);
+    delay(3);
+    delayMicroseconds(250);
+    CHECK_EQ(micros(), 3250);
+    CHECK_EQ(millis(), 3);
+    Arducam_Qwiic_HostClock::install(NULL);
+}
+
+static void testCaptureTime(void)
+{
+    Arducam_Qwiic_VirtualClock clock;
+    Arducam_Qwiic_HostClock::install(&clock);
+
+    Arducam_Qwiic_SimBus sim;
+    sim.setExposureUs(8000);
+    sim.setPixelRate(10000000);
+    sim.setBusTiming(true, 20);
+    Arducam_Qwiic_TimedBus timedBus(sim);
+    timedBus.setOverheadUs(20);
+    Arducam_Qwiic_CAM cam(timedBus);
+    CHECK_EQ(cam.begin(), CAM_ERR_NONE);
+    cam.setCapturePolicy(CAM_POLICY_NONE);
+    timedBus.reset();
+    sim.resetCounters();
+
+    uint64_t startUs = clock.nowUs();
+    CHECK_EQ(cam.takePicture(CAM_IMAGE_MODE_QVGA, CAM_IMAGE_PIX_FMT_Y8), CAM_ERR_NONE);
+    const CamFrameInfo& info = cam.getFrameInfo();
+    // Exposure plus readout of 76800 pixels at 10 Mpixel/s
+    CHECK(info.doneUs - info.triggerUs >= 8000 + 7680);
+    // Found by the next poll, the backoff leaves at most one poll interval
+    CHECK(info.doneUs - info.triggerUs <= 8000 + 7680 + QWIIC_CAM_POLL_MAX_INTERVAL_MS * 1000 + 1000);
+
+    uint8_t buf[255];
+    while (cam.readImageBuf(buf, sizeof(buf)) > 0) {
+    }
+    uint64_t elapsedUs = clock.nowUs() - startUs;
+
+    // 76800 bytes of FIFO data at 400 kHz take 76800 * 9 / 0.4 us, plus
+    // the three address bytes and the overhead of each burst
+    const CamSimCounters& sc = sim.getCounters();
+    uint32_t bursts = (76800 + 254) / 255;
+    CHECK_EQ(sc.fifoReads, bursts);
+    uint64_t fifoUs = (76800ULL + 3 * bursts) * 9 * 1000000 / QWIIC_CAM_I2C_SPEED + 20ULL * bursts;
+    CHECK(sc.fifoUs >= fifoUs && sc.fifoUs <= fifoUs + bursts);
+    CHECK_EQ(info.drainEndUs - info.drainStartUs >= sc.fifoUs, 1);
+
+    // The timed bus measures the same time the simulated module spends,
+    // and its model of the traffic matches
+    CHECK_EQ(timedBus.getCounters().busyUs, sc.busUs);
+    uint32_t modelUs = timedBus.modelUs(QWIIC_CAM_I2C_SPEED);
+    uint32_t transactions = sc.writes + sc.reads;
+    CHECK(sc.busUs >= modelUs && sc.busUs <= modelUs + transactions);
+    CHECK(elapsedUs >= sc.busUs + 8000 + 7680);
+    CHECK_EQ(sc.violations, 0);
+
+    Arducam_Qwiic_HostClock::install(NULL);
+}
+
+int main(void)
+{
+    testVirtualClock();
+    testCaptureTime();
+    return testResult("test_timing");
+}
@@ -0,0 +1,309 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_Broadcaster.h"
+#include <string.h>
+
+#if defined(__linux__) && !defined(ARDUINO)
+#include <errno.h>
+#include <linux/sockios.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static const char multipartHeader[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: multipart/x-mixed-replace; boundary=frame\r\n"
+    "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+    "Pragma: no-cache\r\n"
+    "Connection: keep-alive\r\n";
+
+static size_t appendText(char* dst, size_t pos, const char* text)
+{
+    size_t len = strlen(text);
+    memcpy(dst + pos, text, len);
+    return pos + len;
+}
+
+static size_t appendNumber(char* dst, size_t pos, uint32_t value)
+{
+    char digits[10];
+    uint8_t count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (count > 0) {
+        dst[pos++] = digits[--count];
+    }
+    return pos;
+}
+
+#if defined(ARDUINO)
+Arducam_Qwiic_ClientSink::Arducam_Qwiic_ClientSink(Client& client, bool checkWritable)
+    : client(client), checkWritable(checkWritable), slowWrite(false)
+{
+}
+
+size_t Arducam_Qwiic_ClientSink::writable(void)
+{
+    if (!checkWritable) {
+        // Without a reported send space, a viewer whose last write blocked
+        // skips one frame
+        bool skip = slowWrite;
+        slowWrite = false;
+        return skip ? 0 : (size_t)-1;
+    }
+    int space = client.availableForWrite();
+    return (space > 0) ? (size_t)space : 0;
+}
+
+size_t Arducam_Qwiic_ClientSink::write(const uint8_t* data, size_t length)
+{
+    if (checkWritable) {
+        return client.write(data, length);
+    }
+    if (slowWrite) {
+        return 0;
+    }
+    unsigned long startMs = millis();
+    size_t written = client.write(data, length);
+    if (millis() - startMs >= QWIIC_CAM_BROADCAST_SLOW_WRITE_MS) {
+        slowWrite = true;
+    }
+    return written;
+}
+
+bool Arducam_Qwiic_ClientSink::connected(void)
+{
+    return client.connected();
+}
+
+void Arducam_Qwiic_ClientSink::stop(void)
+{
+    client.stop();
+}
+#endif
+
+#if defined(__linux__) && !defined(ARDUINO)
+Arducam_Qwiic_SocketSink::Arducam_Qwiic_SocketSink(int fd) : fd(fd)
+{
+}
+
+size_t Arducam_Qwiic_SocketSink::writable(void)
+{
+    int queued = 0;
+    int sndbuf = 0;
+    socklen_t optlen = sizeof(sndbuf);
+    if (fd < 0 || ioctl(fd, SIOCOUTQ, &queued) < 0 ||
+        getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, &optlen) < 0) {
+        return 0;
+    }
+    return (sndbuf > queued) ? (size_t)(sndbuf - queued) : 0;
+}
+
+size_t Arducam_Qwiic_SocketSink::write(const uint8_t* data, size_t length)
+{
+    if (fd < 0) {
+        return 0;
+    }
+    ssize_t sent = send(fd, data, length, MSG_DONTWAIT | MSG_NOSIGNAL);
+    return (sent > 0) ? (size_t)sent : 0;
+}
+
+bool Arducam_Qwiic_SocketSink::connected(void)
+{
+    if (fd < 0) {
+        return false;
+    }
+    uint8_t probe;
+    ssize_t ret = recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (ret == 0) {
+        return false; // Orderly shutdown by the viewer
+    }
+    return (ret > 0 || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+}
+
+void Arducam_Qwiic_SocketSink::stop(void)
+{
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+#endif
+
+Arducam_Qwiic_Broadcaster::Arducam_Qwiic_Broadcaster()
+{
+    framesRead = 0;
+    frameHeaders = false;
+    for (uint8_t i = 0; i < QWIIC_CAM_BROADCAST_MAX_CLIENTS; i++) {
+        sinks[i] = NULL;
+        memset(&stats[i], 0, sizeof(stats[i]));
+    }
+}
+
+int8_t Arducam_Qwiic_Broadcaster::add(Arducam_Qwiic_FrameSink& sink, bool sendHeader)
+{
+    for (uint8_t i = 0; i < QWIIC_CAM_BROADCAST_MAX_CLIENTS; i++) {
+        if (sinks[i] != NULL) {
+            continue;
+        }
+        sinks[i] = &sink;
+        memset(&stats[i], 0, sizeof(stats[i]));
+        stats[i].startMs = millis();
+        if (sendHeader && !send(i, (const uint8_t*)multipartHeader, sizeof(multipartHeader) - 1)) {
+            remove(i);
+            return -1;
+        }
+        return (int8_t)i;
+    }
+    return -1;
+}
+
+void Arducam_Qwiic_Broadcaster::remove(uint8_t slot)
+{
+    if (slot >= QWIIC_CAM_BROADCAST_MAX_CLIENTS || sinks[slot] == NULL) {
+        return;
+    }
+    sinks[slot]->stop();
+    sinks[slot] = NULL;
+}
+
+bool Arducam_Qwiic_Broadcaster::contains(const Arducam_Qwiic_FrameSink* sink) const
+{
+    for (uint8_t i = 0; i < QWIIC_CAM_BROADCAST_MAX_CLIENTS; i++) {
+        if (sinks[i] == sink && sink != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t Arducam_Qwiic_Broadcaster::prune(void)
+{
+    for (uint8_t i = 0; i < QWIIC_CAM_BROADCAST_MAX_CLIENTS; i++) {
+        if (sinks[i] != NULL && !sinks[i]->connected()) {
+            remove(i);
+        }
+    }
+    return getClientCount();
+}
+
+uint8_t Arducam_Qwiic_Broadcaster::getClientCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < QWIIC_CAM_BROADCAST_MAX_CLIENTS; i++) {
+        if (sinks[i] != NULL) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool Arducam_Qwiic_Broadcaster::send(uint8_t slot, const uint8_t* data, size_t length)
+{
+    size_t written = sinks[slot]->write(data, length);
+    stats[slot].bytesSent += written;
+    return (written == length);
+}
+
+CamStatus Arducam_Qwiic_Broadcaster::broadcast(Arducam_Qwiic_CAM& cam)
+{
+    uint32_t length = cam.getUnreceivedLength();
+    bool active[QWIIC_CAM_BROADCAST_MAX_CLIENTS];
+    uint8_t receivers = 0;
+
+    // Each part starts with CRLF, so a viewer that lost the end of the
+    // previous part still finds the boundary. There is no Content-Length: a
+    // viewer dropped in the middle of the frame would read past the boundary.
+    char header[128];
+    size_t headerLen = appendText(header, 0, "\r\n--frame\r\nContent-Type: image/jpeg\r\n");
+    if (frameHeaders) {
+        const CamFrameInfo& info = cam.getFrameInfo();
+        headerLen = appendText(header, headerLen, "X-Frame-Seq: ");
+        headerLen = appendNumber(header, headerLen, info.seq);
+        headerLen = appendText(header, headerLen, "\r\nX-Capture-Us: ");
+        headerLen = appendNumber(header, headerLen, info.triggerUs);
+        headerLen = appendText(header, headerLen, "\r\n");
+    }
+    headerLen = appendText(header, headerLen, "\r\n");
+
+    size_t needed = headerLen + ((length < QWIIC_CAM_BROADCAST_MIN_WRITABLE) ? length : QWIIC_CAM_BROADCAST_MIN_WRITABLE);
+    prune();
+    for (uint8_t i = 0; i < QWIIC_CAM_BROADCAST_MAX_CLIENTS; i++) {
+        active[i] = false;
+        if (sinks[i] == NULL) {
+            continue;
+        }
+        if (sinks[i]->writable() < needed || !send(i, (const uint8_t*)header, headerLen)) {
+            stats[i].framesDropped++;
+            continue;
+        }
+        active[i] = true;
+        receivers++;
+    }
+
+    if (receivers == 0) {
+        return cam.clearFIFO();
+    }
+
+    uint8_t buf[QWIIC_CAM_BROADCAST_BUF_SIZE];
+    while (receivers > 0 && cam.getUnreceivedLength() > 0) {
+        size_t n = cam.readImageBuf(buf, sizeof(buf));
+        if (n == 0) {
+            break;
+        }
+        for (uint8_t i = 0; i < QWIIC_CAM_BROADCAST_MAX_CLIENTS; i++) {
+            if (active[i] && !send(i, buf, n)) {
+                active[i] = false;
+                receivers--;
+                stats[i].framesDropped++;
+            }
+        }
+    }
+    framesRead++;
+
+    if (cam.getUnreceivedLength() > 0) {
+        // Every receiver fell behind, skip the rest of the frame
+        CAM_RETURN_IF_ERR(cam.clearFIFO());
+    }
+    for (uint8_t i = 0; i < QWIIC_CAM_BROADCAST_MAX_CLIENTS; i++) {
+        if (active[i]) {
+            stats[i].framesSent++;
+        }
+    }
+    return CAM_ERR_NONE;
+}
+
+const CamViewerStats& Arducam_Qwiic_Broadcaster::getClientStats(uint8_t slot) const
+{
+    return stats[slot];
+}
+
+float Arducam_Qwiic_Broadcaster::getClientFps(uint8_t slot) const
+{
+    unsigned long elapsed = millis() - stats[slot].startMs;
+    if (elapsed == 0) {
+        return 0;
+    }
+    return stats[slot].framesSent * 1000.0f / elapsed;
+}
+
+uint32_t Arducam_Qwiic_Broadcaster::getFramesRead() const
+{
+    return framesRead;
+}
+
+void Arducam_Qwiic_Broadcaster::setFrameHeaders(bool enable)
+{
+    frameHeaders = enable;
+}
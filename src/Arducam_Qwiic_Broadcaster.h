@@ -0,0 +1,274 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_BROADCASTER_H
+#define __ARDUCAM_QWIIC_BROADCASTER_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+/**
+* @file Arducam_Qwiic_Broadcaster.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+#if !defined(QWIIC_CAM_BROADCAST_MAX_CLIENTS)
+#define QWIIC_CAM_BROADCAST_MAX_CLIENTS  4    // Viewers per broadcaster
+#endif
+
+#if !defined(QWIIC_CAM_BROADCAST_BUF_SIZE)
+#define QWIIC_CAM_BROADCAST_BUF_SIZE     128  // FIFO bytes read per fan-out step
+#endif
+
+#if !defined(QWIIC_CAM_BROADCAST_MIN_WRITABLE)
+#define QWIIC_CAM_BROADCAST_MIN_WRITABLE 512  // Free send space a viewer needs to get a frame
+#endif
+
+#if !defined(QWIIC_CAM_BROADCAST_SLOW_WRITE_MS)
+#define QWIIC_CAM_BROADCAST_SLOW_WRITE_MS 20  // Blocking write time that marks a viewer as slow
+#endif
+
+/**
+* @brief One viewer of a broadcast
+*
+* Implemented for Arduino Client and for Linux sockets below; any other
+* transport only needs these calls.
+*/
+class Arducam_Qwiic_FrameSink
+{
+public:
+	virtual ~Arducam_Qwiic_FrameSink() {}
+
+	//**********************************************
+	//!
+	//! @brief Get the bytes that can be written without blocking
+	//!
+	//! @return Return the free send space
+	//**********************************************
+	virtual size_t writable(void) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Send data to the viewer
+	//!
+	//! @return Return the length accepted, short if the viewer is full
+	//**********************************************
+	virtual size_t write(const uint8_t* data, size_t length) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Check if the viewer is still there
+	//!
+	//! @return Returns false once the viewer disconnected
+	//**********************************************
+	virtual bool connected(void) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Close the connection to the viewer
+	//**********************************************
+	virtual void stop(void) {}
+};
+
+#if defined(ARDUINO)
+/**
+* @brief Frame sink on top of an Arduino Client, e.g. WiFiClient
+*/
+class Arducam_Qwiic_ClientSink : public Arducam_Qwiic_FrameSink
+{
+private:
+	Client& client;                                     /**< Connection to the viewer */
+	bool checkWritable;                                 /**< Trust availableForWrite() */
+	bool slowWrite;                                     /**< A write blocked, the viewer sits out until the next frame */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the client sink
+	//!
+	//! @param  client Connection to the viewer
+	//! @param  checkWritable Set to false on cores whose Client does not
+	//! implement availableForWrite(). A write that blocks for
+	//! QWIIC_CAM_BROADCAST_SLOW_WRITE_MS then ends the frame for this
+	//! viewer, and it skips the next one.
+	//**********************************************
+	Arducam_Qwiic_ClientSink(Client& client, bool checkWritable = true);
+
+	size_t writable(void);
+	size_t write(const uint8_t* data, size_t length);
+	bool connected(void);
+	void stop(void);
+};
+#endif
+
+#if defined(__linux__) && !defined(ARDUINO)
+/**
+* @brief Frame sink on top of a connected Linux stream socket
+*/
+class Arducam_Qwiic_SocketSink : public Arducam_Qwiic_FrameSink
+{
+private:
+	int fd;                                             /**< Socket, -1 once stopped */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the socket sink
+	//!
+	//! @param  fd Connected socket, closed by stop()
+	//**********************************************
+	explicit Arducam_Qwiic_SocketSink(int fd);
+
+	size_t writable(void);
+	size_t write(const uint8_t* data, size_t length);
+	bool connected(void);
+	void stop(void);
+};
+#endif
+
+/**
+ * @struct CamViewerStats
+ * @brief Counters of one broadcast viewer
+ */
+typedef struct {
+    uint32_t framesSent;       /**< Frames written completely */
+    uint32_t framesDropped;    /**< Frames skipped or cut short because the viewer was slow */
+    uint32_t bytesSent;        /**< Bytes accepted by the viewer */
+    unsigned long startMs;     /**< Time the viewer was added */
+} CamViewerStats;
+
+/**
+* @brief Sends each camera frame to several MJPEG viewers
+*
+* The frame is read from the FIFO once and every chunk is written to all
+* viewers. A viewer without QWIIC_CAM_BROADCAST_MIN_WRITABLE bytes of free
+* send space at the start of a frame skips it, and a viewer that stops
+* accepting data in the middle of a frame loses the rest of it, so a slow
+* viewer never stalls the camera or the others. Parts carry no
+* Content-Length, viewers find the end of a cut part by the boundary.
+*/
+class Arducam_Qwiic_Broadcaster
+{
+private:
+	Arducam_Qwiic_FrameSink* sinks[QWIIC_CAM_BROADCAST_MAX_CLIENTS]; /**< Viewers, NULL for free slots */
+	CamViewerStats stats[QWIIC_CAM_BROADCAST_MAX_CLIENTS];            /**< Counters of each viewer */
+	uint32_t framesRead;                                              /**< Frames read from the camera */
+	bool frameHeaders;                                                /**< Add X-Frame-Seq and X-Capture-Us to each part */
+
+	//**********************************************
+	//!
+	//! @brief Write a whole buffer to a viewer
+	//!
+	//! @return Returns false if the viewer did not accept all of it
+	//**********************************************
+	bool send(uint8_t slot, const uint8_t* data, size_t length);
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the broadcaster
+	//**********************************************
+	Arducam_Qwiic_Broadcaster();
+
+	//**********************************************
+	//!
+	//! @brief Add a viewer
+	//!
+	//! @param  sink Connection to the viewer
+	//! @param  sendHeader Send the HTTP multipart response header first
+	//!
+	//! @return Return the slot of the viewer, -1 if all slots are taken
+	//**********************************************
+	int8_t add(Arducam_Qwiic_FrameSink& sink, bool sendHeader = true);
+
+	//**********************************************
+	//!
+	//! @brief Stop and remove a viewer
+	//!
+	//! @param  slot Slot returned by add()
+	//**********************************************
+	void remove(uint8_t slot);
+
+	//**********************************************
+	//!
+	//! @brief Check if a sink is one of the viewers
+	//!
+	//! @return Returns true if the sink was added and not removed
+	//**********************************************
+	bool contains(const Arducam_Qwiic_FrameSink* sink) const;
+
+	//**********************************************
+	//!
+	//! @brief Remove the viewers that disconnected
+	//!
+	//! @return Return the number of remaining viewers
+	//**********************************************
+	uint8_t prune(void);
+
+	//**********************************************
+	//!
+	//! @brief Get the number of viewers
+	//!
+	//! @return Return the viewer count
+	//**********************************************
+	uint8_t getClientCount() const;
+
+	//**********************************************
+	//!
+	//! @brief Send the frame waiting in the camera FIFO to all viewers
+	//!
+	//! @param  cam Camera holding the frame, e.g. after nextFrame()
+	//!
+	//! @return Return operation status
+	//!
+	//! @note The FIFO is cleared without reading when no viewer can take
+	//! the frame
+	//**********************************************
+	CamStatus broadcast(Arducam_Qwiic_CAM& cam);
+
+	//**********************************************
+	//!
+	//! @brief Get the counters of a viewer
+	//!
+	//! @param  slot Slot returned by add()
+	//!
+	//! @return Return the counters
+	//**********************************************
+	const CamViewerStats& getClientStats(uint8_t slot) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the frame rate a viewer received since it was added
+	//!
+	//! @param  slot Slot returned by add()
+	//!
+	//! @return Return the frames per second
+	//**********************************************
+	float getClientFps(uint8_t slot) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the number of frames read from the camera
+	//!
+	//! @return Return the frame count
+	//**********************************************
+	uint32_t getFramesRead() const;
+
+	//**********************************************
+	//!
+	//! @brief Add the frame sequence number and capture time to each part
+	//!
+	//! @param  enable Send X-Frame-Seq and X-Capture-Us, see getFrameInfo()
+	//**********************************************
+	void setFrameHeaders(bool enable);
+};
+
+#endif /*__ARDUCAM_QWIIC_BROADCASTER_H*/
@@ -0,0 +1,191 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_Bus.h"
+
+bool Arducam_Qwiic_Bus::startRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length)
+{
+    (void)addr;
+    (void)reg;
+    (void)buf;
+    (void)length;
+    return false;
+}
+
+bool Arducam_Qwiic_Bus::pollRead(size_t* received)
+{
+    *received = 0;
+    return true;
+}
+
+void Arducam_Qwiic_Bus::cancelRead(void)
+{
+}
+
+#if defined(ARDUINO)
+
+size_t Arducam_Qwiic_Bus::writeReadTo(uint8_t addr, uint8_t reg, Print& out, size_t length)
+{
+    uint8_t block[QWIIC_CAM_SINK_BLOCK_SIZE];
+    size_t total = 0;
+
+    while (total < length) {
+        size_t n = length - total;
+        if (n > sizeof(block)) {
+            n = sizeof(block);
+        }
+        size_t received = writeRead(addr, reg, block, n);
+        if (received == 0) {
+            break;
+        }
+        out.write(block, received);
+        total += received;
+    }
+    return total;
+}
+
+Arducam_Qwiic_WireBus::Arducam_Qwiic_WireBus(TwoWire& wire) : wire(wire)
+{
+    readLength = QWIIC_CAM_WIRE_BUFFER_SIZE;
+}
+
+bool Arducam_Qwiic_WireBus::begin(void)
+{
+    wire.begin();
+    return true;
+}
+
+void Arducam_Qwiic_WireBus::setClock(uint32_t hz)
+{
+    wire.setClock(hz);
+}
+
+bool Arducam_Qwiic_WireBus::write(uint8_t addr, const uint8_t* data, size_t length)
+{
+    wire.beginTransmission(addr);
+    wire.write(data, length);
+    return (wire.endTransmission() == 0);
+}
+
+size_t Arducam_Qwiic_WireBus::writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length)
+{
+    wire.beginTransmission(addr);
+    wire.write(reg);
+    wire.endTransmission(false);
+
+    size_t bytesReceived = wire.requestFrom(addr, length);
+    size_t count = 0;
+    while (wire.available() && count < bytesReceived) {
+        buf[count++] = wire.read();
+    }
+    return count;
+}
+
+size_t Arducam_Qwiic_WireBus::writeReadTo(uint8_t addr, uint8_t reg, Print& out, size_t length)
+{
+    wire.beginTransmission(addr);
+    wire.write(reg);
+    wire.endTransmission(false);
+
+    size_t bytesReceived = wire.requestFrom(addr, length);
+    uint8_t block[QWIIC_CAM_SINK_BLOCK_SIZE];
+    size_t count = 0;
+
+    while (count < bytesReceived && wire.available()) {
+        size_t n = 0;
+        while (n < sizeof(block) && count + n < bytesReceived && wire.available()) {
+            block[n++] = wire.read();
+        }
+        out.write(block, n);
+        count += n;
+    }
+    return count;
+}
+
+size_t Arducam_Qwiic_WireBus::maxReadLength(void) const
+{
+    return readLength;
+}
+
+void Arducam_Qwiic_WireBus::setMaxReadLength(size_t length)
+{
+    readLength = (length > 0) ? length : 1;
+}
+
+#else
+
+#include <chrono>
+#include <thread>
+
+// Host builds have no Arduino core, time comes from the installed clock
+class SystemClock : public Arducam_Qwiic_HostClock
+{
+public:
+    uint64_t nowUs(void)
+    {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void sleepUs(uint64_t us)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+};
+
+static SystemClock systemClock;
+static Arducam_Qwiic_HostClock* hostClock = &systemClock;
+
+void Arducam_Qwiic_HostClock::install(Arducam_Qwiic_HostClock* clock)
+{
+    hostClock = (clock != NULL) ? clock : &systemClock;
+}
+
+Arducam_Qwiic_VirtualClock::Arducam_Qwiic_VirtualClock(void)
+{
+    now = 0;
+}
+
+uint64_t Arducam_Qwiic_VirtualClock::nowUs(void)
+{
+    return now;
+}
+
+void Arducam_Qwiic_VirtualClock::sleepUs(uint64_t us)
+{
+    now += us;
+}
+
+unsigned long millis(void)
+{
+    return (unsigned long)(hostClock->nowUs() / 1000);
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long)hostClock->nowUs();
+}
+
+void delay(unsigned long ms)
+{
+    hostClock->sleepUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    hostClock->sleepUs(us);
+}
+
+void yield(void)
+{
+    std::this_thread::yield();
+}
+
+#endif
@@ -0,0 +1,264 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_BUS_H
+#define __ARDUCAM_QWIIC_BUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include <Wire.h>
+
+// Receive buffer of the Wire implementation, which caps a single requestFrom().
+// Define QWIIC_CAM_WIRE_BUFFER_SIZE before including the library to override
+// it, e.g. after enlarging the buffer with Wire.setBufferSize() on ESP32.
+#if !defined(QWIIC_CAM_WIRE_BUFFER_SIZE)
+#if defined(I2C_BUFFER_LENGTH)
+#define QWIIC_CAM_WIRE_BUFFER_SIZE I2C_BUFFER_LENGTH      // ESP32, Renesas
+#elif defined(WIRE_BUFFER_SIZE)
+#define QWIIC_CAM_WIRE_BUFFER_SIZE WIRE_BUFFER_SIZE       // RP2040
+#elif defined(BUFFER_LENGTH)
+#define QWIIC_CAM_WIRE_BUFFER_SIZE BUFFER_LENGTH          // AVR
+#else
+#define QWIIC_CAM_WIRE_BUFFER_SIZE 255
+#endif
+#endif
+
+#if !defined(QWIIC_CAM_SINK_BLOCK_SIZE)
+#define QWIIC_CAM_SINK_BLOCK_SIZE 64  // Stack block used when streaming to a Print
+#endif
+#else
+// Timing helpers of host builds, see Arducam_Qwiic_Bus.cpp
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+#endif
+
+/**
+* @file Arducam_Qwiic_Bus.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+/**
+* @brief I2C bus backend used by the camera driver
+*
+* A backend moves bytes between the host and a device address. The driver
+* only needs two transaction shapes: a plain write, and a register address
+* write followed by a read after a repeated start.
+*/
+class Arducam_Qwiic_Bus
+{
+public:
+	virtual ~Arducam_Qwiic_Bus(void) {}
+
+	//**********************************************
+	//!
+	//! @brief Initialize the bus
+	//!
+	//! @return Returns true if the bus is ready for use
+	//**********************************************
+	virtual bool begin(void) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Set the bus clock
+	//!
+	//! @param  hz Clock frequency in Hz
+	//**********************************************
+	virtual void setClock(uint32_t hz) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Write bytes to a device in a single transaction
+	//!
+	//! @param  addr 7-bit device address
+	//! @param  data Bytes to send
+	//! @param  length Number of bytes to send
+	//!
+	//! @return Returns true if the device acknowledged the transfer
+	//**********************************************
+	virtual bool write(uint8_t addr, const uint8_t* data, size_t length) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Send a register address, then read bytes after a repeated start
+	//!
+	//! @param  addr 7-bit device address
+	//! @param  reg Register address
+	//! @param  buf Buffer for the received bytes
+	//! @param  length Number of bytes to read
+	//!
+	//! @return Returns the number of bytes actually received
+	//**********************************************
+	virtual size_t writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Get the largest read a single writeRead() can complete
+	//!
+	//! @return Return the maximum read length in bytes
+	//**********************************************
+	virtual size_t maxReadLength(void) const = 0;
+
+	//**********************************************
+	//!
+	//! @brief Start a register read that completes in the background
+	//!
+	//! @param  addr 7-bit device address
+	//! @param  reg Register address
+	//! @param  buf Buffer for the received bytes, untouched until pollRead() reports completion
+	//! @param  length Number of bytes to read
+	//!
+	//! @return Returns false if the backend cannot read asynchronously, the
+	//! caller then uses writeRead()
+	//!
+	//! @note Backends with interrupt or DMA driven receive override
+	//! startRead(), pollRead() and cancelRead(). Only one read may be in flight.
+	//**********************************************
+	virtual bool startRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length);
+
+	//**********************************************
+	//!
+	//! @brief Check the read started with startRead()
+	//!
+	//! @param  received Set to the number of bytes received once complete
+	//!
+	//! @return Returns true once the read has completed or failed
+	//**********************************************
+	virtual bool pollRead(size_t* received);
+
+	//**********************************************
+	//!
+	//! @brief Abandon the read started with startRead()
+	//**********************************************
+	virtual void cancelRead(void);
+
+#if defined(ARDUINO)
+	//**********************************************
+	//!
+	//! @brief Send a register address, then stream the reply to a sink
+	//!
+	//! @param  addr 7-bit device address
+	//! @param  reg Register address
+	//! @param  out Destination of the received bytes
+	//! @param  length Number of bytes to read
+	//!
+	//! @return Returns the number of bytes actually received
+	//!
+	//! @note The default goes through writeRead() with a stack block per
+	//! transaction, backends with their own receive buffer should override it
+	//**********************************************
+	virtual size_t writeReadTo(uint8_t addr, uint8_t reg, Print& out, size_t length);
+#endif
+};
+
+#if defined(ARDUINO)
+/**
+* @brief Bus backend on top of an Arduino TwoWire instance
+*/
+class Arducam_Qwiic_WireBus : public Arducam_Qwiic_Bus
+{
+private:
+	TwoWire& wire;                                  /**< Wire instance the camera is attached to */
+	size_t readLength;                              /**< Receive buffer size of the Wire instance */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the Wire backend
+	//!
+	//! @param  wire Wire instance the camera is attached to
+	//**********************************************
+	explicit Arducam_Qwiic_WireBus(TwoWire& wire);
+
+	bool begin(void);
+	void setClock(uint32_t hz);
+	bool write(uint8_t addr, const uint8_t* data, size_t length);
+	size_t writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length);
+	size_t maxReadLength(void) const;
+	size_t writeReadTo(uint8_t addr, uint8_t reg, Print& out, size_t length);
+
+	//**********************************************
+	//!
+	//! @brief Set the receive buffer size of the Wire instance
+	//!
+	//! @param  length Receive buffer size in bytes
+	//!
+	//! @note Use this when the platform lets the buffer grow at runtime,
+	//! e.g. Wire.setBufferSize() on ESP32
+	//**********************************************
+	void setMaxReadLength(size_t length);
+};
+#else
+/**
+* @brief Time source of host builds
+*
+* millis(), micros(), delay() and delayMicroseconds() read the installed
+* clock. By default they follow the monotonic system clock. yield() hands
+* the CPU to other threads and leaves the clock alone.
+*/
+class Arducam_Qwiic_HostClock
+{
+public:
+	virtual ~Arducam_Qwiic_HostClock(void) {}
+
+	//**********************************************
+	//!
+	//! @brief Get the time
+	//!
+	//! @return Return the time in microseconds
+	//**********************************************
+	virtual uint64_t nowUs(void) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Let time pass
+	//!
+	//! @param  us Time in microseconds
+	//**********************************************
+	virtual void sleepUs(uint64_t us) = 0;
+
+	//**********************************************
+	//!
+	//! @brief Select the clock the timing helpers read
+	//!
+	//! @param  clock Clock to use, NULL for the system clock
+	//**********************************************
+	static void install(Arducam_Qwiic_HostClock* clock);
+};
+
+/**
+* @brief Simulated time for host runs
+*
+* Time only moves when somebody sleeps: the driver in delay(), or a
+* simulated device spending the duration of a transfer. Runs against
+* Arducam_Qwiic_SimBus then report the time the hardware would take,
+* independent of the host speed.
+*/
+class Arducam_Qwiic_VirtualClock : public Arducam_Qwiic_HostClock
+{
+private:
+	uint64_t now;                                   /**< Current time in microseconds */
+
+public:
+	Arducam_Qwiic_VirtualClock(void);
+
+	uint64_t nowUs(void);
+	void sleepUs(uint64_t us);
+};
+#endif
+
+#endif /*__ARDUCAM_QWIIC_BUS_H*/
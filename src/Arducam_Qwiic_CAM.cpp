@@ -9,199 +9,1702 @@
 */
 
 #include "Arducam_Qwiic_CAM.h"
+#include <string.h>
+
+#if defined(ARDUINO)
+static Arducam_Qwiic_WireBus defaultBus(QWIIC_WIRE);
+#endif
+
+#if QWIIC_CAM_ENABLE_STATS
+#define CAM_STATS(stmt) do { if (stats != NULL) { stmt; } } while (0)
+#else
+#define CAM_STATS(stmt) do { } while (0)
+#endif
+
+static uint8_t settingValue(const CameraSettings& settings, uint8_t field)
+{
+    switch (field) {
+    case CAM_SETTING_QUALITY:       return settings.quality;
+    case CAM_SETTING_BRIGHTNESS:    return settings.brightness;
+    case CAM_SETTING_CONTRAST:      return settings.contrast;
+    case CAM_SETTING_SATURATION:    return settings.saturation;
+    case CAM_SETTING_EV:            return settings.ev;
+    case CAM_SETTING_WHITE_BALANCE: return settings.whiteBalance;
+    case CAM_SETTING_COLOR_EFFECT:  return settings.colorEffect;
+    default:                        return settings.sharpness;
+    }
+}
+
+static void storeSettingValue(CameraSettings& settings, uint8_t field, uint8_t value)
+{
+    switch (field) {
+    case CAM_SETTING_QUALITY:       settings.quality = (IMAGE_QUALITY)value; break;
+    case CAM_SETTING_BRIGHTNESS:    settings.brightness = (CAM_BRIGHTNESS_LEVEL)value; break;
+    case CAM_SETTING_CONTRAST:      settings.contrast = (CAM_CONTRAST_LEVEL)value; break;
+    case CAM_SETTING_SATURATION:    settings.saturation = (CAM_SATURATION_LEVEL)value; break;
+    case CAM_SETTING_EV:            settings.ev = (CAM_EV_LEVEL)value; break;
+    case CAM_SETTING_WHITE_BALANCE: settings.whiteBalance = (CAM_WHITE_BALANCE)value; break;
+    case CAM_SETTING_COLOR_EFFECT:  settings.colorEffect = (CAM_COLOR_FX)value; break;
+    default:                        settings.sharpness = (CAM_SHARPNESS_LEVEL)value; break;
+    }
+}
+
+static uint8_t settingRegister(uint8_t field)
+{
+    switch (field) {
+    case CAM_SETTING_QUALITY:       return CAM_REG_IMAGE_QUALITY;
+    case CAM_SETTING_BRIGHTNESS:    return CAM_REG_BRIGHTNESS_CONTROL;
+    case CAM_SETTING_CONTRAST:      return CAM_REG_CONTRAST_CONTROL;
+    case CAM_SETTING_SATURATION:    return CAM_REG_SATURATION_CONTROL;
+    case CAM_SETTING_EV:            return CAM_REG_EV_CONTROL;
+    case CAM_SETTING_WHITE_BALANCE: return CAM_REG_WHITEBALANCE_MODE_CONTROL;
+    case CAM_SETTING_COLOR_EFFECT:  return CAM_REG_COLOR_EFFECT_CONTROL;
+    default:                        return CAM_REG_SHARPNESS_CONTROL;
+    }
+}
+
+static bool isShadowReg(uint8_t reg)
+{
+    return (reg >= CAM_SHADOW_REG_BASE && reg < CAM_SHADOW_REG_BASE + CAM_SHADOW_REG_COUNT);
+}
+
+static uint32_t shadowBit(uint8_t reg)
+{
+    return ((uint32_t)1 << (reg - CAM_SHADOW_REG_BASE));
+}
+
+// Clocks tried by begin(maxClock), from QWIIC_CAM_I2C_SPEED upward
+static const uint32_t clockSteps[] = {QWIIC_CAM_I2C_SPEED, 600000, 800000, 1000000};
+#define CLOCK_STEP_COUNT (sizeof(clockSteps) / sizeof(clockSteps[0]))
+
+static bool isIdReg(uint8_t reg)
+{
+    return (reg >= CAM_REG_SENSOR_ID && reg <= CAM_REG_DAY_ID);
+}
+
+#define CAM_JPEG_STEP_DROP 0 // Byte is not part of the image
+#define CAM_JPEG_STEP_KEEP 1 // Byte is part of the image
+#define CAM_JPEG_STEP_SOI  2 // Byte completes the SOI, the image starts with FF D8
+
+// Phase that follows the payload of the current marker segment
+static uint8_t jpegAfterSegment(const CamJpegScan* scan)
+{
+    return (scan->marker == 0xDA) ? CAM_JPEG_ENTROPY : CAM_JPEG_HEADER;
+}
+
+// Act on the marker following a 0xFF
+static void jpegMarker(CamJpegScan* scan, uint8_t marker)
+{
+    if (marker == 0xD9) {
+        scan->phase = CAM_JPEG_ENDED;
+    } else if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+        // TEM, RSTn and SOI carry no length
+        scan->phase = CAM_JPEG_HEADER;
+    } else {
+        scan->marker = marker;
+        scan->phase = CAM_JPEG_LENGTH_HI;
+    }
+}
+
+// Feed one byte of JPEG data to the scan. Segment payloads are skipped by
+// their length, so markers inside them (the SOI and EOI of an EXIF
+// thumbnail) do not count.
+static uint8_t jpegStep(CamJpegScan* scan, uint8_t data)
+{
+    switch (scan->phase) {
+    case CAM_JPEG_SEEK_SOI:
+        if (scan->prevFF && data == 0xD8) {
+            scan->prevFF = false;
+            scan->phase = CAM_JPEG_HEADER;
+            return CAM_JPEG_STEP_SOI;
+        }
+        scan->prevFF = (data == 0xFF);
+        return CAM_JPEG_STEP_DROP;
+    case CAM_JPEG_LENGTH_HI:
+        scan->skip = (uint16_t)(data << 8);
+        scan->phase = CAM_JPEG_LENGTH_LO;
+        return CAM_JPEG_STEP_KEEP;
+    case CAM_JPEG_LENGTH_LO:
+        // The length counts its own two bytes
+        scan->skip |= data;
+        scan->skip = (scan->skip > 2) ? scan->skip - 2 : 0;
+        scan->phase = (scan->skip > 0) ? (uint8_t)CAM_JPEG_SKIP : jpegAfterSegment(scan);
+        return CAM_JPEG_STEP_KEEP;
+    case CAM_JPEG_SKIP:
+        if (--scan->skip == 0) {
+            scan->phase = jpegAfterSegment(scan);
+        }
+        return CAM_JPEG_STEP_KEEP;
+    case CAM_JPEG_ENDED:
+        return CAM_JPEG_STEP_DROP;
+    default:
+        if (scan->prevFF && data != 0xFF) {
+            scan->prevFF = false;
+            // Stuffed bytes and restart markers stay in the entropy data
+            bool entropy = (scan->phase == CAM_JPEG_ENTROPY);
+            if (!entropy || (data != 0x00 && (data < 0xD0 || data > 0xD7))) {
+                jpegMarker(scan, data);
+            }
+        } else {
+            scan->prevFF = (data == 0xFF);
+        }
+        return CAM_JPEG_STEP_KEEP;
+    }
+}
+
+// Scan image data past the SOI. Returns the number of bytes that belong to
+// the image, up to and including the EOI.
+static size_t jpegRun(CamJpegScan* scan, const uint8_t* data, size_t length)
+{
+    size_t i = 0;
+    while (i < length && scan->phase != CAM_JPEG_ENDED) {
+        if (scan->phase == CAM_JPEG_SKIP) {
+            size_t n = length - i;
+            if (n > scan->skip) {
+                n = scan->skip;
+            }
+            scan->skip -= (uint16_t)n;
+            i += n;
+            if (scan->skip == 0) {
+                scan->phase = jpegAfterSegment(scan);
+            }
+            continue;
+        }
+        if (scan->phase == CAM_JPEG_ENTROPY && !scan->prevFF) {
+            // Entropy data holds markers only behind a 0xFF
+            const uint8_t* ff = (const uint8_t*)memchr(data + i, 0xFF, length - i);
+            if (ff == NULL) {
+                return length;
+            }
+            i = ff - data;
+        }
+        jpegStep(scan, data[i++]);
+    }
+    return i;
+}
+
+// Drop the bytes in front of the SOI and behind the EOI, moving the image
+// bytes to the front. Returns the number of bytes kept. A 0xFF carried from
+// the last chunk in front of the SOI must be put back in front of the data.
+static size_t jpegTrimChunk(CamJpegScan* scan, uint8_t* data, size_t length)
+{
+    size_t i = 0;
+    size_t out = 0;
+    while (i < length && scan->phase == CAM_JPEG_SEEK_SOI) {
+        if (jpegStep(scan, data[i++]) == CAM_JPEG_STEP_SOI) {
+            data[out++] = 0xFF;
+            data[out++] = 0xD8;
+        }
+    }
+    size_t keep = jpegRun(scan, data + i, length - i);
+    if (out != i) {
+        memmove(data + out, data + i, keep);
+    }
+    return out + keep;
+}
 
 Arducam_Qwiic_CAM::Arducam_Qwiic_CAM(void)
+{
+#if defined(ARDUINO)
+    initState(&defaultBus);
+#else
+    initState(NULL);
+#endif
+}
+
+Arducam_Qwiic_CAM::Arducam_Qwiic_CAM(Arducam_Qwiic_Bus& bus)
+{
+    initState(&bus);
+}
+
+void Arducam_Qwiic_CAM::initState(Arducam_Qwiic_Bus* bus)
 {
     totalLength = 0;
     unreceivedLength = 0;
     cameraId = 0;
     burstFirstFlag = 0;
     previewMode = 0;
-    currentPixelFormat = CAM_IMAGE_PIX_FMT_NONE;
-    currentPictureMode = CAM_IMAGE_MODE_NONE;
     deviceAddress = QWIIC_CAM_I2C_ADDRESS;
+    burstSize = 0;
+    this->bus = bus;
+    invalidateShadow();
+    shadowRestore = 0;
+    standbyActive = false;
+    discarding = false;
+    startupPending = true;
+    startupStartUs = micros();
+    startupLatencyUs = 0;
+    idCacheMask = 0;
+    captureState = CAM_CAPTURE_IDLE;
+    captureError = CAM_ERR_NONE;
+    captureMode = CAM_IMAGE_MODE_NONE;
+    captureFormat = CAM_IMAGE_PIX_FMT_NONE;
+    idlePending = false;
+    stepStartMs = 0;
+    triggerMs = 0;
+    nextPollMs = 0;
+    pollIntervalMs = 1;
+    adaptivePolling = true;
+    learnLatency = false;
+    resetLatencyModel();
+    capturePolicy = CAM_POLICY_NONE;
+    captureAttempts = QWIIC_CAM_CAPTURE_ATTEMPTS;
+    warmupPending = true;
+    reconfigPending = false;
+    sensorFormat = CAM_IMAGE_PIX_FMT_NONE;
+    resetPolicyCounters();
+    frameReadyCallback = NULL;
+    frameReadyArg = NULL;
+    videoActive = false;
+    videoHold = false;
+    videoMode = CAM_VIDEO_MODE_0;
+    frameSeq = 0;
+    imageLength = 0;
+    triggerUs = 0;
+    captureSeq = 0;
+    memset(&frameInfo, 0, sizeof(frameInfo));
+    busClock = QWIIC_CAM_I2C_SPEED;
+    busErrorRun = 0;
+    clockFallbacks = 0;
+    stats = NULL;
+    jpegTrim = false;
+    memset(&jpegScan, 0, sizeof(jpegScan));
+    burstFrames = 0;
+    burstIndex = 0;
+    burstFormat = CAM_IMAGE_PIX_FMT_NONE;
+    burstBufLen = 0;
+    burstBufPos = 0;
+    asyncBuf = NULL;
+    asyncLead = 0;
+    asyncLength = 0;
+    asyncReceived = 0;
+    asyncStartMs = 0;
+    asyncPending = false;
+    asyncInFlight = false;
+}
+
+CamStatus Arducam_Qwiic_CAM::reset(void)
+{
+    // The reset ends whatever was running, before the shadow is put aside
+    // for restoreSettings(). A failed stopVideo() must not keep the reset
+    // from recovering the sensor.
+    cancelImageBufAsync();
+    stopVideo();
+    videoHold = false;
+    captureState = CAM_CAPTURE_IDLE;
+    idlePending = false;
+    discarding = false;
+
+    unsigned long startUs = micros();
+    CAM_RETURN_IF_ERR(writeReg(CAM_REG_SENSOR_RESET, CAM_SENSOR_RESET_ENABLE)); 
+    CAM_RETURN_IF_ERR(waitI2cIdle());
+    startupStartUs = startUs;
+    startupPending = true;
+    startupLatencyUs = 0;
+    return CAM_ERR_NONE;
+}
+
+CamStatus Arducam_Qwiic_CAM::standby(void)
+{
+    if (videoActive || (captureState >= CAM_CAPTURE_CONFIG && captureState <= CAM_CAPTURE_WAITING)) {
+        return CAM_ERR_BUSY;
+    }
+    CAM_RETURN_IF_ERR(writeReg(CAM_REG_POWER_CONTROL, CAM_POWER_STANDBY));
+    CAM_RETURN_IF_ERR(waitI2cIdle());
+
+    // The sensor may come back with its defaults, keep the values for wake()
+    shadowRestore |= shadowValid | shadowPending | shadowDirty;
+    invalidateShadow();
+    standbyActive = true;
+    return CAM_ERR_NONE;
+}
+
+CamStatus Arducam_Qwiic_CAM::wake(bool restore)
+{
+    unsigned long startUs = micros();
+    CAM_RETURN_IF_ERR(writeReg(CAM_REG_POWER_CONTROL, CAM_POWER_NORMAL));
+    CAM_RETURN_IF_ERR(waitI2cIdle());
+    standbyActive = false;
+    warmupPending = true;
+    sensorFormat = CAM_IMAGE_PIX_FMT_NONE;
+    startupStartUs = startUs;
+    startupPending = true;
+    startupLatencyUs = 0;
+    return restore ? restoreSettings() : CAM_ERR_NONE;
+}
+
+bool Arducam_Qwiic_CAM::isStandby() const
+{
+    return standbyActive;
+}
+
+CamStatus Arducam_Qwiic_CAM::restoreSettings(void)
+{
+    // Format and resolution are written by every capture, a stale video
+    // resolution would restart the stream
+    uint32_t mode = shadowBit(CAM_REG_FORMAT) | shadowBit(CAM_REG_CAPTURE_RESOLUTION);
+    shadowDirty |= shadowRestore & ~mode;
+    shadowRestore = 0;
+    return flushRegs();
+}
+
+unsigned long Arducam_Qwiic_CAM::getStartupLatencyUs() const
+{
+    return startupLatencyUs;
+}
+
+CamStatus Arducam_Qwiic_CAM::begin(void)
+{
+    if (bus == NULL || !bus->begin()) {
+        return CAM_ERR_NO_CALLBACK;
+    }
+    bus->setClock(QWIIC_CAM_I2C_SPEED); // Set I2C clock speed
+    busClock = QWIIC_CAM_I2C_SPEED;
+    busErrorRun = 0;
+    return CAM_ERR_NONE;
+}
+
+CamStatus Arducam_Qwiic_CAM::begin(uint32_t maxClock)
+{
+    CAM_RETURN_IF_ERR(begin());
+
+    // Reference values come from the base clock, which is known to work
+    uint8_t ids[CAM_ID_REG_COUNT];
+    for (uint8_t i = 0; i < CAM_ID_REG_COUNT; i++) {
+        if (busWriteRead(CAM_REG_SENSOR_ID + i, &ids[i], 1) != 1) {
+            return CAM_ERR_NO_CALLBACK;
+        }
+    }
+    if (!verifyLink(ids)) {
+        return CAM_ERR_NO_CALLBACK;
+    }
+
+    uint32_t best = QWIIC_CAM_I2C_SPEED;
+    for (uint8_t i = 1; i < CLOCK_STEP_COUNT; i++) {
+        if (clockSteps[i] > maxClock || clockSteps[i] > QWIIC_CAM_I2C_MAX_SPEED) {
+            break;
+        }
+        bus->setClock(clockSteps[i]);
+        if (!verifyLink(ids)) {
+            break;
+        }
+        best = clockSteps[i];
+    }
+
+    bus->setClock(best);
+    busClock = best;
+    busErrorRun = 0;
+    return CAM_ERR_NONE;
+}
+
+bool Arducam_Qwiic_CAM::verifyLink(const uint8_t* ids)
+{
+    static const uint8_t patterns[] = {0x55, 0xAA, 0x00, 0xFF, 0x69, 0x96};
+    for (uint8_t round = 0; round < QWIIC_CAM_CLOCK_VERIFY_ROUNDS; round++) {
+        for (uint8_t i = 0; i < sizeof(patterns); i++) {
+            uint8_t packet[2] = {ARDUCHIP_TEST1, patterns[i]};
+            uint8_t data = 0;
+            if (!bus->write(deviceAddress, packet, sizeof(packet)) ||
+                bus->writeRead(deviceAddress, ARDUCHIP_TEST1, &data, 1) != 1 || data != patterns[i]) {
+                return false;
+            }
+        }
+        for (uint8_t i = 0; i < CAM_ID_REG_COUNT; i++) {
+            uint8_t data = 0;
+            if (bus->writeRead(deviceAddress, CAM_REG_SENSOR_ID + i, &data, 1) != 1 || data != ids[i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void Arducam_Qwiic_CAM::noteBusResult(bool ok)
+{
+    if (ok) {
+        busErrorRun = 0;
+        return;
+    }
+    if (++busErrorRun < QWIIC_CAM_CLOCK_ERROR_LIMIT || busClock <= QWIIC_CAM_I2C_SPEED) {
+        return;
+    }
+
+    // Step down to the next slower clock
+    uint32_t lower = QWIIC_CAM_I2C_SPEED;
+    for (uint8_t i = 0; i < CLOCK_STEP_COUNT; i++) {
+        if (clockSteps[i] < busClock && clockSteps[i] > lower) {
+            lower = clockSteps[i];
+        }
+    }
+    busClock = lower;
+    bus->setClock(lower);
+    busErrorRun = 0;
+    clockFallbacks++;
+}
+
+uint32_t Arducam_Qwiic_CAM::getBusClock() const
+{
+    return busClock;
+}
+
+uint16_t Arducam_Qwiic_CAM::getClockFallbacks() const
+{
+    return clockFallbacks;
+}
+
+CamStatus Arducam_Qwiic_CAM::takePicture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format)
+{
+    if ((capturePolicy & CAM_POLICY_WARMUP) && warmupPending) {
+        // First frame after power-up or reset is not usable, it also
+        // loads the new pixel format
+        CAM_RETURN_IF_ERR(discardCapture(mode, pixel_format));
+        policyCounters.warmupFrames++;
+    }
+    // After a sensor reset the format is not known to be loaded even
+    // once the warm-up frame has run
+    if ((capturePolicy & CAM_POLICY_RECONFIG) &&
+        (reconfigPending || (sensorFormat != CAM_IMAGE_PIX_FMT_NONE && sensorFormat != pixel_format))) {
+        CAM_RETURN_IF_ERR(discardCapture(CAM_RECONFIG_MODE, pixel_format));
+        policyCounters.reconfigFrames++;
+    }
+    warmupPending = false;
+    reconfigPending = false;
+
+    uint8_t attempts = (capturePolicy & CAM_POLICY_RETRY) ? captureAttempts : 1;
+    CamStatus ret = CAM_ERR_NONE;
+    for (uint8_t i = 0; i < attempts; i++) {
+        if (i > 0) {
+            policyCounters.retries++;
+            CAM_RETURN_IF_ERR(waitI2cIdle());
+        }
+        ret = startCapture(mode, pixel_format);
+        if (ret == CAM_ERR_BUSY) {
+            return ret;
+        }
+        if (ret == CAM_ERR_NONE) {
+            ret = waitCapture();
+        }
+        if (ret == CAM_ERR_NONE && totalLength > 0) {
+            break;
+        }
+    }
+    return ret;
+}
+
+CamStatus Arducam_Qwiic_CAM::discardCapture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format)
+{
+    CAM_RETURN_IF_ERR(startCapture(mode, pixel_format));
+    learnLatency = false;
+    discarding = true;
+    CamStatus ret = waitCapture();
+    discarding = false;
+    CAM_RETURN_IF_ERR(ret);
+    return clearFIFO();
+}
+
+void Arducam_Qwiic_CAM::setCapturePolicy(uint8_t policy, uint8_t attempts)
+{
+    capturePolicy = policy;
+    captureAttempts = (attempts == 0) ? 1 : attempts;
+}
+
+uint8_t Arducam_Qwiic_CAM::getCapturePolicy() const
+{
+    return capturePolicy;
+}
+
+void Arducam_Qwiic_CAM::requestWarmup(void)
+{
+    warmupPending = true;
+}
+
+const CamPolicyCounters& Arducam_Qwiic_CAM::getPolicyCounters() const
+{
+    return policyCounters;
+}
+
+void Arducam_Qwiic_CAM::resetPolicyCounters(void)
+{
+    memset(&policyCounters, 0, sizeof(policyCounters));
+}
+
+CamStatus Arducam_Qwiic_CAM::waitCapture(void)
+{
+    while (true) {
+        CAM_CAPTURE_STATE state = poll();
+        if (state == CAM_CAPTURE_READY) {
+            return CAM_ERR_NONE;
+        }
+        if (state == CAM_CAPTURE_ERROR) {
+            return (CamStatus)captureError;
+        }
+        delay(getNextPollDelay());
+    }
+}
+
+CamStatus Arducam_Qwiic_CAM::startCapture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format)
+{
+    if (standbyActive || videoActive || (captureState >= CAM_CAPTURE_CONFIG && captureState <= CAM_CAPTURE_WAITING)) {
+        return CAM_ERR_BUSY;
+    }
+
+    cancelImageBufAsync();
+    captureMode = mode;
+    captureFormat = pixel_format;
+    captureError = CAM_ERR_NONE;
+    captureState = CAM_CAPTURE_CONFIG;
+    idlePending = false;
+    unreceivedLength = 0;
+    burstFirstFlag = 0;
+    burstFrames = 0;
+    learnLatency = true;
+    stepStartMs = millis();
+    nextPollMs = stepStartMs;
+    return CAM_ERR_NONE;
+}
+
+bool Arducam_Qwiic_CAM::issueCaptureStep(uint8_t reg, uint8_t value)
+{
+    if (writeReg(reg, value) != CAM_ERR_NONE) {
+        failCapture(CAM_ERR_NO_CALLBACK);
+        return false;
+    }
+    idlePending = true;
+    stepStartMs = millis();
+    nextPollMs = stepStartMs;
+    pollIntervalMs = 1;
+    return true;
+}
+
+void Arducam_Qwiic_CAM::backoffPoll(uint8_t maxInterval)
+{
+    nextPollMs = millis() + pollIntervalMs;
+    if (adaptivePolling && pollIntervalMs < maxInterval) {
+        pollIntervalMs = (pollIntervalMs * 2 > maxInterval) ? maxInterval : pollIntervalMs * 2;
+    }
+}
+
+void Arducam_Qwiic_CAM::failCapture(CamStatus err)
+{
+    // Writes not seen through to idle stay unknown
+    shadowPending = 0;
+    captureError = err;
+    captureState = CAM_CAPTURE_ERROR;
+    idlePending = false;
+}
+
+CAM_CAPTURE_STATE Arducam_Qwiic_CAM::poll(void)
+{
+    while (captureState >= CAM_CAPTURE_CONFIG && captureState <= CAM_CAPTURE_WAITING) {
+        if ((idlePending || captureState == CAM_CAPTURE_WAITING) && getNextPollDelay() != 0) {
+            break;
+        }
+
+        if (idlePending) {
+            CAM_STATS(stats->idlePolls++);
+            if (!getBit(CAM_REG_SENSOR_STATE, CAM_REG_SENSOR_STATE_IDLE)) {
+                if (millis() - stepStartMs >= CAM_TIMEOUT_MS) {
+                    CAM_STATS(stats->idleTimeouts++);
+                    failCapture(CAM_ERR_TIMEOUT);
+                } else {
+                    backoffPoll(QWIIC_CAM_IDLE_MAX_INTERVAL_MS);
+                }
+                break;
+            }
+            idlePending = false;
+            commitShadow();
+            stepStartMs = millis();
+            if (captureState == CAM_CAPTURE_WAITING) {
+                // Sleep until shortly before the expected completion
+                uint16_t* expected = learnLatency ? latencyEntry(captureMode, captureFormat) : NULL;
+                nextPollMs = stepStartMs;
+                if (adaptivePolling && expected != NULL && *expected != 0) {
+                    unsigned long lead = triggerMs + *expected - (*expected >> 3) - 1;
+                    if ((long)(lead - stepStartMs) > 0) {
+                        nextPollMs = lead;
+                    }
+                }
+                pollIntervalMs = 1;
+                continue;
+            }
+        }
+
+        switch (captureState) {
+        case CAM_CAPTURE_CONFIG:
+            stageReg(CAM_REG_FORMAT, captureFormat);
+            stageReg(CAM_REG_CAPTURE_RESOLUTION, CAM_SET_CAPTURE_MODE | captureMode);
+            if (shadowDirty & shadowBit(CAM_REG_FORMAT)) {
+                issueCaptureStep(CAM_REG_FORMAT, captureFormat);
+            } else if (shadowDirty & shadowBit(CAM_REG_CAPTURE_RESOLUTION)) {
+                issueCaptureStep(CAM_REG_CAPTURE_RESOLUTION, CAM_SET_CAPTURE_MODE | captureMode);
+            } else {
+                captureState = CAM_CAPTURE_CLEAR;
+            }
+            break;
+
+        case CAM_CAPTURE_CLEAR:
+            if (issueCaptureStep(ARDUCHIP_FIFO, FIFO_CLEAR_ID_MASK)) { // Clear FIFO
+                captureState = CAM_CAPTURE_START;
+            }
+            break;
+
+        case CAM_CAPTURE_START:
+            if (issueCaptureStep(ARDUCHIP_FIFO, FIFO_START_MASK)) { // Start capture
+                triggerMs = stepStartMs;
+                triggerUs = micros();
+                // Known before the frame is, see Arducam_Qwiic_CameraGroup
+                frameInfo.triggerUs = triggerUs;
+                captureState = CAM_CAPTURE_WAITING;
+            }
+            break;
+
+        default: // CAM_CAPTURE_WAITING
+            if (videoHold) {
+                // The frame armed by the last drain is taken by nextFrame()
+                return (CAM_CAPTURE_STATE)captureState;
+            }
+            CAM_STATS(stats->donePolls++);
+            if (!getBit(ARDUCHIP_TRIG, CAP_DONE_MASK)) {
+                if (millis() - stepStartMs >= CAM_TIMEOUT_MS) {
+                    CAM_STATS(stats->captureTimeouts++);
+                    failCapture(CAM_ERR_TIMEOUT);
+                } else {
+                    backoffPoll(QWIIC_CAM_POLL_MAX_INTERVAL_MS);
+                }
+                return (CAM_CAPTURE_STATE)captureState;
+            }
+            frameInfo.doneUs = micros();
+            CAM_STATS(recordCaptureLatency(frameInfo.doneUs - triggerUs));
+            if (learnLatency) {
+                uint16_t* expected = latencyEntry(captureMode, captureFormat);
+                unsigned long sample = millis() - triggerMs;
+                if (expected != NULL) {
+                    if (sample > 0xffff) {
+                        sample = 0xffff;
+                    }
+                    if (*expected == 0) {
+                        *expected = (uint16_t)sample;
+                    } else {
+                        long delta = (long)sample - (long)*expected;
+                        *expected = (uint16_t)((long)*expected + delta / (1 << CAM_LATENCY_WEIGHT_SHIFT));
+                    }
+                }
+            }
+            sensorFormat = captureFormat;
+            totalLength = ((readReg(FIFO_SIZE3) << 16) | (readReg(FIFO_SIZE2) << 8) | readReg(FIFO_SIZE1));
+            unreceivedLength = totalLength;
+            burstFirstFlag = 0;
+            imageLength = 0;
+            memset(&jpegScan, 0, sizeof(jpegScan));
+            frameInfo.seq = ++captureSeq;
+            frameInfo.triggerUs = triggerUs;
+            frameInfo.drainStartUs = 0;
+            frameInfo.drainEndUs = 0;
+            frameInfo.length = totalLength;
+            frameInfo.imageLength = 0;
+            frameInfo.mode = videoActive ? videoMode : captureMode;
+            frameInfo.format = captureFormat;
+            frameInfo.video = videoActive;
+            frameInfo.settingsMask = getAppliedMask();
+            frameInfo.settings = getAppliedSettings();
+            captureState = CAM_CAPTURE_READY;
+            if (startupPending && !discarding) {
+                startupLatencyUs = micros() - startupStartUs;
+                startupPending = false;
+            }
+            if (frameReadyCallback != NULL) {
+                frameReadyCallback(*this, frameReadyArg);
+            }
+            break;
+        }
+    }
+    return (CAM_CAPTURE_STATE)captureState;
+}
+
+CAM_CAPTURE_STATE Arducam_Qwiic_CAM::getCaptureState() const
+{
+    return (CAM_CAPTURE_STATE)captureState;
+}
+
+CamStatus Arducam_Qwiic_CAM::getCaptureError() const
+{
+    return (CamStatus)captureError;
+}
+
+unsigned long Arducam_Qwiic_CAM::getNextPollDelay() const
+{
+    if (captureState < CAM_CAPTURE_CONFIG || captureState > CAM_CAPTURE_WAITING) {
+        return 0;
+    }
+    long remaining = (long)(nextPollMs - millis());
+    return (remaining > 0) ? (unsigned long)remaining : 0;
+}
+
+void Arducam_Qwiic_CAM::setAdaptivePolling(bool enable)
+{
+    adaptivePolling = enable;
+    pollIntervalMs = 1;
+}
+
+bool Arducam_Qwiic_CAM::getAdaptivePolling() const
+{
+    return adaptivePolling;
+}
+
+uint16_t* Arducam_Qwiic_CAM::latencyEntry(uint8_t mode, uint8_t pixel_format)
+{
+    if (mode < 1 || mode > CAM_LATENCY_MODE_COUNT ||
+        pixel_format < 1 || pixel_format > CAM_LATENCY_FORMAT_COUNT) {
+        return NULL;
+    }
+    return &latencyModel[mode - 1][pixel_format - 1];
+}
+
+uint16_t Arducam_Qwiic_CAM::getLatencyEstimate(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format) const
+{
+    if (mode < 1 || mode > CAM_LATENCY_MODE_COUNT ||
+        pixel_format < 1 || pixel_format > CAM_LATENCY_FORMAT_COUNT) {
+        return 0;
+    }
+    return latencyModel[mode - 1][pixel_format - 1];
+}
+
+void Arducam_Qwiic_CAM::setLatencyEstimate(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format, uint16_t ms)
+{
+    uint16_t* entry = latencyEntry(mode, pixel_format);
+    if (entry != NULL) {
+        *entry = ms;
+    }
+}
+
+void Arducam_Qwiic_CAM::resetLatencyModel(void)
+{
+    memset(latencyModel, 0, sizeof(latencyModel));
+}
+
+bool Arducam_Qwiic_CAM::isFrameReady() const
+{
+    return (captureState == CAM_CAPTURE_READY);
+}
+
+void Arducam_Qwiic_CAM::setFrameReadyCallback(CamFrameReadyCallback callback, void* arg)
+{
+    frameReadyCallback = callback;
+    frameReadyArg = arg;
+}
+
+CamStatus Arducam_Qwiic_CAM::startVideo(CAM_VIDEO_MODE mode)
+{
+    if (standbyActive) {
+        return CAM_ERR_BUSY;
+    }
+    if (captureState >= CAM_CAPTURE_CONFIG && captureState <= CAM_CAPTURE_WAITING) {
+        return CAM_ERR_BUSY;
+    }
+
+    CAM_RETURN_IF_ERR(writeControlReg(CAM_REG_FORMAT, CAM_IMAGE_PIX_FMT_JPG));
+    CAM_RETURN_IF_ERR(writeControlReg(CAM_REG_CAPTURE_RESOLUTION, CAM_SET_VIDEO_MODE | mode));
+
+    videoActive = true;
+    videoMode = mode;
+    frameSeq = 0;
+    captureFormat = CAM_IMAGE_PIX_FMT_JPG;
+    burstFrames = 0;
+    armVideoFrame();
+    videoHold = true;
+    poll();
+    return CAM_ERR_NONE;
+}
+
+void Arducam_Qwiic_CAM::armVideoFrame(void)
+{
+    // Format and resolution are already set, start from the FIFO clear.
+    // The rest stays per frame in video mode too: the ArduChip FIFO holds
+    // one frame and only latches a new one after FIFO_START_MASK, CAP_DONE
+    // stays set until FIFO_CLEAR_ID_MASK, and CAP_DONE and FIFO_SIZE1..3
+    // are the only completion and length signals the module has.
+    captureError = CAM_ERR_NONE;
+    captureState = CAM_CAPTURE_CLEAR;
+    idlePending = false;
+    unreceivedLength = 0;
+    burstFirstFlag = 0;
+    learnLatency = false; // Video frames complete at the sensor frame rate
+    stepStartMs = millis();
+    nextPollMs = stepStartMs;
+}
+
+CamStatus Arducam_Qwiic_CAM::nextFrame(uint32_t* seq)
+{
+    if (!videoActive) {
+        return CAM_ERR_NO_CALLBACK;
+    }
+
+    if (captureState == CAM_CAPTURE_READY || captureState == CAM_CAPTURE_DRAINING) {
+        // Previous frame was not read out, drop it
+        CAM_RETURN_IF_ERR(clearFIFO());
+    }
+    if (captureState == CAM_CAPTURE_IDLE || captureState == CAM_CAPTURE_ERROR) {
+        armVideoFrame();
+    }
+
+    videoHold = false;
+    CAM_RETURN_IF_ERR(waitCapture());
+
+    frameSeq++;
+    if (seq != NULL) {
+        *seq = frameSeq;
+    }
+    return CAM_ERR_NONE;
+}
+
+CamStatus Arducam_Qwiic_CAM::stopVideo(void)
+{
+    if (!videoActive) {
+        return CAM_ERR_NONE;
+    }
+
+    videoActive = false;
+    videoHold = false;
+    captureState = CAM_CAPTURE_IDLE;
+    idlePending = false;
+    CAM_RETURN_IF_ERR(clearFIFO());
+    // Leave the sensor in the still mode of the same size
+    uint8_t mode = (videoMode == CAM_VIDEO_MODE_1) ? CAM_IMAGE_MODE_VGA : CAM_IMAGE_MODE_QVGA;
+    CAM_RETURN_IF_ERR(writeControlReg(CAM_REG_CAPTURE_RESOLUTION, CAM_SET_CAPTURE_MODE | mode));
+    return CAM_ERR_NONE;
+}
+
+bool Arducam_Qwiic_CAM::isVideoActive() const
+{
+    return videoActive;
+}
+
+uint32_t Arducam_Qwiic_CAM::getFrameSequence() const
+{
+    return frameSeq;
+}
+
+const CamFrameInfo& Arducam_Qwiic_CAM::getFrameInfo() const
+{
+    return frameInfo;
+}
+
+CamStatus Arducam_Qwiic_CAM::takeBurst(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format, uint8_t frames)
+{
+    if (frames == 0) {
+        frames = 1;
+    }
+
+    uint16_t width = 0;
+    uint16_t height = 0;
+    if (!getModeSize(mode, &width, &height)) {
+        return CAM_ERR_INVALID;
+    }
+    // Checked before ARDUCHIP_FRAMES is touched, startCapture() would only
+    // find out after the frame count of a running capture was changed
+    if (standbyActive || videoActive || (captureState >= CAM_CAPTURE_CONFIG && captureState <= CAM_CAPTURE_WAITING)) {
+        return CAM_ERR_BUSY;
+    }
+    uint8_t bytesPerPixel = (pixel_format == CAM_IMAGE_PIX_FMT_RGB565) ? 2 : 1;
+    burstRawSize = (uint32_t)width * height * bytesPerPixel;
+
+    // ARDUCHIP_FRAMES holds the number of frames after the first one
+    CAM_RETURN_IF_ERR(writeReg(ARDUCHIP_FRAMES, frames - 1));
+    CAM_RETURN_IF_ERR(waitI2cIdle());
+    CamStatus ret = startCapture(mode, pixel_format);
+    if (ret == CAM_ERR_NONE) {
+        learnLatency = false; // Completion time covers all frames
+        ret = waitCapture();
+    }
+    CAM_RETURN_IF_ERR(writeReg(ARDUCHIP_FRAMES, 0));
+    CAM_RETURN_IF_ERR(waitI2cIdle());
+    CAM_RETURN_IF_ERR(ret);
+
+    burstFrames = frames;
+    burstIndex = 0;
+    burstFormat = pixel_format;
+    burstBufLen = 0;
+    burstBufPos = 0;
+    burstFrameEnded = true;
+    burstFrameLength = 0;
+    return CAM_ERR_NONE;
+}
+
+bool Arducam_Qwiic_CAM::nextBurstFrame(void)
+{
+    if (burstIndex > 0 && !burstFrameEnded) {
+        uint8_t skip[32];
+        while (readBurstFrame(skip, sizeof(skip)) > 0) {
+        }
+    }
+
+    bool dataLeft = (burstBufPos < burstBufLen) || (unreceivedLength > 0);
+    if (burstIndex >= burstFrames || !dataLeft) {
+        if (unreceivedLength > 0) {
+            clearFIFO();
+        }
+        burstBufLen = 0;
+        burstBufPos = 0;
+        burstFrames = 0;
+        return false;
+    }
+
+    burstIndex++;
+    burstFrameEnded = false;
+    burstFrameLength = 0;
+    memset(&jpegScan, 0, sizeof(jpegScan));
+    burstSoiPending = 0;
+    return true;
+}
+
+size_t Arducam_Qwiic_CAM::readBurstFrame(uint8_t* buf, size_t length)
+{
+    if (burstIndex == 0 || buf == NULL) {
+        return 0;
+    }
+
+    bool jpeg = (burstFormat == CAM_IMAGE_PIX_FMT_JPG);
+    size_t count = 0;
+
+    while (count < length && !burstFrameEnded) {
+        // SOI markers found while skipping padding are handed out first
+        if (burstSoiPending > 0) {
+            buf[count++] = (burstSoiPending == 2) ? 0xFF : 0xD8;
+            burstSoiPending--;
+            burstFrameLength++;
+            continue;
+        }
+
+        if (burstBufPos >= burstBufLen) {
+            burstBufPos = 0;
+            burstBufLen = (uint16_t)readImageBuf(burstBuf, sizeof(burstBuf));
+            if (burstBufLen == 0) {
+                burstFrameEnded = true;
+                break;
+            }
+        }
+
+        uint8_t data = burstBuf[burstBufPos++];
+        if (!jpeg) {
+            buf[count++] = data;
+            burstFrameLength++;
+            if (burstFrameLength >= burstRawSize) {
+                burstFrameEnded = true;
+            }
+            continue;
+        }
+
+        uint8_t kind = jpegStep(&jpegScan, data);
+        if (kind == CAM_JPEG_STEP_SOI) {
+            burstSoiPending = 2;
+        }
+        if (kind != CAM_JPEG_STEP_KEEP) {
+            continue;
+        }
+
+        buf[count++] = data;
+        burstFrameLength++;
+        if (jpegScan.phase == CAM_JPEG_ENDED) {
+            burstFrameEnded = true;
+        }
+    }
+    return count;
+}
+
+uint32_t Arducam_Qwiic_CAM::getBurstFrameLength() const
+{
+    return burstFrameLength;
+}
+
+uint8_t Arducam_Qwiic_CAM::getBurstFrameIndex() const
+{
+    return (burstIndex > 0) ? burstIndex - 1 : 0;
+}
+
+bool Arducam_Qwiic_CAM::getModeSize(CAM_IMAGE_MODE mode, uint16_t* width, uint16_t* height)
+{
+    uint16_t w = 0;
+    uint16_t h = 0;
+    switch (mode) {
+    case CAM_IMAGE_MODE_QVGA:    w = 320;  h = 240;  break;
+    case CAM_IMAGE_MODE_VGA:     w = 640;  h = 480;  break;
+    case CAM_IMAGE_MODE_HD:      w = 1280; h = 720;  break;
+    case CAM_IMAGE_MODE_UXGA:    w = 1600; h = 1200; break;
+    case CAM_IMAGE_MODE_FHD:     w = 1920; h = 1080; break;
+    case CAM_IMAGE_MODE_WQXGA2:  w = 2592; h = 1944; break;
+    case CAM_IMAGE_MODE_96X96:   w = 96;   h = 96;   break;
+    case CAM_IMAGE_MODE_128X128: w = 128;  h = 128;  break;
+    case CAM_IMAGE_MODE_320X320: w = 320;  h = 320;  break;
+    default:                     break;
+    }
+    if (width != NULL) {
+        *width = w;
+    }
+    if (height != NULL) {
+        *height = h;
+    }
+    return (w != 0);
+}
+
+CamStatus Arducam_Qwiic_CAM::setAutoWhiteBalanceMode(CAM_WHITE_BALANCE mode)
+{
+    return writeControlReg(CAM_REG_WHITEBALANCE_MODE_CONTROL, mode);
+}
+
+CamStatus Arducam_Qwiic_CAM::setColorEffect(CAM_COLOR_FX effect)
+{
+    return writeControlReg(CAM_REG_COLOR_EFFECT_CONTROL, effect);
+}
+
+CamStatus Arducam_Qwiic_CAM::setSaturation(CAM_SATURATION_LEVEL level)
+{
+    return writeControlReg(CAM_REG_SATURATION_CONTROL, level);
+}
+
+CamStatus Arducam_Qwiic_CAM::setEV(CAM_EV_LEVEL level)
+{
+    return writeControlReg(CAM_REG_EV_CONTROL, level);
+}
+
+CamStatus Arducam_Qwiic_CAM::setContrast(CAM_CONTRAST_LEVEL level)
+{
+    return writeControlReg(CAM_REG_CONTRAST_CONTROL, level);
+}
+
+CamStatus Arducam_Qwiic_CAM::setBrightness(CAM_BRIGHTNESS_LEVEL level)
+{
+    return writeControlReg(CAM_REG_BRIGHTNESS_CONTROL, level);
 }
 
-CamStatus Arducam_Qwiic_CAM::reset(void)
+CamStatus Arducam_Qwiic_CAM::setSharpness(CAM_SHARPNESS_LEVEL level)
 {
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_SENSOR_RESET, CAM_SENSOR_RESET_ENABLE)); 
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
+    return writeControlReg(CAM_REG_SHARPNESS_CONTROL, level);
 }
 
-CamStatus Arducam_Qwiic_CAM::begin(void)
+CamStatus Arducam_Qwiic_CAM::setImageQuality(IMAGE_QUALITY quality)
 {
-    QWIIC_WIRE.begin();
-    QWIIC_WIRE.setClock(QWIIC_CAM_I2C_SPEED); // Set I2C clock speed
-    return CAM_ERR_NONE;
+    return writeControlReg(CAM_REG_IMAGE_QUALITY, quality);
 }
 
-CamStatus Arducam_Qwiic_CAM::takePicture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format)
+CameraSettings Arducam_Qwiic_CAM::defaultSettings(void)
 {
-    CamStatus ret = CAM_ERR_NONE;
+    CameraSettings settings;
+    settings.quality = DEFAULT_QUALITY;
+    settings.brightness = CAM_BRIGHTNESS_LEVEL_DEFAULT;
+    settings.contrast = CAM_CONTRAST_LEVEL_DEFAULT;
+    settings.saturation = CAM_SATURATION_LEVEL_DEFAULT;
+    settings.ev = CAM_EV_LEVEL_DEFAULT;
+    settings.whiteBalance = CAM_WHITE_BALANCE_MODE_DEFAULT;
+    settings.colorEffect = CAM_COLOR_FX_NONE;
+    settings.sharpness = CAM_SHARPNESS_LEVEL_AUTO;
+    return settings;
+}
 
+CamStatus Arducam_Qwiic_CAM::writeControlReg(uint8_t reg, uint8_t value)
+{
+    stageReg(reg, value);
+    if (!isShadowReg(reg) || !(shadowDirty & shadowBit(reg))) {
+        return CAM_ERR_NONE;
+    }
+    CAM_RETURN_IF_ERR(writeReg(reg, value));
+    return waitI2cIdle();
+}
 
-    if (currentPixelFormat != pixel_format){
-        CAM_RETURN_IF_ERR(writeReg(CAM_REG_FORMAT, pixel_format));
-        CAM_RETURN_IF_ERR(waitI2cIdle());
-        currentPixelFormat = pixel_format;
+void Arducam_Qwiic_CAM::stageReg(uint8_t reg, uint8_t value)
+{
+    if (!isShadowReg(reg)) {
+        return;
     }
+    uint32_t bit = shadowBit(reg);
+    uint8_t index = reg - CAM_SHADOW_REG_BASE;
 
-    if (currentPictureMode != mode) {
-        CAM_RETURN_IF_ERR(writeReg(CAM_REG_CAPTURE_RESOLUTION, CAM_SET_CAPTURE_MODE | mode));
-        CAM_RETURN_IF_ERR(waitI2cIdle());
-        currentPictureMode = mode;
+    if ((shadowValid & bit) && shadowRegs[index] == value) {
+        shadowDirty &= ~bit;
+        return;
     }
+    shadowRegs[index] = value;
+    shadowValid &= ~bit;
+    shadowDirty |= bit;
+}
 
-    CAM_RETURN_IF_ERR(writeReg(ARDUCHIP_FIFO, FIFO_CLEAR_ID_MASK)); // Clear FIFO
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    CAM_RETURN_IF_ERR(writeReg(ARDUCHIP_FIFO, FIFO_START_MASK)); // Start capture
-    CAM_RETURN_IF_ERR(waitI2cIdle());
+CamStatus Arducam_Qwiic_CAM::flushRegs(uint32_t* failed)
+{
+    uint32_t failedMask = 0;
+    uint32_t written = 0;
 
-    unsigned long startTime = millis();
-    while(millis() - startTime < CAM_TIMEOUT_MS) {
-        if(getBit(ARDUCHIP_TRIG, CAP_DONE_MASK)) {
-            totalLength = ((readReg(FIFO_SIZE3) << 16) | (readReg(FIFO_SIZE2) << 8) | readReg(FIFO_SIZE1));
-            unreceivedLength = totalLength;
-            burstFirstFlag = 0;
-            return CAM_ERR_NONE;
+    for (uint8_t i = 0; i < CAM_SHADOW_REG_COUNT; i++) {
+        uint32_t bit = (uint32_t)1 << i;
+        if (!(shadowDirty & bit)) {
+            continue;
         }
-        delay(1);
+        if (writeReg(CAM_SHADOW_REG_BASE + i, shadowRegs[i]) != CAM_ERR_NONE) {
+            failedMask |= bit;
+            continue;
+        }
+        written |= bit;
     }
+    shadowDirty |= failedMask;
 
-    return CAM_ERR_TIMEOUT;
-}
+    CamStatus ret = CAM_ERR_NONE;
+    if (written) {
+        ret = waitI2cIdle();
+        if (ret != CAM_ERR_NONE) {
+            failedMask |= written;
+            shadowDirty |= written;
+        }
+    }
 
-CamStatus Arducam_Qwiic_CAM::setAutoWhiteBalanceMode(CAM_WHITE_BALANCE mode)
-{
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_WHITEBALANCE_MODE_CONTROL, mode));
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
+    if (failed != NULL) {
+        *failed = failedMask;
+    }
+    if (ret == CAM_ERR_NONE && failedMask) {
+        ret = CAM_ERR_NO_CALLBACK;
+    }
+    return ret;
 }
 
-CamStatus Arducam_Qwiic_CAM::setColorEffect(CAM_COLOR_FX effect)
+void Arducam_Qwiic_CAM::invalidateShadow(void)
 {
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_COLOR_EFFECT_CONTROL, effect));
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
+    shadowValid = 0;
+    shadowPending = 0;
+    shadowDirty = 0;
 }
 
-CamStatus Arducam_Qwiic_CAM::setSaturation(CAM_SATURATION_LEVEL level)
+void Arducam_Qwiic_CAM::commitShadow(void)
 {
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_SATURATION_CONTROL, level));
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
+    shadowValid |= shadowPending;
+    shadowPending = 0;
 }
 
-CamStatus Arducam_Qwiic_CAM::setEV(CAM_EV_LEVEL level)
+uint32_t Arducam_Qwiic_CAM::getDirtyMask() const
 {
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_EV_CONTROL, level));
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
+    return shadowDirty;
 }
 
-CamStatus Arducam_Qwiic_CAM::setContrast(CAM_CONTRAST_LEVEL level)
+CamStatus Arducam_Qwiic_CAM::applySettings(const CameraSettings& settings, uint8_t fields, uint8_t* failed)
 {
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_CONTRAST_CONTROL, level));
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
-}
+    for (uint8_t i = 0; i < 8; i++) {
+        uint8_t field = (uint8_t)(1 << i);
+        if (fields & field) {
+            stageReg(settingRegister(field), settingValue(settings, field));
+        }
+    }
 
-CamStatus Arducam_Qwiic_CAM::setBrightness(CAM_BRIGHTNESS_LEVEL level)
-{
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_BRIGHTNESS_CONTROL, level));
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
+    uint32_t failedRegs = 0;
+    CamStatus ret = flushRegs(&failedRegs);
+
+    if (failed != NULL) {
+        *failed = 0;
+        for (uint8_t i = 0; i < 8; i++) {
+            uint8_t field = (uint8_t)(1 << i);
+            if (failedRegs & shadowBit(settingRegister(field))) {
+                *failed |= field;
+            }
+        }
+    }
+    return ret;
 }
 
-CamStatus Arducam_Qwiic_CAM::setSharpness(CAM_SHARPNESS_LEVEL level)
+CameraSettings Arducam_Qwiic_CAM::getAppliedSettings() const
 {
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_SHARPNESS_CONTROL, level));
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
+    CameraSettings settings = defaultSettings();
+    for (uint8_t i = 0; i < 8; i++) {
+        uint8_t field = (uint8_t)(1 << i);
+        uint8_t reg = settingRegister(field);
+        if (shadowValid & shadowBit(reg)) {
+            storeSettingValue(settings, field, shadowRegs[reg - CAM_SHADOW_REG_BASE]);
+        }
+    }
+    return settings;
 }
 
-CamStatus Arducam_Qwiic_CAM::setImageQuality(IMAGE_QUALITY quality)
+uint8_t Arducam_Qwiic_CAM::getAppliedMask() const
 {
-    CAM_RETURN_IF_ERR(writeReg(CAM_REG_IMAGE_QUALITY, quality));
-    CAM_RETURN_IF_ERR(waitI2cIdle());
-    return CAM_ERR_NONE;
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        uint8_t field = (uint8_t)(1 << i);
+        if (shadowValid & shadowBit(settingRegister(field))) {
+            mask |= field;
+        }
+    }
+    return mask;
 }
 
 CamStatus Arducam_Qwiic_CAM::writeReg(uint8_t reg, uint8_t data)
 {
-    QWIIC_WIRE.beginTransmission(deviceAddress);
-    QWIIC_WIRE.write(reg);
-    QWIIC_WIRE.write(data);
-    uint8_t ret = QWIIC_WIRE.endTransmission();
-    if(!ret) {
-        return CAM_ERR_NONE;
-    }else {
-        return CAM_ERR_NO_CALLBACK;
+    uint8_t packet[2] = {reg, data};
+    CamStatus ret = busWrite(packet, sizeof(packet));
+
+    if (reg == CAM_REG_SENSOR_RESET && (data & CAM_SENSOR_RESET_ENABLE)) {
+        // The sensor drops back to its defaults, keep the values for restoreSettings()
+        shadowRestore |= shadowValid | shadowPending | shadowDirty;
+        invalidateShadow();
+        warmupPending = true;
+        reconfigPending = true;
+        sensorFormat = CAM_IMAGE_PIX_FMT_NONE;
+    } else if (isShadowReg(reg)) {
+        uint32_t bit = shadowBit(reg);
+        shadowDirty &= ~bit;
+        // The value is on the wire but only known to be taken once the
+        // camera reports idle, see commitShadow()
+        shadowValid &= ~bit;
+        if (ret == CAM_ERR_NONE) {
+            shadowRegs[reg - CAM_SHADOW_REG_BASE] = data;
+            shadowPending |= bit;
+            shadowRestore &= ~bit;
+        } else {
+            shadowPending &= ~bit;
+        }
     }
+    return ret;
 }
 
 uint8_t Arducam_Qwiic_CAM::readReg(uint8_t reg)
 {
     uint8_t data = 0;
-    QWIIC_WIRE.beginTransmission(deviceAddress);
-    QWIIC_WIRE.write(reg);
-    QWIIC_WIRE.endTransmission(false);
-    QWIIC_WIRE.requestFrom(deviceAddress, (uint8_t)1);
-    while (QWIIC_WIRE.available()) {
-        data = QWIIC_WIRE.read();
+
+    if (isIdReg(reg)) {
+        uint8_t index = reg - CAM_REG_SENSOR_ID;
+        if (!(idCacheMask & (1 << index))) {
+            if (busWriteRead(reg, &data, 1) != 1) {
+                return 0;
+            }
+            idCache[index] = data;
+            idCacheMask |= (1 << index);
+        }
+        return idCache[index];
     }
+
+    busWriteRead(reg, &data, 1);
     return data;
 }
 
-uint32_t Arducam_Qwiic_CAM::readImageBuf(uint8_t* buf, uint32_t length)
+CamStatus Arducam_Qwiic_CAM::busWrite(const uint8_t* data, size_t length)
 {
-    if (unreceivedLength == 0 || length == 0 || buf == NULL) {
-        return 0;
+    CAM_STATS(stats->regWrites++);
+    CAM_STATS(stats->bytesWritten += length);
+    if (bus == NULL) {
+        return CAM_ERR_NO_CALLBACK;
+    }
+    bool ok = bus->write(deviceAddress, data, length);
+    noteBusResult(ok);
+    if (!ok) {
+        CAM_STATS(stats->busErrors++);
+        return CAM_ERR_NO_CALLBACK;
     }
+    return CAM_ERR_NONE;
+}
 
-    if (length > unreceivedLength) {
-        length = unreceivedLength;
+size_t Arducam_Qwiic_CAM::busWriteRead(uint8_t reg, uint8_t* buf, size_t length)
+{
+    if (bus == NULL) {
+        return 0;
+    }
+    size_t received = bus->writeRead(deviceAddress, reg, buf, length);
+    noteBusResult(received == length);
+#if QWIIC_CAM_ENABLE_STATS
+    if (stats != NULL) {
+        if (reg == BURST_FIFO_READ) {
+            stats->fifoBursts++;
+            stats->fifoBytes += received;
+        } else {
+            stats->regReads++;
+            stats->bytesRead += received;
+        }
     }
+#endif
+    return received;
+}
 
+CamStatus Arducam_Qwiic_CAM::beginFifoRead(void)
+{
     // First read of a new frame: reset FIFO read pointer
     if (burstFirstFlag == 0) {
+        frameInfo.drainStartUs = micros();
         CAM_RETURN_IF_ERR(writeReg(ARDUCHIP_FIFO, FIFO_RDPTR_RST_MASK));
         CAM_RETURN_IF_ERR(waitI2cIdle());
         burstFirstFlag = 1;
     }
 
-    uint32_t totalRead = 0;
+    if (captureState == CAM_CAPTURE_READY) {
+        captureState = CAM_CAPTURE_DRAINING;
+    }
+    return CAM_ERR_NONE;
+}
+
+#if defined(ARDUINO)
+// Print adaptor that forwards the JPEG image from SOI to EOI and drops the
+// bytes around it
+class JpegTrimPrint : public Print
+{
+private:
+    Print& out;
+    CamJpegScan* scan;
+
+public:
+    size_t delivered;
 
-    // Read in chunks to stay within Wire library buffer limits
-    while (totalRead < length) {
-        uint32_t remaining = length - totalRead;
-        uint8_t chunkSize = (remaining > I2C_BUFFER_SIZE) ? I2C_BUFFER_SIZE : (uint8_t)remaining;
+    JpegTrimPrint(Print& out, CamJpegScan* scan) : out(out), scan(scan), delivered(0) {}
 
-        QWIIC_WIRE.beginTransmission(deviceAddress);
-        QWIIC_WIRE.write(BURST_FIFO_READ);
-        QWIIC_WIRE.endTransmission(false);
+    size_t write(uint8_t data)
+    {
+        return write(&data, 1);
+    }
 
-        uint8_t bytesReceived = QWIIC_WIRE.requestFrom(deviceAddress, chunkSize);
-        uint8_t chunkRead = 0;
-        while (QWIIC_WIRE.available() && chunkRead < bytesReceived) {
-            buf[totalRead++] = QWIIC_WIRE.read();
-            chunkRead++;
+    size_t write(const uint8_t* data, size_t length)
+    {
+        static const uint8_t soi[2] = {0xFF, 0xD8};
+        if (scan->owed) {
+            delivered += out.write(soi[1]);
+            scan->owed = false;
         }
+        size_t i = 0;
+        while (i < length && scan->phase == CAM_JPEG_SEEK_SOI) {
+            if (jpegStep(scan, data[i++]) == CAM_JPEG_STEP_SOI) {
+                out.write(soi, sizeof(soi));
+                delivered += sizeof(soi);
+            }
+        }
+        size_t keep = jpegRun(scan, data + i, length - i);
+        out.write(data + i, keep);
+        delivered += keep;
+        return length;
     }
+};
+#endif
+
+bool Arducam_Qwiic_CAM::isTrimmingJpeg(void) const
+{
+    // Burst captures hold several JPEG frames, they are split by readBurstFrame()
+    return jpegTrim && captureFormat == CAM_IMAGE_PIX_FMT_JPG && burstFrames == 0;
+}
 
-    if (totalRead > 0 && totalRead <= unreceivedLength) {
-        unreceivedLength -= totalRead;
+CamStatus Arducam_Qwiic_CAM::finishFifoRead(size_t consumed, size_t kept)
+{
+    imageLength += kept;
+    frameInfo.imageLength = imageLength;
+    if (isTrimmingJpeg() && jpegScan.phase == CAM_JPEG_ENDED) {
+        // Everything after EOI is FIFO padding
+        unreceivedLength = 0;
+    } else if (consumed > 0 && consumed <= unreceivedLength) {
+        unreceivedLength -= consumed;
     }
 
     // All data received: clear FIFO write pointer and reset flags
     if (unreceivedLength == 0) {
+        frameInfo.drainEndUs = micros();
+        CAM_STATS(stats->drainBytes += imageLength);
+        CAM_STATS(stats->drainUs += frameInfo.drainEndUs - frameInfo.drainStartUs);
+        if (captureState == CAM_CAPTURE_DRAINING) {
+            captureState = CAM_CAPTURE_IDLE;
+        }
         CAM_RETURN_IF_ERR(writeReg(ARDUCHIP_FIFO, FIFO_CLEAR_MASK));
         CAM_RETURN_IF_ERR(waitI2cIdle());
+
+        if (videoActive && captureState == CAM_CAPTURE_IDLE) {
+            // Trigger the next frame before the caller finishes with this one,
+            // but leave its completion to nextFrame() so the drain of this
+            // frame cannot run on into the next
+            armVideoFrame();
+            videoHold = true;
+            poll();
+        }
+    }
+    return CAM_ERR_NONE;
+}
+
+size_t Arducam_Qwiic_CAM::readImageBuf(uint8_t* buf, size_t length)
+{
+    if (asyncPending || unreceivedLength == 0 || length == 0 || buf == NULL) {
+        return 0;
+    }
+
+    // Trimming drops bytes, so more than the caller gets may be read
+    bool trim = isTrimmingJpeg();
+    if (!trim && length > unreceivedLength) {
+        length = unreceivedLength;
+    }
+
+    if (beginFifoRead() != CAM_ERR_NONE) {
+        return 0;
+    }
+
+    size_t totalRead = 0;
+    size_t consumed = 0;
+    size_t burst = getBurstSize();
+
+    // Read in chunks to stay within the bus receive buffer
+    while (totalRead < length && consumed < unreceivedLength) {
+        uint8_t* dst = buf + totalRead;
+        size_t space = length - totalRead;
+        size_t lead = 0;
+        if (trim && jpegScan.owed) {
+            // Second byte of an SOI that did not fit the last read
+            *dst = 0xD8;
+            jpegScan.owed = false;
+            totalRead++;
+            continue;
+        }
+        if (trim && jpegScan.phase == CAM_JPEG_SEEK_SOI && jpegScan.prevFF) {
+            // The 0xFF ending the last chunk may start the SOI
+            lead = 1;
+        }
+
+        // With one byte of room left the SOI is assembled aside
+        uint8_t pair[2];
+        uint8_t* chunk = (lead > 0 && space < 2) ? pair : dst;
+        size_t room = (chunk == pair) ? sizeof(pair) : space;
+        size_t chunkSize = room - lead;
+        if (chunkSize > burst) {
+            chunkSize = burst;
+        }
+        if (chunkSize > unreceivedLength - consumed) {
+            chunkSize = unreceivedLength - consumed;
+        }
+
+        chunk[0] = 0xFF;
+        size_t received = busWriteRead(BURST_FIFO_READ, chunk + lead, chunkSize);
+        if (received == 0) {
+            // Bus failure, the rest of the frame stays in the FIFO
+            break;
+        }
+        consumed += received;
+        if (!trim) {
+            totalRead += received;
+            continue;
+        }
+
+        size_t kept = jpegTrimChunk(&jpegScan, chunk, lead + received);
+        if (chunk != pair) {
+            totalRead += kept;
+        } else if (kept > 0) {
+            *dst = 0xFF;
+            jpegScan.owed = true;
+            totalRead++;
+        }
+        if (jpegScan.phase == CAM_JPEG_ENDED) {
+            break;
+        }
+    }
+
+    finishFifoRead(consumed, totalRead);
+    return totalRead;
+}
+
+#if defined(ARDUINO)
+size_t Arducam_Qwiic_CAM::readImageTo(Print& out, size_t chunk)
+{
+    if (unreceivedLength == 0 || bus == NULL) {
+        return 0;
+    }
+
+    if (beginFifoRead() != CAM_ERR_NONE) {
+        return 0;
+    }
+
+    size_t burst = getBurstSize();
+    if (chunk == 0 || chunk > burst) {
+        chunk = burst;
+    }
+
+    bool trim = isTrimmingJpeg();
+    JpegTrimPrint trimOut(out, &jpegScan);
+    Print& sink = trim ? (Print&)trimOut : out;
+
+    // Only a trimmed JPEG stops at its EOI, the scan state is stale otherwise
+    size_t totalRead = 0;
+    while (totalRead < unreceivedLength && (!trim || jpegScan.phase != CAM_JPEG_ENDED)) {
+        size_t remaining = unreceivedLength - totalRead;
+        size_t chunkSize = (remaining > chunk) ? chunk : remaining;
+
+        size_t received = bus->writeReadTo(deviceAddress, BURST_FIFO_READ, sink, chunkSize);
+        noteBusResult(received == chunkSize);
+        CAM_STATS(stats->fifoBursts++);
+        CAM_STATS(stats->fifoBytes += received);
+        if (received == 0) {
+            break;
+        }
+        totalRead += received;
+    }
+
+    size_t delivered = trim ? trimOut.delivered : totalRead;
+    finishFifoRead(totalRead, delivered);
+    return delivered;
+}
+#endif
+
+size_t Arducam_Qwiic_CAM::readImageBufAsync(uint8_t* buf, size_t length)
+{
+    if (asyncPending || unreceivedLength == 0 || length == 0 || buf == NULL || bus == NULL) {
+        return 0;
+    }
+
+    // A trimmed JPEG chunk starts with the 0xD8 of an SOI that did not fit
+    // the last read, or with the 0xFF that may start one
+    uint8_t lead = 0;
+    if (isTrimmingJpeg() && (jpegScan.owed || (jpegScan.phase == CAM_JPEG_SEEK_SOI && jpegScan.prevFF))) {
+        lead = 1;
+    }
+    if (length <= lead) {
+        return 0;
+    }
+    length -= lead;
+
+    size_t burst = getBurstSize();
+    if (length > burst) {
+        length = burst;
+    }
+    if (length > unreceivedLength) {
+        length = unreceivedLength;
+    }
+
+    if (beginFifoRead() != CAM_ERR_NONE) {
+        return 0;
+    }
+
+    if (lead > 0) {
+        buf[0] = jpegScan.owed ? 0xD8 : 0xFF;
+        jpegScan.owed = false;
+        buf++;
+    }
+    asyncBuf = buf;
+    asyncLead = lead;
+    asyncLength = length;
+    asyncReceived = 0;
+    asyncStartMs = millis();
+    asyncPending = true;
+    asyncInFlight = bus->startRead(deviceAddress, BURST_FIFO_READ, buf, length);
+    if (!asyncInFlight) {
+        // No background receive on this backend, read the chunk now
+        asyncReceived = busWriteRead(BURST_FIFO_READ, buf, length);
+    }
+    return length;
+}
+
+bool Arducam_Qwiic_CAM::isImageBufReady(void)
+{
+    if (asyncInFlight && bus->pollRead(&asyncReceived)) {
+        asyncInFlight = false;
+        noteBusResult(asyncReceived == asyncLength);
+        CAM_STATS(stats->fifoBursts++);
+        CAM_STATS(stats->fifoBytes += asyncReceived);
+    }
+    return asyncPending && !asyncInFlight;
+}
+
+CamStatus Arducam_Qwiic_CAM::waitImageBuf(size_t* received, uint32_t timeoutMs)
+{
+    *received = 0;
+    if (!asyncPending) {
+        return CAM_ERR_NONE;
+    }
+
+    while (!isImageBufReady()) {
+        if (millis() - asyncStartMs >= timeoutMs) {
+            cancelImageBufAsync();
+            noteBusResult(false);
+            return CAM_ERR_TIMEOUT;
+        }
+        // Let the core run background work (WiFi, USB) while the transfer runs
+        yield();
+    }
+    asyncPending = false;
+
+    size_t length = asyncReceived;
+    uint8_t* start = asyncBuf - asyncLead;
+    if (length == 0) {
+        if (asyncLead > 0 && start[0] == 0xD8) {
+            jpegScan.owed = true;
+        }
+        return CAM_ERR_NO_CALLBACK;
+    }
+    size_t kept = length;
+    if (isTrimmingJpeg()) {
+        if (asyncLead > 0 && start[0] == 0xD8) {
+            kept = 1 + jpegTrimChunk(&jpegScan, asyncBuf, length);
+        } else {
+            kept = jpegTrimChunk(&jpegScan, start, asyncLead + length);
+        }
+    }
+    *received = kept;
+    return finishFifoRead(length, kept);
+}
+
+void Arducam_Qwiic_CAM::cancelImageBufAsync(void)
+{
+    if (asyncInFlight) {
+        bus->cancelRead();
     }
+    asyncInFlight = false;
+    asyncPending = false;
+}
+
+#if defined(ARDUINO)
+size_t Arducam_Qwiic_CAM::readImageToAsync(Print& out, uint8_t* bufA, uint8_t* bufB, size_t length)
+{
+    uint8_t* current = bufA;
+    uint8_t* next = bufB;
+    size_t totalRead = 0;
 
+    if (readImageBufAsync(current, length) == 0) {
+        return 0;
+    }
+    for (;;) {
+        size_t received;
+        if (waitImageBuf(&received) != CAM_ERR_NONE) {
+            break;
+        }
+        // Keep the bus busy with the next chunk while this one is sent
+        bool more = (readImageBufAsync(next, length) > 0);
+        out.write(current, received);
+        totalRead += received;
+        if (!more) {
+            break;
+        }
+        uint8_t* done = current;
+        current = next;
+        next = done;
+    }
     return totalRead;
 }
+#endif
+
+void Arducam_Qwiic_CAM::setJpegTrim(bool enable)
+{
+    jpegTrim = enable;
+}
+
+bool Arducam_Qwiic_CAM::getJpegTrim() const
+{
+    return jpegTrim;
+}
+
+uint32_t Arducam_Qwiic_CAM::getImageLength() const
+{
+    return imageLength;
+}
+
+bool Arducam_Qwiic_CAM::isImageComplete() const
+{
+    if (isTrimmingJpeg() && jpegScan.phase == CAM_JPEG_ENDED) {
+        return true;
+    }
+    return imageLength > 0 && unreceivedLength == 0;
+}
+
+size_t Arducam_Qwiic_CAM::getBurstSize() const
+{
+    size_t limit = (bus != NULL) ? bus->maxReadLength() : I2C_BUFFER_SIZE;
+    if (burstSize == 0 || burstSize > limit) {
+        return limit;
+    }
+    return burstSize;
+}
+
+void Arducam_Qwiic_CAM::setBurstSize(size_t size)
+{
+    burstSize = size;
+}
 
 uint8_t Arducam_Qwiic_CAM::readImageByte(void)
 {
@@ -220,26 +1723,94 @@ uint32_t Arducam_Qwiic_CAM::getTotalLength(void)
 
 CamStatus Arducam_Qwiic_CAM::clearFIFO(void)
 {
+    cancelImageBufAsync();
     CAM_RETURN_IF_ERR(writeReg(ARDUCHIP_FIFO, FIFO_CLEAR_MASK));
     CAM_RETURN_IF_ERR(waitI2cIdle());
     unreceivedLength = 0;
     burstFirstFlag = 0;
+    if (captureState == CAM_CAPTURE_READY || captureState == CAM_CAPTURE_DRAINING) {
+        captureState = CAM_CAPTURE_IDLE;
+    }
     return CAM_ERR_NONE;
 }
 
 CamStatus Arducam_Qwiic_CAM::waitI2cIdle(void)
 {
+    CAM_STATS(stats->idleWaits++);
+#if QWIIC_CAM_ENABLE_STATS
+    unsigned long startUs = micros();
+#endif
     unsigned long startMillis = millis();
+    uint8_t interval = 1;
     while((millis() - startMillis) < CAM_TIMEOUT_MS) {
+        CAM_STATS(stats->idlePolls++);
         if(getBit(CAM_REG_SENSOR_STATE, CAM_REG_SENSOR_STATE_IDLE)) {
+            CAM_STATS(stats->idleWaitUs += micros() - startUs);
+            commitShadow();
             return CAM_ERR_NONE;
         }else {
-            delay(1);
+            delay(interval);
+            if (adaptivePolling && interval < QWIIC_CAM_IDLE_MAX_INTERVAL_MS) {
+                interval = (interval * 2 > QWIIC_CAM_IDLE_MAX_INTERVAL_MS) ? QWIIC_CAM_IDLE_MAX_INTERVAL_MS : interval * 2;
+            }
         }
     }
+    CAM_STATS(stats->idleWaitUs += micros() - startUs);
+    CAM_STATS(stats->idleTimeouts++);
+    shadowPending = 0;
     return CAM_ERR_TIMEOUT;
 }
 
+#if QWIIC_CAM_ENABLE_STATS
+void Arducam_Qwiic_CAM::recordCaptureLatency(unsigned long us)
+{
+    stats->captures++;
+    // Video frames complete at the sensor frame rate, they would skew the
+    // still capture histogram
+    if (videoActive || captureMode < 1 || captureMode > CAM_STATS_MODE_COUNT ||
+        captureFormat < 1 || captureFormat > CAM_STATS_FORMAT_COUNT) {
+        return;
+    }
+
+    unsigned long ms = us / 1000;
+    uint8_t bucket = 0;
+    while (bucket < CAM_STATS_LATENCY_BUCKETS - 1 && ms >= (16UL << bucket)) {
+        bucket++;
+    }
+    uint16_t& count = stats->latency[captureMode - 1][captureFormat - 1][bucket];
+    if (count < 0xffff) {
+        count++;
+    }
+}
+
+#endif
+
+void Arducam_Qwiic_CAM::setStats(CamStats* storage)
+{
+    stats = storage;
+    resetStats();
+}
+
+const CamStats* Arducam_Qwiic_CAM::getStats() const
+{
+    return stats;
+}
+
+void Arducam_Qwiic_CAM::resetStats(void)
+{
+    if (stats != NULL) {
+        memset(stats, 0, sizeof(*stats));
+    }
+}
+
+uint32_t Arducam_Qwiic_CAM::getDrainBytesPerSecond() const
+{
+    if (stats == NULL || stats->drainUs == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)stats->drainBytes * 1000000ULL / stats->drainUs);
+}
+
 uint32_t Arducam_Qwiic_CAM::getUnreceivedLength() const
 {
     return unreceivedLength;
@@ -262,12 +1833,18 @@ uint8_t Arducam_Qwiic_CAM::getPreviewMode() const
 
 uint8_t Arducam_Qwiic_CAM::getCurrentPixelFormat() const
 {
-    return currentPixelFormat;
+    if (!(shadowValid & shadowBit(CAM_REG_FORMAT))) {
+        return CAM_IMAGE_PIX_FMT_NONE;
+    }
+    return shadowRegs[CAM_REG_FORMAT - CAM_SHADOW_REG_BASE];
 }
 
 uint8_t Arducam_Qwiic_CAM::getCurrentPictureMode() const
 {
-    return currentPictureMode;
+    if (!(shadowValid & shadowBit(CAM_REG_CAPTURE_RESOLUTION))) {
+        return CAM_IMAGE_MODE_NONE;
+    }
+    return shadowRegs[CAM_REG_CAPTURE_RESOLUTION - CAM_SHADOW_REG_BASE] & ~CAM_SET_VIDEO_MODE;
 }
 
 uint8_t Arducam_Qwiic_CAM::getDeviceAddress() const
@@ -277,6 +1854,10 @@ uint8_t Arducam_Qwiic_CAM::getDeviceAddress() const
 
 void Arducam_Qwiic_CAM::setDeviceAddress(uint8_t addr)
 {
+    if (addr != deviceAddress) {
+        invalidateShadow();
+        idCacheMask = 0;
+    }
     deviceAddress = addr;
 }
 
@@ -289,3 +1870,17 @@ void Arducam_Qwiic_CAM::setBurstFirst(bool enable)
 {
     burstFirstFlag = enable ? 1 : 0;
 }
+
+Arducam_Qwiic_Bus* Arducam_Qwiic_CAM::getBus() const
+{
+    return bus;
+}
+
+void Arducam_Qwiic_CAM::setBus(Arducam_Qwiic_Bus& bus)
+{
+    if (&bus != this->bus) {
+        invalidateShadow();
+        idCacheMask = 0;
+    }
+    this->bus = &bus;
+}
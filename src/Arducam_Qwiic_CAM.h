@@ -12,8 +12,7 @@
 #define __ARDUCAM_QWIIC_CAM_H
 
 #include <stdint.h>
-#include <Arduino.h>
-#include <Wire.h>
+#include "Arducam_Qwiic_Bus.h"
 
 /**
 * @file Arducam_Qwiic_CAM.h
@@ -61,6 +60,46 @@
 #define CAM_TIMEOUT_MS                             1000
 #define I2C_BUFFER_SIZE                            255   // Arduino Wire library buffer limit
 
+#if !defined(QWIIC_CAM_ENABLE_STATS)
+#define QWIIC_CAM_ENABLE_STATS                     0     // 1 to compile in the counting for setStats()
+#endif
+
+#if !defined(QWIIC_CAM_POLL_MAX_INTERVAL_MS)
+#define QWIIC_CAM_POLL_MAX_INTERVAL_MS             8     // Longest gap between CAP_DONE polls
+#endif
+
+#if !defined(QWIIC_CAM_IDLE_MAX_INTERVAL_MS)
+#define QWIIC_CAM_IDLE_MAX_INTERVAL_MS             4     // Longest gap between idle polls
+#endif
+
+#if !defined(QWIIC_CAM_CAPTURE_ATTEMPTS)
+#define QWIIC_CAM_CAPTURE_ATTEMPTS                 3     // takePicture() tries before giving up
+#endif
+
+#if !defined(QWIIC_CAM_I2C_MAX_SPEED)
+#define QWIIC_CAM_I2C_MAX_SPEED                    1000000 // Fastest clock begin(maxClock) may pick, Fast-mode Plus
+#endif
+
+#if !defined(QWIIC_CAM_CLOCK_VERIFY_ROUNDS)
+#define QWIIC_CAM_CLOCK_VERIFY_ROUNDS              4     // Test pattern passes a clock must survive
+#endif
+
+#if !defined(QWIIC_CAM_CLOCK_ERROR_LIMIT)
+#define QWIIC_CAM_CLOCK_ERROR_LIMIT                3     // Bus errors in a row that lower the clock
+#endif
+
+#define CAM_RECONFIG_MODE                          ((CAM_IMAGE_MODE)0) // Resolution used to reload the sensor pipeline
+
+#define CAM_LATENCY_MODE_COUNT                     9     // CAM_IMAGE_MODE_QVGA .. CAM_IMAGE_MODE_320X320
+#define CAM_LATENCY_FORMAT_COUNT                   3     // CAM_IMAGE_PIX_FMT_JPG .. CAM_IMAGE_PIX_FMT_Y8
+#define CAM_LATENCY_WEIGHT_SHIFT                   2     // New samples weigh 1/4 in the latency model
+
+#if !defined(QWIIC_CAM_CHUNK_TIMEOUT_MS)
+#define QWIIC_CAM_CHUNK_TIMEOUT_MS                 100   // Longest wait for one asynchronous FIFO chunk
+#endif
+
+#define CAM_BURST_BUF_SIZE                         128   // Staging buffer for splitting burst captures, part of the class layout
+
 #define CAM_REG_POWER_CONTROL                      0X02
 #define CAM_REG_SENSOR_RESET                       0X07
 #define CAM_REG_FORMAT                             0X20
@@ -82,9 +121,21 @@
 #define CAM_REG_DAY_ID                             0x43
 #define CAM_REG_SENSOR_STATE                       0x44
 
+#define CAM_SHADOW_REG_BASE                        CAM_REG_FORMAT  // First control register kept in the shadow
+#define CAM_SHADOW_REG_COUNT                       0x11            // CAM_REG_FORMAT .. CAM_REG_EXPOSURE_GAIN_WHITEBALANCE_CONTROL
+#define CAM_ID_REG_COUNT                           4               // CAM_REG_SENSOR_ID .. CAM_REG_DAY_ID
+
 #define CAM_I2C_READ_MODE                          (1 << 0)
 #define CAM_REG_SENSOR_STATE_IDLE                  (1 << 1)
 #define CAM_SENSOR_RESET_ENABLE                    (1 << 6)
+
+#if !defined(CAM_POWER_STANDBY)
+#define CAM_POWER_STANDBY                          0X07  // CAM_REG_POWER_CONTROL value that idles the sensor
+#endif
+
+#if !defined(CAM_POWER_NORMAL)
+#define CAM_POWER_NORMAL                           0X05  // CAM_REG_POWER_CONTROL value for normal operation
+#endif
 #define CAM_FORMAT_BASICS                          (0 << 0)
 #define CAM_SET_CAPTURE_MODE                       (0 << 7)
 #define CAM_SET_VIDEO_MODE                         (1 << 7)
@@ -97,6 +148,8 @@
     CAM_ERR_NONE        = 0,  /**< Operation succeeded */
     CAM_ERR_NO_CALLBACK = 1,  /**< No callback function is registered*/
 	CAM_ERR_TIMEOUT     = 2,  /**< Timeout*/
+	CAM_ERR_BUSY        = 3,  /**< A capture is already in progress*/
+	CAM_ERR_INVALID     = 4,  /**< An argument is out of range*/
 } CamStatus;
 
 /**
@@ -261,6 +314,154 @@ typedef enum {
     LOW_QUALITY     = 2,
 } IMAGE_QUALITY;
 
+/**
+ * @enum CAM_SETTING_FIELD
+ * @brief Bit mask of the fields in CameraSettings
+ */
+typedef enum {
+    CAM_SETTING_QUALITY       = (1 << 0), /**< Image quality */
+    CAM_SETTING_BRIGHTNESS    = (1 << 1), /**< Brightness level */
+    CAM_SETTING_CONTRAST      = (1 << 2), /**< Contrast level */
+    CAM_SETTING_SATURATION    = (1 << 3), /**< Saturation level */
+    CAM_SETTING_EV            = (1 << 4), /**< EV level */
+    CAM_SETTING_WHITE_BALANCE = (1 << 5), /**< White balance mode */
+    CAM_SETTING_COLOR_EFFECT  = (1 << 6), /**< Special effect */
+    CAM_SETTING_SHARPNESS     = (1 << 7), /**< Sharpness level */
+    CAM_SETTING_ALL           = 0xff,     /**< Every field */
+} CAM_SETTING_FIELD;
+
+/**
+ * @struct CameraSettings
+ * @brief Image controls applied together by applySettings()
+ */
+typedef struct {
+    IMAGE_QUALITY quality;              /**< Image quality */
+    CAM_BRIGHTNESS_LEVEL brightness;    /**< Brightness level */
+    CAM_CONTRAST_LEVEL contrast;        /**< Contrast level */
+    CAM_SATURATION_LEVEL saturation;    /**< Saturation level */
+    CAM_EV_LEVEL ev;                    /**< EV level */
+    CAM_WHITE_BALANCE whiteBalance;     /**< White balance mode */
+    CAM_COLOR_FX colorEffect;           /**< Special effect */
+    CAM_SHARPNESS_LEVEL sharpness;      /**< Sharpness level */
+} CameraSettings;
+
+/**
+ * @enum CAM_JPEG_PHASE
+ * @brief Position of the JPEG scan in the marker structure of a frame
+ */
+typedef enum {
+    CAM_JPEG_SEEK_SOI = 0, /**< Before the SOI, bytes are dropped */
+    CAM_JPEG_HEADER,       /**< Between marker segments */
+    CAM_JPEG_LENGTH_HI,    /**< First byte of a segment length */
+    CAM_JPEG_LENGTH_LO,    /**< Second byte of a segment length */
+    CAM_JPEG_SKIP,         /**< Segment payload, markers in it are data */
+    CAM_JPEG_ENTROPY,      /**< Entropy-coded data after an SOS */
+    CAM_JPEG_ENDED         /**< EOI read, bytes are dropped */
+} CAM_JPEG_PHASE;
+
+/**
+ * @struct CamJpegScan
+ * @brief State of the JPEG scan over a frame read in pieces
+ */
+typedef struct {
+    uint8_t phase;             /**< CAM_JPEG_PHASE */
+    uint8_t marker;            /**< Marker of the current segment */
+    uint16_t skip;             /**< Payload bytes of the segment still to skip */
+    bool prevFF;               /**< Last byte was 0xFF */
+    bool owed;                 /**< The 0xD8 of an SOI that did not fit the last read */
+} CamJpegScan;
+
+/**
+ * @enum CAM_CAPTURE_STATE
+ * @brief State of the non-blocking capture, see startCapture() and poll()
+ */
+typedef enum {
+    CAM_CAPTURE_IDLE = 0, /**< No capture in progress */
+    CAM_CAPTURE_CONFIG,   /**< Writing pixel format and resolution */
+    CAM_CAPTURE_CLEAR,    /**< Clearing the FIFO done flag */
+    CAM_CAPTURE_START,    /**< Starting the capture */
+    CAM_CAPTURE_WAITING,  /**< Waiting for the capture done flag */
+    CAM_CAPTURE_READY,    /**< Frame is in the FIFO, length is known */
+    CAM_CAPTURE_DRAINING, /**< Frame is being read out */
+    CAM_CAPTURE_ERROR,    /**< Capture failed, see getCaptureError() */
+} CAM_CAPTURE_STATE;
+
+#define CAM_STATS_MODE_COUNT      CAM_LATENCY_MODE_COUNT
+#define CAM_STATS_FORMAT_COUNT    CAM_LATENCY_FORMAT_COUNT
+#define CAM_STATS_LATENCY_BUCKETS 8   /**< Bucket n counts latencies below 16 << n ms, the last one the rest */
+
+/**
+ * @struct CamStats
+ * @brief Bus and capture counters, see Arducam_Qwiic_CAM::setStats()
+ */
+typedef struct {
+    uint32_t regWrites;        /**< Register write transactions */
+    uint32_t regReads;         /**< Register read transactions */
+    uint32_t fifoBursts;       /**< BURST_FIFO_READ transactions */
+    uint32_t bytesWritten;     /**< Bytes sent by register writes */
+    uint32_t bytesRead;        /**< Bytes received by register reads */
+    uint32_t fifoBytes;        /**< Bytes received by FIFO bursts */
+    uint32_t busErrors;        /**< Writes not acknowledged */
+    uint32_t idleWaits;        /**< Waits for the camera to go idle */
+    uint32_t idlePolls;        /**< Status reads spent waiting for idle */
+    uint32_t idleWaitUs;       /**< Time spent waiting for idle */
+    uint32_t idleTimeouts;     /**< Idle waits that timed out */
+    uint32_t captures;         /**< Captures that completed */
+    uint32_t captureTimeouts;  /**< Captures that timed out */
+    uint32_t donePolls;        /**< Status reads spent waiting for CAP_DONE */
+    uint32_t drainBytes;       /**< Bytes of completely drained frames */
+    uint32_t drainUs;          /**< Time spent draining those frames */
+    uint16_t latency[CAM_STATS_MODE_COUNT][CAM_STATS_FORMAT_COUNT][CAM_STATS_LATENCY_BUCKETS]; /**< Trigger-to-done histogram */
+} CamStats;
+
+/**
+ * @enum CAM_CAPTURE_POLICY
+ * @brief Sensor workarounds applied by takePicture(), OR the values together
+ */
+typedef enum {
+    CAM_POLICY_NONE              = 0x00, /**< Capture exactly once */
+    CAM_POLICY_WARMUP            = 0x01, /**< Discard the first frame after power-up or reset() */
+    CAM_POLICY_RECONFIG          = 0x02, /**< Discard one CAM_RECONFIG_MODE frame when the pixel format changes or after reset() */
+    CAM_POLICY_RETRY             = 0x04, /**< Retry failed or empty captures */
+    CAM_POLICY_DEFAULT           = 0x07  /**< All of the above */
+} CAM_CAPTURE_POLICY;
+
+/**
+ * @struct CamPolicyCounters
+ * @brief Frames spent by the capture policy
+ */
+typedef struct {
+    uint32_t warmupFrames;     /**< Frames discarded after power-up or reset() */
+    uint32_t reconfigFrames;   /**< Frames discarded for a pixel format change */
+    uint32_t retries;          /**< Captures repeated because they failed or were empty */
+} CamPolicyCounters;
+
+/**
+ * @struct CamFrameInfo
+ * @brief What is known about the last frame, see getFrameInfo()
+ */
+typedef struct {
+    uint32_t seq;              /**< Completed captures since power-up, gaps show frames that were never read */
+    unsigned long triggerUs;   /**< Time the capture was started, set at the trigger */
+    unsigned long doneUs;      /**< Time the frame was found in the FIFO */
+    unsigned long drainStartUs; /**< Time the first byte was read, 0 before */
+    unsigned long drainEndUs;  /**< Time the last byte was read, 0 before */
+    uint32_t length;           /**< FIFO length of the frame */
+    uint32_t imageLength;      /**< Image bytes handed out, less than length with JPEG trimming */
+    uint8_t mode;              /**< CAM_IMAGE_MODE, or CAM_VIDEO_MODE for video frames */
+    uint8_t format;            /**< CAM_IMAGE_PIX_FMT */
+    bool video;                /**< Frame came from startVideo() */
+    uint8_t settingsMask;      /**< CAM_SETTING_FIELD bits of settings that were known */
+    CameraSettings settings;   /**< Controls in effect when the frame was taken */
+} CamFrameInfo;
+
+class Arducam_Qwiic_CAM;
+
+/**
+ * Called from poll() when a frame is ready to be read.
+ */
+typedef void (*CamFrameReadyCallback)(Arducam_Qwiic_CAM& cam, void* arg);
+
 /**
 * @brief Arducam Qwiic CAM Class
 */
@@ -273,277 +474,1156 @@ private:
 	uint8_t burstFirstFlag;                         /**< Flag bit for reading data for the first time in
 													burst mode */
 	uint8_t previewMode;                            /**< Stream mode flag */
-	uint8_t currentPixelFormat;                     /**< The currently set image pixel format */
-	uint8_t currentPictureMode;                     /**< Currently set resolution */
 	uint8_t deviceAddress;                          /**< Device address */
+	Arducam_Qwiic_Bus* bus;                         /**< Bus backend the camera is attached to */
+	size_t burstSize;                               /**< Requested FIFO burst length, 0 for bus maximum */
+	uint8_t shadowRegs[CAM_SHADOW_REG_COUNT];       /**< Shadow of the control registers */
+	uint32_t shadowValid;                           /**< Shadow entries known to match the camera */
+	uint32_t shadowDirty;                           /**< Shadow entries staged but not written yet */
+	uint32_t shadowPending;                         /**< Shadow entries written, valid once the camera is idle */
+	uint32_t shadowRestore;                         /**< Shadow entries lost by reset or standby, see restoreSettings() */
+	bool standbyActive;                             /**< Sensor is in standby, see standby() */
+	bool discarding;                                /**< The capture in progress is thrown away by the policy */
+	bool startupPending;                            /**< No frame completed since the last reset or wake */
+	unsigned long startupStartUs;                   /**< Time of the last reset or wake */
+	unsigned long startupLatencyUs;                 /**< Reset or wake to first frame of the last startup */
+	uint8_t idCache[CAM_ID_REG_COUNT];              /**< Cached sensor ID and firmware date */
+	uint8_t idCacheMask;                            /**< idCache entries that have been read */
+	uint8_t captureState;                           /**< CAM_CAPTURE_STATE of the current capture */
+	uint8_t captureError;                           /**< CamStatus that ended the last capture */
+	uint8_t captureMode;                            /**< Resolution of the current capture */
+	uint8_t captureFormat;                          /**< Pixel format of the current capture */
+	bool idlePending;                               /**< Last step is waiting for the camera to go idle */
+	unsigned long stepStartMs;                      /**< Start time of the current step */
+	unsigned long triggerMs;                        /**< Time the current capture was started */
+	unsigned long nextPollMs;                       /**< Earliest time poll() reads the camera again */
+	uint8_t pollIntervalMs;                         /**< Current backoff between status reads */
+	bool adaptivePolling;                           /**< Schedule polls from the latency model */
+	bool learnLatency;                              /**< Current capture updates the latency model */
+	uint16_t latencyModel[CAM_LATENCY_MODE_COUNT][CAM_LATENCY_FORMAT_COUNT]; /**< Expected trigger-to-done time in ms, 0 if unknown */
+	uint8_t capturePolicy;                          /**< CAM_CAPTURE_POLICY flags */
+	uint8_t captureAttempts;                        /**< takePicture() tries with CAM_POLICY_RETRY */
+	bool warmupPending;                             /**< Next capture is the first since power-up or reset */
+	bool reconfigPending;                           /**< Sensor was reset, the next capture reloads the format */
+	uint8_t sensorFormat;                           /**< Pixel format of the last completed capture, CAM_IMAGE_PIX_FMT_NONE if unknown */
+	CamPolicyCounters policyCounters;               /**< Frames spent by the capture policy */
+	CamFrameReadyCallback frameReadyCallback;       /**< Called when a frame is ready */
+	void* frameReadyArg;                            /**< Argument passed to frameReadyCallback */
+	bool videoActive;                               /**< Sensor is in video mode */
+	bool videoHold;                                 /**< Next video frame triggered, completed by nextFrame() */
+	uint8_t videoMode;                              /**< CAM_VIDEO_MODE of the running stream */
+	uint32_t frameSeq;                              /**< Sequence number of the last video frame */
+	uint32_t imageLength;                           /**< Image bytes handed out for the current frame */
+	unsigned long triggerUs;                        /**< Time the current capture was started */
+	uint32_t captureSeq;                            /**< Captures completed since power-up */
+	CamFrameInfo frameInfo;                         /**< Record of the last completed capture */
+	uint32_t busClock;                              /**< Bus clock in use */
+	uint8_t busErrorRun;                            /**< Bus errors in a row */
+	uint16_t clockFallbacks;                        /**< Times the clock was lowered after errors */
+	CamStats* stats;                                /**< Counter storage, NULL until setStats() */
+	bool jpegTrim;                                  /**< Hand out JPEG frames from SOI to EOI only */
+	CamJpegScan jpegScan;                           /**< JPEG scan of the current frame or burst frame */
+	uint8_t burstFrames;                            /**< Number of frames in the burst capture */
+	uint8_t burstIndex;                             /**< Current burst frame, 1-based, 0 before the first */
+	uint8_t burstFormat;                            /**< Pixel format of the burst capture */
+	bool burstFrameEnded;                           /**< Current burst frame has been read out */
+	uint8_t burstSoiPending;                        /**< SOI bytes still to be returned */
+	uint32_t burstRawSize;                          /**< Size of one RGB565/Y8 frame */
+	uint32_t burstFrameLength;                      /**< Bytes returned for the current frame */
+	uint8_t burstBuf[CAM_BURST_BUF_SIZE];           /**< FIFO data not yet handed out */
+	uint16_t burstBufLen;                           /**< Valid bytes in burstBuf */
+	uint16_t burstBufPos;                           /**< Next byte to hand out from burstBuf */
+	uint8_t* asyncBuf;                              /**< Destination of the asynchronous chunk */
+	uint8_t asyncLead;                              /**< Bytes put in front of the chunk by the JPEG trim */
+	size_t asyncLength;                             /**< FIFO bytes requested by readImageBufAsync() */
+	size_t asyncReceived;                           /**< Bytes the completed chunk holds */
+	unsigned long asyncStartMs;                     /**< Time the chunk read was started */
+	bool asyncPending;                              /**< A chunk was started and not collected yet */
+	bool asyncInFlight;                             /**< The bus is still receiving the chunk */
 
-public:
 	//**********************************************
 	//!
-	//! @brief Constructor of camera class
+	//! @brief Initialize the driver state
+	//!
+	//! @param  bus Bus backend the camera is attached to
+	//**********************************************
+	void initState(Arducam_Qwiic_Bus* bus);
+
+	//**********************************************
 	//!
+	//! @brief Write a register for the capture state machine and arm the
+	//! idle wait for the next poll()
+	//!
+	//! @param  reg Register address
+	//! @param  value Register value
 	//!
+	//! @return Returns false if the write failed
 	//**********************************************
-	Arducam_Qwiic_CAM(void); 
+	bool issueCaptureStep(uint8_t reg, uint8_t value);
 
 	//**********************************************
 	//!
-	//! @brief reset camera
+	//! @brief End the current capture with an error
 	//!
+	//! @param  err Reason of the failure
 	//**********************************************
-	CamStatus reset(void); 
+	void failCapture(CamStatus err);
 
 	//**********************************************
 	//!
-	//! @brief Initialize the configuration of the camera module
+	//! @brief Schedule the next status read after one that found the camera busy
+	//!
+	//! @param  maxInterval Longest backoff in ms
+	//**********************************************
+	void backoffPoll(uint8_t maxInterval);
+
+	//**********************************************
+	//!
+	//! @brief Call poll() until the capture is ready or fails
+	//!
 	//! @return Return operation status
 	//**********************************************
-	CamStatus begin(void);
+	CamStatus waitCapture(void);
 
 	//**********************************************
 	//!
-	//! @brief Start a snapshot with specified resolution and pixel format
+	//! @brief Get the latency model entry of a mode and pixel format
 	//!
-	//! @param mode Resolution of the camera module
-	//! @param pixel_format Output image pixel format,which supports JPEG, RGB,
-	//! YUV
+	//! @return Return the entry, NULL if the combination is not modelled
+	//**********************************************
+	uint16_t* latencyEntry(uint8_t mode, uint8_t pixel_format);
+
+	//**********************************************
+	//!
+	//! @brief Capture a frame and throw it away
+	//!
+	//! @param mode Resolution of the capture
+	//! @param pixel_format Pixel format of the capture
 	//!
 	//! @return Return operation status
+	//**********************************************
+	CamStatus discardCapture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format);
+
+	//**********************************************
 	//!
-	//! @note The mode parameter must be the resolution which the current camera
-	//! supported
+	//! @brief Prepare the FIFO for reading, resets the read pointer on the
+	//! first read of a frame
+	//!
+	//! @return Return operation status
 	//**********************************************
-	CamStatus takePicture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format);
+	CamStatus beginFifoRead(void);
 
 	//**********************************************
 	//!
-	//! @brief  Set the white balance mode Manually
+	//! @brief Account for data read from the FIFO, clears the FIFO once the
+	//! frame is complete
 	//!
-	//! @param   mode White balance mode
+	//! @param  consumed Number of bytes read from the FIFO
+	//! @param  kept Number of bytes handed out, fewer with JPEG trimming
 	//!
 	//! @return Return operation status
+	//**********************************************
+	CamStatus finishFifoRead(size_t consumed, size_t kept);
+
+	//**********************************************
+	//!
+	//! @brief Check if reads of the current frame stop at the JPEG EOI
 	//!
+	//! @return Returns true for a JPEG capture with setJpegTrim() enabled
 	//**********************************************
-	CamStatus setAutoWhiteBalanceMode(CAM_WHITE_BALANCE mode);
+	bool isTrimmingJpeg(void) const;
 
 	//**********************************************
 	//!
-	//! @brief Set special effects
+	//! @brief Point the capture state machine at the next video frame
+	//**********************************************
+	void armVideoFrame(void);
+
+	//**********************************************
 	//!
-	//! @param  effect Special effects mode
+	//! @brief Abandon the asynchronous chunk, if any
+	//**********************************************
+	void cancelImageBufAsync(void);
+
+	//**********************************************
 	//!
-	//! @return Return operation status
+	//! @brief Count a completed capture in the latency histogram
 	//!
+	//! @param  us Trigger-to-done time in microseconds
 	//**********************************************
-	CamStatus setColorEffect(CAM_COLOR_FX effect);
+	void recordCaptureLatency(unsigned long us);
 
 	//**********************************************
 	//!
-	//! @brief Set SATURATION level
+	//! @brief Check the link with test patterns and the ID registers
 	//!
-	//! @param   level SATURATION level
+	//! @param  ids Expected CAM_REG_SENSOR_ID .. CAM_REG_DAY_ID values
 	//!
-	//! @return Return operation status
+	//! @return Returns true if every transfer came back intact
+	//**********************************************
+	bool verifyLink(const uint8_t* ids);
+
+	//**********************************************
+	//!
+	//! @brief Count a bus transfer and lower the clock after repeated errors
 	//!
+	//! @param  ok Transfer succeeded
 	//**********************************************
-	CamStatus setSaturation(CAM_SATURATION_LEVEL level);
+	void noteBusResult(bool ok);
 
 	//**********************************************
 	//!
-	//! @brief Set EV level
+	//! @brief Write raw bytes to the camera in a single I2C transaction
 	//!
-	//! @param  level EV level
+	//! @param  data Bytes to send, register address first
+	//! @param  length Number of bytes to send
 	//!
 	//! @return Return operation status
+	//**********************************************
+	CamStatus busWrite(const uint8_t* data, size_t length);
+
+	//**********************************************
+	//!
+	//! @brief Send a register address and read the reply after a repeated start
+	//!
+	//! @param  reg Register address
+	//! @param  buf Buffer for the received bytes
+	//! @param  length Number of bytes to read
 	//!
+	//! @return Returns the number of bytes actually received
 	//**********************************************
-	CamStatus setEV(CAM_EV_LEVEL level);
+	size_t busWriteRead(uint8_t reg, uint8_t* buf, size_t length);
 
+public:
 	//**********************************************
 	//!
-	//! @brief Set Contrast level
+	//! @brief Constructor of camera class
 	//!
-	//! @param  level Contrast level
 	//!
-	//! @return Return operation status
+	//**********************************************
+	Arducam_Qwiic_CAM(void); 
+
+	//**********************************************
+	//!
+	//! @brief Constructor of camera class on a specific bus backend
 	//!
+	//! @param  bus Bus backend the camera is attached to
 	//**********************************************
-	CamStatus setContrast(CAM_CONTRAST_LEVEL level);
+	explicit Arducam_Qwiic_CAM(Arducam_Qwiic_Bus& bus);
 
 	//**********************************************
 	//!
-	//! @brief Set Brightness level
+	//! @brief reset camera
 	//!
-	//! @param  level Brightness level
+	//! @note A video stream, capture or chunk read in progress is ended
+	//! first. The control values in use are kept, restoreSettings() writes
+	//! them back
+	//**********************************************
+	CamStatus reset(void); 
+
+	//**********************************************
 	//!
-	//! @return Return operation status
+	//! @brief Put the sensor in standby between captures
+	//!
+	//! @return Return operation status, CAM_ERR_BUSY while a capture or
+	//! video stream is running
 	//!
+	//! @note Captures fail with CAM_ERR_BUSY until wake()
 	//**********************************************
-	CamStatus setBrightness(CAM_BRIGHTNESS_LEVEL level);
+	CamStatus standby(void);
 
 	//**********************************************
 	//!
-	//! @brief Set Sharpness level
+	//! @brief Bring the sensor back from standby
 	//!
-	//! @param  level Sharpness level
+	//! @param  restore Write the control values in use before standby()
 	//!
 	//! @return Return operation status
 	//!
+	//! @note The first frame after wake is discarded with CAM_POLICY_WARMUP
 	//**********************************************
-	CamStatus setSharpness(CAM_SHARPNESS_LEVEL level);
+	CamStatus wake(bool restore = true);
 
 	//**********************************************
 	//!
-	//! @brief Set jpeg image quality
+	//! @brief Check if the sensor is in standby
 	//!
-	//! @param  quality Image Quality
+	//! @return Returns true between standby() and wake()
+	//**********************************************
+	bool isStandby() const;
+
+	//**********************************************
+	//!
+	//! @brief Write back the control values lost by reset() or standby()
 	//!
 	//! @return Return operation status
+	//!
+	//! @note All values go out in one batch with a single idle wait, values
+	//! staged since then take precedence. Format and resolution are left
+	//! to the next capture.
 	//**********************************************
-	CamStatus setImageQuality(IMAGE_QUALITY quality);
+	CamStatus restoreSettings(void);
 
 	//**********************************************
 	//!
-	//! @brief Write register
+	//! @brief Get the time from the last reset() or wake() to the first frame
 	//!
-	//! @param  reg Register address
-	//! @param  data Register value
+	//! @return Return the latency in microseconds, 0 until a frame that is
+	//! not discarded by the capture policy has completed
+	//**********************************************
+	unsigned long getStartupLatencyUs() const;
+
+	//**********************************************
 	//!
+	//! @brief Initialize the configuration of the camera module
 	//! @return Return operation status
 	//**********************************************
-	CamStatus writeReg(uint8_t, uint8_t);
+	CamStatus begin(void);
 
 	//**********************************************
 	//!
-	//! @brief Read register
+	//! @brief Initialize the camera and raise the bus clock as far as the
+	//! link allows
 	//!
-	//! @param  reg Register address
+	//! @param  maxClock Fastest clock to try, up to QWIIC_CAM_I2C_MAX_SPEED
 	//!
-	//! @return Returns the value of the register
+	//! @return Return operation status
+	//!
+	//! @note Steps up from QWIIC_CAM_I2C_SPEED through the Fast-mode Plus
+	//! rates. Each step must pass ARDUCHIP_TEST1 write/read patterns and
+	//! return the ID registers read at the base clock. Runtime errors
+	//! lower the clock again, see getBusClock().
 	//**********************************************
-	uint8_t readReg(uint8_t);
+	CamStatus begin(uint32_t maxClock);
 
 	//**********************************************
 	//!
-	//! @brief Read image data with specified length to buffer
+	//! @brief Get the bus clock in use
 	//!
-	//! @param  buf Buffer for storing camera data
-	//! @param  length The length of the image data to be read
+	//! @return Return the clock in Hz
+	//**********************************************
+	uint32_t getBusClock() const;
+
+	//**********************************************
 	//!
-	//! @return Returns the length actually read
+	//! @brief Get how often the clock was lowered after repeated bus errors
 	//!
+	//! @return Return the fallback count
 	//**********************************************
-	uint32_t readImageBuf(uint8_t*, uint32_t);
+	uint16_t getClockFallbacks() const;
 
 	//**********************************************
 	//!
-	//! @brief Clear FIFO and reset read/write pointers
+	//! @brief Start a snapshot with specified resolution and pixel format
+	//!
+	//! @param mode Resolution of the camera module
+	//! @param pixel_format Output image pixel format,which supports JPEG, RGB,
+	//! YUV
 	//!
 	//! @return Return operation status
+	//!
+	//! @note The mode parameter must be the resolution which the current camera
+	//! supported
+	//! @note Warm-up, reconfiguration and retries follow setCapturePolicy()
 	//**********************************************
-	CamStatus clearFIFO(void);
+	CamStatus takePicture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format);
 
 	//**********************************************
 	//!
-	//! @brief Read a byte from FIFO
+	//! @brief Select the sensor workarounds applied by takePicture()
 	//!
-	//! @return Returns Camera data
+	//! @param  policy CAM_CAPTURE_POLICY flags, CAM_POLICY_NONE after begin
+	//! @param  attempts Number of tries with CAM_POLICY_RETRY
 	//!
-	//! @note Before calling this function, make sure that the data is available
-	//! in the buffer
+	//! @note startCapture(), takeBurst() and video mode are not affected
 	//**********************************************
-	uint8_t readImageByte(void);
+	void setCapturePolicy(uint8_t policy, uint8_t attempts = QWIIC_CAM_CAPTURE_ATTEMPTS);
 
 	//**********************************************
 	//!
-	//! @brief Compare register bit
+	//! @brief Get the capture policy
 	//!
-	//! @param  addr Register address
-	//! @param  bit Bit number
+	//! @return Return the CAM_CAPTURE_POLICY flags
+	//**********************************************
+	uint8_t getCapturePolicy() const;
+
+	//**********************************************
 	//!
-	//! @return Returns comparison result
+	//! @brief Discard the next frame as if the sensor had just been reset
+	//!
+	//! @note Only has an effect with CAM_POLICY_WARMUP
 	//**********************************************
-	uint8_t getBit(uint8_t addr, uint8_t bit);
+	void requestWarmup(void);
 
 	//**********************************************
 	//!
-	//! @brief Get the length of the picture
+	//! @brief Get the frames spent by the capture policy
 	//!
-	//! @return Return the length of the picture
+	//! @return Return the counters since the last resetPolicyCounters()
 	//**********************************************
-	uint32_t getTotalLength(void);
+	const CamPolicyCounters& getPolicyCounters() const;
 
 	//**********************************************
 	//!
-	//! @brief Get the i2c state of the camera module
+	//! @brief Clear the capture policy counters
+	//**********************************************
+	void resetPolicyCounters(void);
+
+	//**********************************************
 	//!
-	//! @return Return operation status
+	//! @brief Start a snapshot without waiting for it to complete
+	//!
+	//! @param mode Resolution of the camera module
+	//! @param pixel_format Output image pixel format
+	//!
+	//! @return Return operation status, CAM_ERR_BUSY if a capture is still
+	//! being triggered
+	//!
+	//! @note Call poll() until it returns CAM_CAPTURE_READY, then read the
+	//! frame with readImageBuf()
 	//**********************************************
-	CamStatus waitI2cIdle(void);
+	CamStatus startCapture(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format);
 
 	//**********************************************
 	//!
-	//! @brief Get the length of the unreceived data
+	//! @brief Advance the capture started by startCapture()
 	//!
-	//! @return Return the length of the unreceived data
+	//! @return Return the capture state
+	//!
+	//! @note Never sleeps. Each call issues at most one status read while the
+	//! camera is busy, and none before getNextPollDelay() has elapsed.
 	//**********************************************
-	uint32_t getUnreceivedLength() const;
+	CAM_CAPTURE_STATE poll(void);
 
 	//**********************************************
 	//!
-	//! @brief Get the camera id
+	//! @brief Get the time until poll() will read the camera again
 	//!
-	//! @return Return the camera id
+	//! @return Return the delay in ms, 0 if the next poll() reads the camera
 	//**********************************************
-	uint8_t getCameraId() const;
+	unsigned long getNextPollDelay() const;
 
 	//**********************************************
 	//!
-	//! @brief Get the burst first flag
+	//! @brief Enable or disable adaptive completion polling
 	//!
-	//! @return Return the burst first flag
+	//! @param  enable When true, CAP_DONE is first read shortly before the
+	//! expected completion time, then with a growing interval capped at
+	//! QWIIC_CAM_POLL_MAX_INTERVAL_MS. When false, the camera is read every
+	//! 1 ms. Enabled by default.
 	//**********************************************
-	bool isBurstFirst() const;
+	void setAdaptivePolling(bool enable);
 
 	//**********************************************
 	//!
-	//! @brief Get the preview mode
+	//! @brief Check if adaptive completion polling is enabled
 	//!
-	//! @return Return the preview mode
+	//! @return Returns true if enabled
 	//**********************************************
-	uint8_t getPreviewMode() const;
+	bool getAdaptivePolling() const;
 
 	//**********************************************
 	//!
-	//! @brief Get the current pixel format
+	//! @brief Get the learned trigger-to-done time of a mode and pixel format
 	//!
-	//! @return Return the current pixel format
+	//! @param mode Resolution of the capture
+	//! @param pixel_format Pixel format of the capture
+	//!
+	//! @return Return the expected time in ms, 0 if nothing was learned yet
 	//**********************************************
-	uint8_t getCurrentPixelFormat() const;
+	uint16_t getLatencyEstimate(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format) const;
 
 	//**********************************************
 	//!
-	//! @brief Get the current picture mode
+	//! @brief Seed the trigger-to-done time of a mode and pixel format
 	//!
-	//! @return Return the current picture mode
+	//! @param mode Resolution of the capture
+	//! @param pixel_format Pixel format of the capture
+	//! @param ms Expected time in ms, 0 to forget the entry
 	//**********************************************
-	uint8_t getCurrentPictureMode() const;
+	void setLatencyEstimate(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format, uint16_t ms);
 
 	//**********************************************
 	//!
-	//! @brief Get the device address
+	//! @brief Forget all learned trigger-to-done times
+	//**********************************************
+	void resetLatencyModel(void);
+
+	//**********************************************
 	//!
-	//! @return Return the device address
+	//! @brief Get the capture state without touching the bus
+	//!
+	//! @return Return the capture state
 	//**********************************************
-	uint8_t getDeviceAddress() const;
+	CAM_CAPTURE_STATE getCaptureState() const;
 
 	//**********************************************
 	//!
-	//! @brief Set the device address
+	//! @brief Get the reason the last capture failed
 	//!
-	//! @param  addr Device address
+	//! @return Return operation status
 	//**********************************************
-	void setDeviceAddress(uint8_t addr);
+	CamStatus getCaptureError() const;
+
+	//**********************************************
+	//!
+	//! @brief Check if a captured frame is waiting to be read
+	//!
+	//! @return Returns true in CAM_CAPTURE_READY
+	//**********************************************
+	bool isFrameReady() const;
+
+	//**********************************************
+	//!
+	//! @brief Register a function called by poll() when a frame is ready
+	//!
+	//! @param  callback Function to call, NULL to remove it
+	//! @param  arg Argument passed to the callback
+	//**********************************************
+	void setFrameReadyCallback(CamFrameReadyCallback callback, void* arg = NULL);
+
+	//**********************************************
+	//!
+	//! @brief Put the sensor in JPEG video mode and trigger the first frame
+	//!
+	//! @param mode Video resolution
+	//!
+	//! @return Return operation status
+	//!
+	//! @note Format and resolution are written once for the whole stream.
+	//! The next frame is triggered as soon as the previous one has been
+	//! read out, so it is exposed while the caller ships the data. The FIFO
+	//! clear, trigger, CAP_DONE poll and length read remain per frame, the
+	//! ArduChip FIFO holds one frame and is only refilled on a trigger.
+	//**********************************************
+	CamStatus startVideo(CAM_VIDEO_MODE mode);
+
+	//**********************************************
+	//!
+	//! @brief Wait for the next video frame
+	//!
+	//! @param  seq Optional, receives the sequence number of the frame
+	//!
+	//! @return Return operation status
+	//!
+	//! @note Read the frame with readImageBuf() or readImageTo(). A frame that
+	//! is not read out completely is dropped by the next call.
+	//**********************************************
+	CamStatus nextFrame(uint32_t* seq = NULL);
+
+	//**********************************************
+	//!
+	//! @brief Leave video mode
+	//!
+	//! @return Return operation status
+	//**********************************************
+	CamStatus stopVideo(void);
+
+	//**********************************************
+	//!
+	//! @brief Check if the sensor is in video mode
+	//!
+	//! @return Returns true between startVideo() and stopVideo()
+	//**********************************************
+	bool isVideoActive() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the sequence number of the last video frame
+	//!
+	//! @return Return the sequence number, starting at 1 for the first frame
+	//**********************************************
+	uint32_t getFrameSequence() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the record of the last completed capture
+	//!
+	//! @return Return the frame info, updated again while the frame is read
+	//!
+	//! @note With video the next frame is triggered as soon as this one is
+	//! read, the record stays until that frame completes
+	//**********************************************
+	const CamFrameInfo& getFrameInfo() const;
+
+	//**********************************************
+	//!
+	//! @brief Capture several frames with a single trigger
+	//!
+	//! @param mode Resolution of the camera module
+	//! @param pixel_format Output image pixel format
+	//! @param frames Number of frames, 1 to CAPTURE_MAX_NUM
+	//!
+	//! @return Return operation status, CAM_ERR_INVALID for a mode without
+	//! a size, CAM_ERR_BUSY in standby or while a capture or video stream
+	//! is running
+	//!
+	//! @note Read the frames with nextBurstFrame() and readBurstFrame().
+	//! getTotalLength() returns the length of the whole burst.
+	//**********************************************
+	CamStatus takeBurst(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format, uint8_t frames);
+
+	//**********************************************
+	//!
+	//! @brief Move to the next frame of a burst capture
+	//!
+	//! @return Returns false when every frame has been visited
+	//!
+	//! @note Unread data of the current frame is skipped
+	//**********************************************
+	bool nextBurstFrame(void);
+
+	//**********************************************
+	//!
+	//! @brief Read data of the current burst frame
+	//!
+	//! @param  buf Buffer for storing camera data
+	//! @param  length Size of the buffer
+	//!
+	//! @return Returns the length actually read, 0 at the end of the frame
+	//!
+	//! @note JPEG frames are split on their SOI/EOI markers, padding between
+	//! frames is dropped. RGB565/Y8 frames are split by their fixed size.
+	//**********************************************
+	size_t readBurstFrame(uint8_t* buf, size_t length);
+
+	//**********************************************
+	//!
+	//! @brief Get the bytes read so far from the current burst frame
+	//!
+	//! @return Return the frame length, final once readBurstFrame() returns 0
+	//**********************************************
+	uint32_t getBurstFrameLength() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the index of the current burst frame
+	//!
+	//! @return Return the frame index, starting at 0
+	//**********************************************
+	uint8_t getBurstFrameIndex() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the image size of a resolution
+	//!
+	//! @param  mode Resolution of the camera module
+	//! @param  width Receives the width in pixels
+	//! @param  height Receives the height in pixels
+	//!
+	//! @return Returns false for an unknown resolution
+	//**********************************************
+	static bool getModeSize(CAM_IMAGE_MODE mode, uint16_t* width, uint16_t* height);
+
+	//**********************************************
+	//!
+	//! @brief  Set the white balance mode Manually
+	//!
+	//! @param   mode White balance mode
+	//!
+	//! @return Return operation status
+	//!
+	//**********************************************
+	CamStatus setAutoWhiteBalanceMode(CAM_WHITE_BALANCE mode);
+
+	//**********************************************
+	//!
+	//! @brief Set special effects
+	//!
+	//! @param  effect Special effects mode
+	//!
+	//! @return Return operation status
+	//!
+	//**********************************************
+	CamStatus setColorEffect(CAM_COLOR_FX effect);
+
+	//**********************************************
+	//!
+	//! @brief Set SATURATION level
+	//!
+	//! @param   level SATURATION level
+	//!
+	//! @return Return operation status
+	//!
+	//**********************************************
+	CamStatus setSaturation(CAM_SATURATION_LEVEL level);
+
+	//**********************************************
+	//!
+	//! @brief Set EV level
+	//!
+	//! @param  level EV level
+	//!
+	//! @return Return operation status
+	//!
+	//**********************************************
+	CamStatus setEV(CAM_EV_LEVEL level);
+
+	//**********************************************
+	//!
+	//! @brief Set Contrast level
+	//!
+	//! @param  level Contrast level
+	//!
+	//! @return Return operation status
+	//!
+	//**********************************************
+	CamStatus setContrast(CAM_CONTRAST_LEVEL level);
+
+	//**********************************************
+	//!
+	//! @brief Set Brightness level
+	//!
+	//! @param  level Brightness level
+	//!
+	//! @return Return operation status
+	//!
+	//**********************************************
+	CamStatus setBrightness(CAM_BRIGHTNESS_LEVEL level);
+
+	//**********************************************
+	//!
+	//! @brief Set Sharpness level
+	//!
+	//! @param  level Sharpness level
+	//!
+	//! @return Return operation status
+	//!
+	//**********************************************
+	CamStatus setSharpness(CAM_SHARPNESS_LEVEL level);
+
+	//**********************************************
+	//!
+	//! @brief Set jpeg image quality
+	//!
+	//! @param  quality Image Quality
+	//!
+	//! @return Return operation status
+	//**********************************************
+	CamStatus setImageQuality(IMAGE_QUALITY quality);
+
+	//**********************************************
+	//!
+	//! @brief Get the camera default settings
+	//!
+	//! @return Return the settings the camera starts with
+	//**********************************************
+	static CameraSettings defaultSettings(void);
+
+	//**********************************************
+	//!
+	//! @brief Apply several controls with a single idle wait
+	//!
+	//! @param  settings Control values to apply
+	//! @param  fields CAM_SETTING_FIELD bits to apply
+	//! @param  failed Optional, receives the CAM_SETTING_FIELD bits whose
+	//! write failed
+	//!
+	//! @return Return operation status
+	//!
+	//! @note Only fields that differ from the shadow registers are
+	//! written, see flushRegs()
+	//**********************************************
+	CamStatus applySettings(const CameraSettings& settings, uint8_t fields = CAM_SETTING_ALL, uint8_t* failed = NULL);
+
+	//**********************************************
+	//!
+	//! @brief Get the control values last written to the camera
+	//!
+	//! @return Return the applied settings, fields missing from
+	//! getAppliedMask() hold their defaults
+	//**********************************************
+	CameraSettings getAppliedSettings() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the fields of getAppliedSettings() that are known
+	//!
+	//! @return Return a CAM_SETTING_FIELD bit mask
+	//**********************************************
+	uint8_t getAppliedMask() const;
+
+	//**********************************************
+	//!
+	//! @brief Write register
+	//!
+	//! @param  reg Register address
+	//! @param  data Register value
+	//!
+	//! @return Return operation status
+	//**********************************************
+	CamStatus writeReg(uint8_t, uint8_t);
+
+	//**********************************************
+	//!
+	//! @brief Write a control register unless the shadow already holds the value
+	//!
+	//! @param  reg Register address
+	//! @param  value Register value
+	//!
+	//! @return Return operation status
+	//!
+	//! @note Waits for idle after a write. Registers outside the shadow
+	//! range are ignored.
+	//**********************************************
+	CamStatus writeControlReg(uint8_t reg, uint8_t value);
+
+	//**********************************************
+	//!
+	//! @brief Stage a control register value for the next flushRegs()
+	//!
+	//! @param  reg Register address
+	//! @param  value Register value
+	//**********************************************
+	void stageReg(uint8_t reg, uint8_t value);
+
+	//**********************************************
+	//!
+	//! @brief Write all staged control registers with a single idle wait
+	//!
+	//! @param  failed Optional, receives the shadow bits whose write failed
+	//!
+	//! @return Return operation status
+	//!
+	//! @note Failed registers stay staged and are retried on the next flush
+	//**********************************************
+	CamStatus flushRegs(uint32_t* failed = NULL);
+
+	//**********************************************
+	//!
+	//! @brief Forget the shadow registers so the next writes reach the camera
+	//**********************************************
+	void invalidateShadow(void);
+
+	//**********************************************
+	//!
+	//! @brief Mark the written shadow entries valid, the camera reported idle
+	//**********************************************
+	void commitShadow(void);
+
+	//**********************************************
+	//!
+	//! @brief Get the staged control registers
+	//!
+	//! @return Return a bit mask, bit n is register CAM_SHADOW_REG_BASE + n
+	//**********************************************
+	uint32_t getDirtyMask() const;
+
+	//**********************************************
+	//!
+	//! @brief Read register
+	//!
+	//! @param  reg Register address
+	//!
+	//! @return Returns the value of the register
+	//!
+	//! @note The sensor ID and firmware date registers are read from the
+	//! camera once and then served from a cache
+	//**********************************************
+	uint8_t readReg(uint8_t);
+
+	//**********************************************
+	//!
+	//! @brief Read image data with specified length to buffer
+	//!
+	//! @param  buf Buffer for storing camera data
+	//! @param  length The length of the image data to be read
+	//!
+	//! @return Returns the length actually read
+	//!
+	//! @note Data is read in bursts of getBurstSize() bytes
+	//**********************************************
+	size_t readImageBuf(uint8_t*, size_t);
+
+#if defined(ARDUINO)
+	//**********************************************
+	//!
+	//! @brief Stream the rest of the image to a sink
+	//!
+	//! @param  out Destination, e.g. a WiFiClient or Serial
+	//! @param  chunk Bytes per FIFO burst, 0 for getBurstSize()
+	//!
+	//! @return Returns the length actually read
+	//!
+	//! @note Data goes from the bus receive buffer to the sink through a
+	//! small stack block, no image buffer is needed
+	//**********************************************
+	size_t readImageTo(Print& out, size_t chunk = 0);
+#endif
+
+	//**********************************************
+	//!
+	//! @brief Start reading the next image chunk in the background
+	//!
+	//! @param  buf Buffer for the chunk, must stay valid until waitImageBuf()
+	//! @param  length Buffer size, at most getBurstSize() bytes are read
+	//!
+	//! @return Returns the length requested, 0 if the frame is fully read or
+	//! a chunk is already pending
+	//!
+	//! @note On backends without asynchronous receive the chunk is read
+	//! before this returns. Make no other camera call until waitImageBuf().
+	//! With JPEG trimming, pass at least 2 bytes: in front of the SOI a
+	//! 0xFF may be carried into the next chunk.
+	//**********************************************
+	size_t readImageBufAsync(uint8_t* buf, size_t length);
+
+	//**********************************************
+	//!
+	//! @brief Check whether the chunk started with readImageBufAsync() has arrived
+	//!
+	//! @return Returns true if waitImageBuf() will not block
+	//**********************************************
+	bool isImageBufReady(void);
+
+	//**********************************************
+	//!
+	//! @brief Wait for the chunk started with readImageBufAsync()
+	//!
+	//! @param  received Set to the image bytes in the chunk
+	//! @param  timeoutMs Longest wait for the chunk
+	//!
+	//! @return Return operation status, CAM_ERR_TIMEOUT if the chunk did not
+	//! arrive in time, CAM_ERR_NO_CALLBACK if the bus returned no data
+	//!
+	//! @note After an error the rest of the frame is still in the FIFO, read
+	//! it again or call clearFIFO()
+	//**********************************************
+	CamStatus waitImageBuf(size_t* received, uint32_t timeoutMs = QWIIC_CAM_CHUNK_TIMEOUT_MS);
+
+#if defined(ARDUINO)
+	//**********************************************
+	//!
+	//! @brief Stream the rest of the image through two alternating buffers
+	//!
+	//! @param  out Destination, e.g. a WiFiClient or Serial
+	//! @param  bufA First chunk buffer
+	//! @param  bufB Second chunk buffer
+	//! @param  length Size of each buffer
+	//!
+	//! @return Returns the length actually read
+	//!
+	//! @note The next chunk is read while the previous one is written to
+	//! out. Without an asynchronous backend, prefer readImageTo().
+	//**********************************************
+	size_t readImageToAsync(Print& out, uint8_t* bufA, uint8_t* bufB, size_t length);
+#endif
+
+	//**********************************************
+	//!
+	//! @brief Hand out JPEG frames from the start to the end-of-image marker
+	//!
+	//! @param  enable Enable or disable JPEG trimming
+	//!
+	//! @note When enabled, the image reads drop the bytes in front of FF D8
+	//! and follow the marker segments to the FF D9 that ends the image.
+	//! Segment payloads are skipped by their length, so the EOI of an EXIF
+	//! thumbnail does not end the image. Once the EOI is read, the FIFO is
+	//! cleared without reading the padding behind it.
+	//**********************************************
+	void setJpegTrim(bool enable);
+
+	//**********************************************
+	//!
+	//! @brief Get the JPEG trimming setting
+	//!
+	//! @return Returns true if JPEG trimming is enabled
+	//**********************************************
+	bool getJpegTrim() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the image bytes read so far from the current frame
+	//!
+	//! @return Return the image length, the true JPEG size once
+	//! isImageComplete() is true with trimming enabled
+	//**********************************************
+	uint32_t getImageLength() const;
+
+	//**********************************************
+	//!
+	//! @brief Check if the current frame has been read out
+	//!
+	//! @return Returns true after the last byte or the JPEG EOI was read
+	//**********************************************
+	bool isImageComplete() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the length of one FIFO burst read
+	//!
+	//! @return Return the burst length, bounded by the bus receive buffer
+	//**********************************************
+	size_t getBurstSize() const;
+
+	//**********************************************
+	//!
+	//! @brief Set the length of one FIFO burst read
+	//!
+	//! @param  size Burst length in bytes, 0 to use the bus maximum
+	//!
+	//! @note The value is clamped to the bus receive buffer
+	//**********************************************
+	void setBurstSize(size_t size);
+
+	//**********************************************
+	//!
+	//! @brief Clear FIFO and reset read/write pointers
+	//!
+	//! @return Return operation status
+	//**********************************************
+	CamStatus clearFIFO(void);
+
+	//**********************************************
+	//!
+	//! @brief Read a byte from FIFO
+	//!
+	//! @return Returns Camera data
+	//!
+	//! @note Before calling this function, make sure that the data is available
+	//! in the buffer
+	//**********************************************
+	uint8_t readImageByte(void);
+
+	//**********************************************
+	//!
+	//! @brief Compare register bit
+	//!
+	//! @param  addr Register address
+	//! @param  bit Bit number
+	//!
+	//! @return Returns comparison result
+	//**********************************************
+	uint8_t getBit(uint8_t addr, uint8_t bit);
+
+	//**********************************************
+	//!
+	//! @brief Get the length of the picture
+	//!
+	//! @return Return the length of the picture
+	//**********************************************
+	uint32_t getTotalLength(void);
+
+	//**********************************************
+	//!
+	//! @brief Get the i2c state of the camera module
+	//!
+	//! @return Return operation status
+	//**********************************************
+	CamStatus waitI2cIdle(void);
+
+	//**********************************************
+	//!
+	//! @brief Collect bus and capture counters
+	//!
+	//! @param  storage Counters to update, cleared here, NULL to stop
+	//!
+	//! @note Counting is only compiled in with QWIIC_CAM_ENABLE_STATS set
+	//! to 1 for the library build. The class layout is the same either way.
+	//**********************************************
+	void setStats(CamStats* storage);
+
+	//**********************************************
+	//!
+	//! @brief Get the collected bus and capture counters
+	//!
+	//! @return Return the storage given to setStats(), NULL if none
+	//**********************************************
+	const CamStats* getStats() const;
+
+	//**********************************************
+	//!
+	//! @brief Clear the collected counters
+	//**********************************************
+	void resetStats(void);
+
+	//**********************************************
+	//!
+	//! @brief Get the drain throughput of the drained frames
+	//!
+	//! @return Return the throughput in bytes per second
+	//**********************************************
+	uint32_t getDrainBytesPerSecond() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the length of the unreceived data
+	//!
+	//! @return Return the length of the unreceived data
+	//**********************************************
+	uint32_t getUnreceivedLength() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the camera id
+	//!
+	//! @return Return the camera id
+	//**********************************************
+	uint8_t getCameraId() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the burst first flag
+	//!
+	//! @return Return the burst first flag
+	//**********************************************
+	bool isBurstFirst() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the preview mode
+	//!
+	//! @return Return the preview mode
+	//**********************************************
+	uint8_t getPreviewMode() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the current pixel format
+	//!
+	//! @return Return the current pixel format
+	//**********************************************
+	uint8_t getCurrentPixelFormat() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the current picture mode
+	//!
+	//! @return Return the current picture mode
+	//**********************************************
+	uint8_t getCurrentPictureMode() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the device address
+	//!
+	//! @return Return the device address
+	//**********************************************
+	uint8_t getDeviceAddress() const;
+
+	//**********************************************
+	//!
+	//! @brief Set the device address
+	//!
+	//! @param  addr Device address
+	//**********************************************
+	void setDeviceAddress(uint8_t addr);
+
+	//**********************************************
+	//!
+	//! @brief Get the bus backend
+	//!
+	//! @return Return the bus backend, NULL if none is attached
+	//**********************************************
+	Arducam_Qwiic_Bus* getBus() const;
+
+	//**********************************************
+	//!
+	//! @brief Attach the camera to another bus backend
+	//!
+	//! @param  bus Bus backend the camera is attached to
+	//**********************************************
+	void setBus(Arducam_Qwiic_Bus& bus);
 
 	//**********************************************
 	//!
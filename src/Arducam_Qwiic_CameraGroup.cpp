@@ -0,0 +1,190 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_CameraGroup.h"
+
+Arducam_Qwiic_CameraGroup::Arducam_Qwiic_CameraGroup()
+{
+    count = 0;
+    orderHead = 0;
+    orderTail = 0;
+    for (uint8_t i = 0; i < QWIIC_CAM_GROUP_MAX; i++) {
+        cams[i] = NULL;
+        slotState[i] = CAM_GROUP_SLOT_IDLE;
+        triggerUs[i] = 0;
+        doneUs[i] = 0;
+    }
+}
+
+bool Arducam_Qwiic_CameraGroup::add(Arducam_Qwiic_CAM& cam)
+{
+    if (count >= QWIIC_CAM_GROUP_MAX) {
+        return false;
+    }
+    cams[count++] = &cam;
+    return true;
+}
+
+uint8_t Arducam_Qwiic_CameraGroup::size() const
+{
+    return count;
+}
+
+Arducam_Qwiic_CAM& Arducam_Qwiic_CameraGroup::getCamera(uint8_t index)
+{
+    return *cams[index];
+}
+
+CamStatus Arducam_Qwiic_CameraGroup::trigger(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format)
+{
+    CamStatus ret = CAM_ERR_NONE;
+    orderHead = 0;
+    orderTail = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        CamStatus err = cams[i]->startCapture(mode, pixel_format);
+        slotState[i] = (err == CAM_ERR_NONE) ? CAM_GROUP_SLOT_ARMING : CAM_GROUP_SLOT_FAILED;
+        if (ret == CAM_ERR_NONE) {
+            ret = err;
+        }
+    }
+
+    // Step all cameras round-robin so one camera's idle waits overlap the
+    // others' register writes and the triggers land close together
+    bool arming = true;
+    while (arming) {
+        arming = false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (slotState[i] != CAM_GROUP_SLOT_ARMING) {
+                continue;
+            }
+            CAM_CAPTURE_STATE state = cams[i]->poll();
+            if (state == CAM_CAPTURE_ERROR) {
+                slotState[i] = CAM_GROUP_SLOT_FAILED;
+                if (ret == CAM_ERR_NONE) {
+                    ret = cams[i]->getCaptureError();
+                }
+            } else if (state >= CAM_CAPTURE_WAITING) {
+                triggerUs[i] = cams[i]->getFrameInfo().triggerUs;
+                slotState[i] = CAM_GROUP_SLOT_WAITING;
+            } else {
+                arming = true;
+            }
+        }
+        if (arming) {
+            delay(nextPollDelay());
+        }
+    }
+
+    poll();
+    return ret;
+}
+
+void Arducam_Qwiic_CameraGroup::poll(void)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        if (slotState[i] != CAM_GROUP_SLOT_WAITING) {
+            continue;
+        }
+        CAM_CAPTURE_STATE state = cams[i]->poll();
+        if (state == CAM_CAPTURE_READY) {
+            doneUs[i] = cams[i]->getFrameInfo().doneUs;
+            slotState[i] = CAM_GROUP_SLOT_READY;
+            order[orderTail++] = i;
+        } else if (state == CAM_CAPTURE_ERROR) {
+            slotState[i] = CAM_GROUP_SLOT_FAILED;
+        }
+    }
+}
+
+unsigned long Arducam_Qwiic_CameraGroup::nextPollDelay() const
+{
+    unsigned long shortest = 1;
+    bool found = false;
+    for (uint8_t i = 0; i < count; i++) {
+        if (slotState[i] != CAM_GROUP_SLOT_ARMING && slotState[i] != CAM_GROUP_SLOT_WAITING) {
+            continue;
+        }
+        unsigned long wait = cams[i]->getNextPollDelay();
+        if (!found || wait < shortest) {
+            shortest = wait;
+            found = true;
+        }
+    }
+    return shortest;
+}
+
+int8_t Arducam_Qwiic_CameraGroup::nextReady(bool wait)
+{
+    while (true) {
+        poll();
+        if (orderHead < orderTail) {
+            uint8_t index = order[orderHead++];
+            slotState[index] = CAM_GROUP_SLOT_DRAINING;
+            return index;
+        }
+        if (!wait || pending() == 0) {
+            return -1;
+        }
+        delay(nextPollDelay());
+    }
+}
+
+uint8_t Arducam_Qwiic_CameraGroup::pending() const
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (slotState[i] == CAM_GROUP_SLOT_ARMING || slotState[i] == CAM_GROUP_SLOT_WAITING ||
+            slotState[i] == CAM_GROUP_SLOT_READY) {
+            n++;
+        }
+    }
+    return n;
+}
+
+CAM_GROUP_SLOT Arducam_Qwiic_CameraGroup::getSlotState(uint8_t index) const
+{
+    return (CAM_GROUP_SLOT)slotState[index];
+}
+
+unsigned long Arducam_Qwiic_CameraGroup::getTriggerSkewUs() const
+{
+    bool found = false;
+    unsigned long first = 0;
+    unsigned long last = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (slotState[i] < CAM_GROUP_SLOT_WAITING || slotState[i] > CAM_GROUP_SLOT_DRAINING) {
+            continue;
+        }
+        if (!found) {
+            first = triggerUs[i];
+            last = triggerUs[i];
+            found = true;
+            continue;
+        }
+        if ((long)(triggerUs[i] - first) < 0) {
+            first = triggerUs[i];
+        }
+        if ((long)(triggerUs[i] - last) > 0) {
+            last = triggerUs[i];
+        }
+    }
+    return last - first;
+}
+
+unsigned long Arducam_Qwiic_CameraGroup::getTriggerUs(uint8_t index) const
+{
+    return triggerUs[index];
+}
+
+unsigned long Arducam_Qwiic_CameraGroup::getDoneUs(uint8_t index) const
+{
+    return doneUs[index];
+}
@@ -0,0 +1,187 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_CAMERA_GROUP_H
+#define __ARDUCAM_QWIIC_CAMERA_GROUP_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+/**
+* @file Arducam_Qwiic_CameraGroup.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+#if !defined(QWIIC_CAM_GROUP_MAX)
+#define QWIIC_CAM_GROUP_MAX 4 // Cameras per group
+#endif
+
+/**
+ * @enum CAM_GROUP_SLOT
+ * @brief State of one camera in a group capture
+ */
+typedef enum {
+    CAM_GROUP_SLOT_IDLE = 0,   /**< Not part of the current capture */
+    CAM_GROUP_SLOT_ARMING,     /**< Format, resolution and trigger being written */
+    CAM_GROUP_SLOT_WAITING,    /**< Triggered, waiting for CAP_DONE */
+    CAM_GROUP_SLOT_READY,      /**< Frame done, queued for draining */
+    CAM_GROUP_SLOT_DRAINING,   /**< Handed out by nextReady() */
+    CAM_GROUP_SLOT_FAILED      /**< Capture failed, see getCaptureError() */
+} CAM_GROUP_SLOT;
+
+/**
+* @brief Several cameras triggered together and drained in completion order
+*
+* trigger() writes the capture steps of all cameras round-robin so their
+* triggers land close together, then each camera exposes in parallel.
+* Finished frames are handed out by nextReady() in the order the cameras
+* completed. The cameras may use different addresses or buses.
+*/
+class Arducam_Qwiic_CameraGroup
+{
+private:
+	Arducam_Qwiic_CAM* cams[QWIIC_CAM_GROUP_MAX];       /**< Cameras of the group */
+	uint8_t slotState[QWIIC_CAM_GROUP_MAX];             /**< CAM_GROUP_SLOT of each camera */
+	unsigned long triggerUs[QWIIC_CAM_GROUP_MAX];       /**< Time each camera was triggered */
+	unsigned long doneUs[QWIIC_CAM_GROUP_MAX];          /**< Time each camera reported CAP_DONE */
+	uint8_t order[QWIIC_CAM_GROUP_MAX];                 /**< Finished cameras in completion order */
+	uint8_t orderHead;                                  /**< Next entry of order to hand out */
+	uint8_t orderTail;                                  /**< Next free entry of order */
+	uint8_t count;                                      /**< Number of cameras in the group */
+
+	//**********************************************
+	//!
+	//! @brief Get the shortest time until a pending camera needs polling
+	//!
+	//! @return Return the delay in ms
+	//**********************************************
+	unsigned long nextPollDelay() const;
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the camera group
+	//**********************************************
+	Arducam_Qwiic_CameraGroup();
+
+	//**********************************************
+	//!
+	//! @brief Add a camera to the group
+	//!
+	//! @param  cam Camera, begin() must have been called
+	//!
+	//! @return Returns false if the group is full
+	//**********************************************
+	bool add(Arducam_Qwiic_CAM& cam);
+
+	//**********************************************
+	//!
+	//! @brief Get the number of cameras in the group
+	//!
+	//! @return Return the camera count
+	//**********************************************
+	uint8_t size() const;
+
+	//**********************************************
+	//!
+	//! @brief Get a camera of the group
+	//!
+	//! @param  index Index in the order the cameras were added
+	//!
+	//! @return Return the camera
+	//**********************************************
+	Arducam_Qwiic_CAM& getCamera(uint8_t index);
+
+	//**********************************************
+	//!
+	//! @brief Trigger a capture on every camera
+	//!
+	//! @param mode Resolution of the capture
+	//! @param pixel_format Output image pixel format
+	//!
+	//! @return Return the first error, CAM_ERR_NONE if all cameras were
+	//! triggered
+	//!
+	//! @note Returns once every camera is triggered, without waiting for the
+	//! frames. A camera that fails is skipped by nextReady().
+	//**********************************************
+	CamStatus trigger(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format);
+
+	//**********************************************
+	//!
+	//! @brief Poll the triggered cameras once
+	//!
+	//! @note Never sleeps. Finished cameras are queued for nextReady().
+	//**********************************************
+	void poll(void);
+
+	//**********************************************
+	//!
+	//! @brief Get the next camera whose frame is ready
+	//!
+	//! @param  wait Block until a frame is ready or no capture is pending
+	//!
+	//! @return Return the camera index, -1 if none is ready
+	//!
+	//! @note Read the frame with getCamera(index).readImageBuf() or
+	//! readImageTo() before asking for the next one if the cameras share a
+	//! bus.
+	//**********************************************
+	int8_t nextReady(bool wait = true);
+
+	//**********************************************
+	//!
+	//! @brief Get the number of cameras not yet handed out by nextReady()
+	//!
+	//! @return Return the number of waiting and queued cameras
+	//**********************************************
+	uint8_t pending() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the state of a camera in the current capture
+	//!
+	//! @param  index Camera index
+	//!
+	//! @return Return the slot state
+	//**********************************************
+	CAM_GROUP_SLOT getSlotState(uint8_t index) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the spread between the first and last trigger
+	//!
+	//! @return Return the skew in microseconds
+	//**********************************************
+	unsigned long getTriggerSkewUs() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the time a camera was triggered
+	//!
+	//! @param  index Camera index
+	//!
+	//! @return Return the micros() timestamp of the trigger
+	//**********************************************
+	unsigned long getTriggerUs(uint8_t index) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the time a camera finished its capture
+	//!
+	//! @param  index Camera index
+	//!
+	//! @return Return the micros() timestamp of CAP_DONE
+	//**********************************************
+	unsigned long getDoneUs(uint8_t index) const;
+};
+
+#endif /*__ARDUCAM_QWIIC_CAMERA_GROUP_H*/
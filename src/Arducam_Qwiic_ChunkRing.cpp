@@ -0,0 +1,234 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_ChunkRing.h"
+#include <string.h>
+
+#if defined(__AVR__)
+#include <util/atomic.h>
+
+// avr-gcc has no lock-free 32-bit atomics, a short interrupt lock keeps the
+// counters whole instead. cli/sei are compiler barriers, so the order holds.
+static inline uint32_t ringLoad(const uint32_t* p)
+{
+    uint32_t value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        value = *(const volatile uint32_t*)p;
+    }
+    return value;
+}
+
+static inline void ringStore(uint32_t* p, uint32_t value)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *(volatile uint32_t*)p = value;
+    }
+}
+
+#define RING_LOAD(p, order)         ringLoad(p)
+#define RING_STORE(p, value, order) ringStore(p, value)
+#else
+#define RING_LOAD(p, order)         __atomic_load_n(p, order)
+#define RING_STORE(p, value, order) __atomic_store_n(p, value, order)
+#endif
+
+Arducam_Qwiic_ChunkRing::Arducam_Qwiic_ChunkRing()
+{
+    arena = NULL;
+    slotCount = 0;
+    chunkSize = 0;
+    head = 0;
+    tail = 0;
+    abortPending = false;
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool Arducam_Qwiic_ChunkRing::begin(uint8_t* arena, size_t size, uint16_t chunk)
+{
+    size_t stride = (size_t)chunk + CAM_RING_SLOT_HEADER;
+    size_t slots = (arena != NULL && chunk > 0) ? size / stride : 0;
+    if (slots < 2) {
+        return false;
+    }
+    if (slots > 0x8000) {
+        slots = 0x8000;
+    }
+    // Head and tail run free through 2^32, a power of two keeps their slot
+    // index continuous across the wrap
+    while (slots & (slots - 1)) {
+        slots &= slots - 1;
+    }
+
+    this->arena = arena;
+    slotCount = (uint16_t)slots;
+    chunkSize = chunk;
+    head = 0;
+    tail = 0;
+    abortPending = false;
+    memset(&stats, 0, sizeof(stats));
+    return true;
+}
+
+uint8_t* Arducam_Qwiic_ChunkRing::slot(uint32_t index) const
+{
+    return arena + (size_t)(index & (slotCount - 1)) * ((size_t)chunkSize + CAM_RING_SLOT_HEADER);
+}
+
+void Arducam_Qwiic_ChunkRing::count(uint32_t* counter)
+{
+    // Only one side writes each counter, the atomics keep the other side's reads whole
+    RING_STORE(counter, RING_LOAD(counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+uint8_t* Arducam_Qwiic_ChunkRing::acquire(void)
+{
+    uint32_t h = RING_LOAD(&head, __ATOMIC_RELAXED);
+    uint32_t t = RING_LOAD(&tail, __ATOMIC_ACQUIRE);
+    if (slotCount == 0 || h - t >= slotCount) {
+        return NULL;
+    }
+    return slot(h) + CAM_RING_SLOT_HEADER;
+}
+
+void Arducam_Qwiic_ChunkRing::commit(uint16_t length, uint8_t flags)
+{
+    uint32_t h = RING_LOAD(&head, __ATOMIC_RELAXED);
+    uint8_t* s = slot(h);
+    s[0] = (uint8_t)length;
+    s[1] = (uint8_t)(length >> 8);
+    s[2] = flags;
+    count(&stats.chunksQueued);
+    if (flags & CAM_RING_FRAME_END) {
+        count(&stats.framesQueued);
+    }
+    // Publish the chunk after its data and header
+    RING_STORE(&head, h + 1, __ATOMIC_RELEASE);
+}
+
+bool Arducam_Qwiic_ChunkRing::push(const uint8_t* data, uint16_t length, uint8_t flags)
+{
+    uint8_t* dst = acquire();
+    if (dst == NULL) {
+        return false;
+    }
+    if (length > chunkSize) {
+        length = chunkSize;
+    }
+    memcpy(dst, data, length);
+    commit(length, flags);
+    return true;
+}
+
+CamStatus Arducam_Qwiic_ChunkRing::produceFrame(Arducam_Qwiic_CAM& cam, uint32_t waitMs)
+{
+    bool started = false;
+    bool waiting = false;
+    unsigned long waitStartMs = 0;
+
+    while (abortPending || cam.getUnreceivedLength() > 0) {
+        uint8_t* data = acquire();
+        if (data == NULL) {
+            if (!waiting) {
+                count(&stats.fullWaits);
+                waiting = true;
+                waitStartMs = millis();
+            }
+            if (millis() - waitStartMs >= waitMs) {
+                // The consumer is too slow, give up on this frame
+                count(&stats.framesDropped);
+                abortPending = abortPending || started;
+                CAM_RETURN_IF_ERR(cam.clearFIFO());
+                return CAM_ERR_TIMEOUT;
+            }
+            delay(1);
+            continue;
+        }
+        waiting = false;
+
+        if (abortPending) {
+            commit(0, CAM_RING_FRAME_ABORT);
+            abortPending = false;
+            continue;
+        }
+
+        size_t n = cam.readImageBuf(data, chunkSize);
+        if (n == 0) {
+            count(&stats.framesDropped);
+            abortPending = started;
+            cam.clearFIFO();
+            return CAM_ERR_NO_CALLBACK;
+        }
+        uint8_t flags = started ? 0 : CAM_RING_FRAME_START;
+        if (cam.getUnreceivedLength() == 0) {
+            flags |= CAM_RING_FRAME_END;
+        }
+        commit((uint16_t)n, flags);
+        started = true;
+    }
+    return CAM_ERR_NONE;
+}
+
+const uint8_t* Arducam_Qwiic_ChunkRing::peek(uint16_t* length, uint8_t* flags)
+{
+    uint32_t t = RING_LOAD(&tail, __ATOMIC_RELAXED);
+    uint32_t h = RING_LOAD(&head, __ATOMIC_ACQUIRE);
+    if (h == t) {
+        return NULL;
+    }
+    const uint8_t* s = slot(t);
+    if (length != NULL) {
+        *length = (uint16_t)(s[0] | (s[1] << 8));
+    }
+    if (flags != NULL) {
+        *flags = s[2];
+    }
+    return s + CAM_RING_SLOT_HEADER;
+}
+
+void Arducam_Qwiic_ChunkRing::release(void)
+{
+    uint32_t t = RING_LOAD(&tail, __ATOMIC_RELAXED);
+    if (t == RING_LOAD(&head, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    count(&stats.chunksRead);
+    // Hand the slot back only after the consumer is done with it
+    RING_STORE(&tail, t + 1, __ATOMIC_RELEASE);
+}
+
+uint16_t Arducam_Qwiic_ChunkRing::available(void) const
+{
+    uint32_t t = RING_LOAD(&tail, __ATOMIC_ACQUIRE);
+    uint32_t h = RING_LOAD(&head, __ATOMIC_ACQUIRE);
+    return (uint16_t)(h - t);
+}
+
+uint16_t Arducam_Qwiic_ChunkRing::getChunkSize() const
+{
+    return chunkSize;
+}
+
+uint16_t Arducam_Qwiic_ChunkRing::getSlotCount() const
+{
+    return slotCount;
+}
+
+CamRingStats Arducam_Qwiic_ChunkRing::getStats() const
+{
+    CamRingStats snapshot;
+    snapshot.framesQueued = RING_LOAD(&stats.framesQueued, __ATOMIC_RELAXED);
+    snapshot.framesDropped = RING_LOAD(&stats.framesDropped, __ATOMIC_RELAXED);
+    snapshot.chunksQueued = RING_LOAD(&stats.chunksQueued, __ATOMIC_RELAXED);
+    snapshot.chunksRead = RING_LOAD(&stats.chunksRead, __ATOMIC_RELAXED);
+    snapshot.fullWaits = RING_LOAD(&stats.fullWaits, __ATOMIC_RELAXED);
+    return snapshot;
+}
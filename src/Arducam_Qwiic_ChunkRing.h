@@ -0,0 +1,199 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_CHUNKRING_H
+#define __ARDUCAM_QWIIC_CHUNKRING_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+/**
+* @file Arducam_Qwiic_ChunkRing.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+#define CAM_RING_SLOT_HEADER          4   // Length and flags stored in front of each chunk
+
+/**
+ * @enum CAM_RING_FLAG
+ * @brief Flags of a ring chunk, OR-ed together
+ */
+typedef enum {
+    CAM_RING_FRAME_START = 0x01, /**< First chunk of a frame */
+    CAM_RING_FRAME_END   = 0x02, /**< Last chunk of a frame */
+    CAM_RING_FRAME_ABORT = 0x04  /**< Empty chunk, the frame in progress was dropped */
+} CAM_RING_FLAG;
+
+/**
+ * @struct CamRingStats
+ * @brief Counters of a chunk ring
+ */
+typedef struct {
+    uint32_t framesQueued;     /**< Frames completely queued by the producer */
+    uint32_t framesDropped;    /**< Frames dropped because the ring stayed full */
+    uint32_t chunksQueued;     /**< Chunks committed by the producer */
+    uint32_t chunksRead;       /**< Chunks released by the consumer */
+    uint32_t fullWaits;        /**< Times the producer found the ring full */
+} CamRingStats;
+
+/**
+* @brief Lock-free single-producer/single-consumer ring of frame chunks
+*
+* The ring lives in an arena supplied by the caller and is split into
+* fixed slots. One task or core drains the camera with produceFrame() or
+* acquire()/commit(), another ships the chunks with peek()/release(). The
+* two sides only share the head and tail counters, published with
+* acquire/release atomics, so no lock is needed on dual-core boards. AVR
+* boards, which have no 32-bit atomics, briefly block interrupts instead.
+*
+* @note Exactly one producer and one consumer may use a ring at a time
+*/
+class Arducam_Qwiic_ChunkRing
+{
+private:
+	uint8_t* arena;                                     /**< Slot storage */
+	uint16_t slotCount;                                 /**< Number of slots */
+	uint16_t chunkSize;                                 /**< Data bytes per slot */
+	uint32_t head;                                      /**< Slots committed, written by the producer */
+	uint32_t tail;                                      /**< Slots released, written by the consumer */
+	bool abortPending;                                  /**< An ABORT marker still has to be queued */
+	CamRingStats stats;                                 /**< Counters, each written by one side only */
+
+	//**********************************************
+	//!
+	//! @brief Get the storage of a slot
+	//!
+	//! @return Return the slot header address
+	//**********************************************
+	uint8_t* slot(uint32_t index) const;
+
+	//**********************************************
+	//!
+	//! @brief Increment a counter that the other side may read
+	//**********************************************
+	static void count(uint32_t* counter);
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the chunk ring
+	//**********************************************
+	Arducam_Qwiic_ChunkRing();
+
+	//**********************************************
+	//!
+	//! @brief Split an arena into slots
+	//!
+	//! @param  arena Storage, kept by the ring until the next begin()
+	//! @param  size Arena size in bytes
+	//! @param  chunk Data bytes per slot
+	//!
+	//! @return Returns false if the arena holds fewer than 2 slots
+	//!
+	//! @note Call before the producer and consumer start. The slot count is
+	//! rounded down to a power of two, at most 32768.
+	//**********************************************
+	bool begin(uint8_t* arena, size_t size, uint16_t chunk);
+
+	//**********************************************
+	//!
+	//! @brief Get the free slot for the next chunk (producer)
+	//!
+	//! @return Return chunkSize bytes to fill, NULL if the ring is full
+	//**********************************************
+	uint8_t* acquire(void);
+
+	//**********************************************
+	//!
+	//! @brief Publish the slot returned by acquire() (producer)
+	//!
+	//! @param  length Bytes filled
+	//! @param  flags CAM_RING_FLAG bits
+	//**********************************************
+	void commit(uint16_t length, uint8_t flags);
+
+	//**********************************************
+	//!
+	//! @brief Copy one chunk into the ring (producer)
+	//!
+	//! @param  data Chunk data
+	//! @param  length Chunk length, at most getChunkSize()
+	//! @param  flags CAM_RING_FLAG bits
+	//!
+	//! @return Returns false if the ring is full
+	//**********************************************
+	bool push(const uint8_t* data, uint16_t length, uint8_t flags);
+
+	//**********************************************
+	//!
+	//! @brief Read the frame waiting in the camera FIFO into the ring (producer)
+	//!
+	//! @param  cam Camera holding the frame
+	//! @param  waitMs How long to wait for a free slot before dropping the frame
+	//!
+	//! @return Return operation status, CAM_ERR_TIMEOUT if the frame was dropped
+	//!
+	//! @note A dropped frame is cleared from the FIFO. If part of it was
+	//! queued, a CAM_RING_FRAME_ABORT chunk follows as soon as a slot is free.
+	//**********************************************
+	CamStatus produceFrame(Arducam_Qwiic_CAM& cam, uint32_t waitMs = 0);
+
+	//**********************************************
+	//!
+	//! @brief Get the oldest chunk (consumer)
+	//!
+	//! @param  length Set to the chunk length
+	//! @param  flags Set to the CAM_RING_FLAG bits, may be NULL
+	//!
+	//! @return Return the chunk data, NULL if the ring is empty
+	//**********************************************
+	const uint8_t* peek(uint16_t* length, uint8_t* flags);
+
+	//**********************************************
+	//!
+	//! @brief Free the chunk returned by peek() (consumer)
+	//**********************************************
+	void release(void);
+
+	//**********************************************
+	//!
+	//! @brief Get the number of queued chunks
+	//!
+	//! @return Return the chunk count, exact on either side
+	//**********************************************
+	uint16_t available(void) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the data bytes per slot
+	//!
+	//! @return Return the chunk size
+	//**********************************************
+	uint16_t getChunkSize() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the number of slots
+	//!
+	//! @return Return the slot count
+	//**********************************************
+	uint16_t getSlotCount() const;
+
+	//**********************************************
+	//!
+	//! @brief Get a snapshot of the counters
+	//!
+	//! @return Return the counters, safe to call from either side
+	//**********************************************
+	CamRingStats getStats() const;
+};
+
+#endif /*__ARDUCAM_QWIIC_CHUNKRING_H*/
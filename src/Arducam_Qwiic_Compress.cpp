@@ -0,0 +1,235 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_Compress.h"
+#include <string.h>
+
+static uint8_t pixelBytes(CAM_IMAGE_PIX_FMT pixel_format)
+{
+    switch (pixel_format) {
+    case CAM_IMAGE_PIX_FMT_RGB565:
+        return 2;
+    case CAM_IMAGE_PIX_FMT_Y8:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+Arducam_Qwiic_RleEncoder::Arducam_Qwiic_RleEncoder()
+{
+    begin(CAM_IMAGE_PIX_FMT_Y8);
+}
+
+bool Arducam_Qwiic_RleEncoder::begin(CAM_IMAGE_PIX_FMT pixel_format)
+{
+    uint8_t n = pixelBytes(pixel_format);
+    if (n == 0) {
+        return false;
+    }
+    bpp = n;
+    prev[0] = 0;
+    prev[1] = 0;
+    phase = 0;
+    literalLen = 0;
+    runByte = 0;
+    runLen = 0;
+    bytesIn = 0;
+    bytesOut = 0;
+    return true;
+}
+
+size_t Arducam_Qwiic_RleEncoder::flushLiteral(uint8_t* out)
+{
+    if (literalLen == 0) {
+        return 0;
+    }
+    out[0] = literalLen - 1;
+    memcpy(out + 1, literal, literalLen);
+    size_t n = literalLen + 1;
+    literalLen = 0;
+    return n;
+}
+
+size_t Arducam_Qwiic_RleEncoder::flushRun(uint8_t* out)
+{
+    size_t n = 0;
+    if (runLen >= CAM_RLE_MIN_RUN) {
+        n = flushLiteral(out);
+        out[n++] = 0x80 + (runLen - CAM_RLE_MIN_RUN);
+        out[n++] = runByte;
+    } else {
+        // Too short to pay for a run token
+        for (uint8_t i = 0; i < runLen; i++) {
+            literal[literalLen++] = runByte;
+            if (literalLen == CAM_RLE_MAX_LITERAL) {
+                n += flushLiteral(out + n);
+            }
+        }
+    }
+    runLen = 0;
+    return n;
+}
+
+size_t Arducam_Qwiic_RleEncoder::process(const uint8_t* in, size_t length, uint8_t* out)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t b = in[i];
+        uint8_t d = b - prev[phase];
+        prev[phase] = b;
+        if (++phase == bpp) {
+            phase = 0;
+        }
+
+        if (runLen > 0 && d == runByte) {
+            if (++runLen == CAM_RLE_MAX_RUN) {
+                n += flushRun(out + n);
+            }
+            continue;
+        }
+        n += flushRun(out + n);
+        runByte = d;
+        runLen = 1;
+    }
+    bytesIn += length;
+    bytesOut += n;
+    return n;
+}
+
+size_t Arducam_Qwiic_RleEncoder::finish(uint8_t* out)
+{
+    size_t n = flushRun(out);
+    n += flushLiteral(out + n);
+    bytesOut += n;
+    return n;
+}
+
+size_t Arducam_Qwiic_RleEncoder::getMaxOutputLength(size_t length)
+{
+    return CAM_RLE_MAX_OUTPUT(length);
+}
+
+uint32_t Arducam_Qwiic_RleEncoder::getInputLength() const
+{
+    return bytesIn;
+}
+
+uint32_t Arducam_Qwiic_RleEncoder::getOutputLength() const
+{
+    return bytesOut;
+}
+
+Arducam_Qwiic_RleDecoder::Arducam_Qwiic_RleDecoder()
+{
+    begin(CAM_IMAGE_PIX_FMT_Y8);
+}
+
+bool Arducam_Qwiic_RleDecoder::begin(CAM_IMAGE_PIX_FMT pixel_format)
+{
+    uint8_t n = pixelBytes(pixel_format);
+    if (n == 0) {
+        return false;
+    }
+    bpp = n;
+    prev[0] = 0;
+    prev[1] = 0;
+    phase = 0;
+    literalLeft = 0;
+    runLeft = 0;
+    runByte = 0;
+    runPending = false;
+    return true;
+}
+
+uint8_t Arducam_Qwiic_RleDecoder::restore(uint8_t delta)
+{
+    uint8_t b = prev[phase] + delta;
+    prev[phase] = b;
+    if (++phase == bpp) {
+        phase = 0;
+    }
+    return b;
+}
+
+size_t Arducam_Qwiic_RleDecoder::process(const uint8_t* in, size_t length, uint8_t* out, size_t outSize,
+                                         size_t* consumed)
+{
+    size_t pos = 0;
+    size_t n = 0;
+
+    while (n < outSize) {
+        if (runLeft > 0 && !runPending) {
+            out[n++] = restore(runByte);
+            runLeft--;
+            continue;
+        }
+        if (pos >= length) {
+            break;
+        }
+        uint8_t b = in[pos++];
+        if (literalLeft > 0) {
+            out[n++] = restore(b);
+            literalLeft--;
+        } else if (runPending) {
+            runByte = b;
+            runPending = false;
+        } else if (b & 0x80) {
+            runLeft = (b & 0x7f) + CAM_RLE_MIN_RUN;
+            runPending = true;
+        } else {
+            literalLeft = b + 1;
+        }
+    }
+
+    if (consumed != NULL) {
+        *consumed = pos;
+    }
+    return n;
+}
+
+#if defined(ARDUINO)
+Arducam_Qwiic_RlePrint::Arducam_Qwiic_RlePrint(Arducam_Qwiic_RleEncoder& encoder, Print& sink)
+    : encoder(encoder), sink(sink)
+{
+}
+
+size_t Arducam_Qwiic_RlePrint::write(uint8_t data)
+{
+    return write(&data, 1);
+}
+
+size_t Arducam_Qwiic_RlePrint::write(const uint8_t* buffer, size_t size)
+{
+    const size_t slice = QWIIC_CAM_SINK_BLOCK_SIZE;
+    uint8_t block[CAM_RLE_MAX_OUTPUT(QWIIC_CAM_SINK_BLOCK_SIZE)];
+    size_t done = 0;
+
+    while (done < size) {
+        size_t n = size - done;
+        if (n > slice) {
+            n = slice;
+        }
+        size_t produced = encoder.process(buffer + done, n, block);
+        if (produced > 0 && sink.write(block, produced) != produced) {
+            break;
+        }
+        done += n;
+    }
+    return done;
+}
+
+bool Arducam_Qwiic_RlePrint::finish(void)
+{
+    uint8_t block[CAM_RLE_MAX_OUTPUT(0)];
+    size_t produced = encoder.finish(block);
+    return (produced == 0 || sink.write(block, produced) == produced);
+}
+#endif
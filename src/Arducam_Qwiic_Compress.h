@@ -0,0 +1,228 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_COMPRESS_H
+#define __ARDUCAM_QWIIC_COMPRESS_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+/**
+* @file Arducam_Qwiic_Compress.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*
+* Lossless pixel delta + run-length coding of raw Y8/RGB565 frames.
+*
+* Each byte is replaced by its difference to the same byte of the previous
+* pixel, then the differences are packed:
+*   0x00..0x7F  n + 1 literal bytes follow
+*   0x80..0xFF  the next byte repeats n - 0x80 + 3 times
+*/
+
+#define CAM_RLE_MAX_LITERAL           128
+#define CAM_RLE_MIN_RUN               3
+#define CAM_RLE_MAX_RUN               130
+
+// Most bytes one process() call can write, up to CAM_RLE_MAX_LITERAL + 1 bytes
+// may be held back from earlier chunks
+#define CAM_RLE_MAX_OUTPUT(length)    ((length) + (length) / CAM_RLE_MAX_LITERAL + CAM_RLE_MAX_LITERAL + 8)
+
+/**
+* @brief Streaming compressor for raw frames
+*
+* Feed the chunks returned by readImageBuf() to process() in order, then
+* call finish(). The whole state is the pending literal block.
+*/
+class Arducam_Qwiic_RleEncoder
+{
+private:
+	uint8_t bpp;                                        /**< Bytes per pixel, the delta distance */
+	uint8_t prev[2];                                    /**< Last byte of each pixel position */
+	uint8_t phase;                                      /**< Byte position within the pixel */
+	uint8_t literal[CAM_RLE_MAX_LITERAL];               /**< Literals not written yet */
+	uint8_t literalLen;                                 /**< Bytes in literal */
+	uint8_t runByte;                                    /**< Value of the current run */
+	uint8_t runLen;                                     /**< Length of the current run */
+	uint32_t bytesIn;                                   /**< Frame bytes consumed */
+	uint32_t bytesOut;                                  /**< Compressed bytes produced */
+
+	//**********************************************
+	//!
+	//! @brief Write the pending literals
+	//!
+	//! @return Return the bytes written to out
+	//**********************************************
+	size_t flushLiteral(uint8_t* out);
+
+	//**********************************************
+	//!
+	//! @brief Write or demote the current run
+	//!
+	//! @return Return the bytes written to out
+	//**********************************************
+	size_t flushRun(uint8_t* out);
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the compressor
+	//**********************************************
+	Arducam_Qwiic_RleEncoder();
+
+	//**********************************************
+	//!
+	//! @brief Start a new frame
+	//!
+	//! @param pixel_format CAM_IMAGE_PIX_FMT_RGB565 or CAM_IMAGE_PIX_FMT_Y8
+	//!
+	//! @return Returns false for JPEG, which does not compress
+	//**********************************************
+	bool begin(CAM_IMAGE_PIX_FMT pixel_format);
+
+	//**********************************************
+	//!
+	//! @brief Compress the next chunk of the frame
+	//!
+	//! @param  in Chunk from readImageBuf()
+	//! @param  length Chunk length
+	//! @param  out Output buffer of at least getMaxOutputLength(length) bytes
+	//!
+	//! @return Return the bytes written to out
+	//**********************************************
+	size_t process(const uint8_t* in, size_t length, uint8_t* out);
+
+	//**********************************************
+	//!
+	//! @brief Write the data still held back at the end of the frame
+	//!
+	//! @param  out Output buffer of at least getMaxOutputLength(0) bytes
+	//!
+	//! @return Return the bytes written to out
+	//**********************************************
+	size_t finish(uint8_t* out);
+
+	//**********************************************
+	//!
+	//! @brief Get the most bytes process() or finish() can write
+	//!
+	//! @param  length Chunk length
+	//!
+	//! @return Return the output buffer size needed
+	//**********************************************
+	static size_t getMaxOutputLength(size_t length);
+
+	//**********************************************
+	//!
+	//! @brief Get the frame bytes consumed since begin()
+	//!
+	//! @return Return the length in bytes
+	//**********************************************
+	uint32_t getInputLength() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the compressed bytes produced since begin()
+	//!
+	//! @return Return the length in bytes
+	//**********************************************
+	uint32_t getOutputLength() const;
+};
+
+/**
+* @brief Streaming decompressor, for hosts and tests
+*/
+class Arducam_Qwiic_RleDecoder
+{
+private:
+	uint8_t bpp;                                        /**< Bytes per pixel, the delta distance */
+	uint8_t prev[2];                                    /**< Last byte of each pixel position */
+	uint8_t phase;                                      /**< Byte position within the pixel */
+	uint8_t literalLeft;                                /**< Literal bytes still to come */
+	uint8_t runLeft;                                    /**< Repeats of runByte still to write */
+	uint8_t runByte;                                    /**< Value of the current run */
+	bool runPending;                                    /**< Run control seen, value byte not yet */
+
+	//**********************************************
+	//!
+	//! @brief Undo the delta of one byte
+	//!
+	//! @return Return the pixel byte
+	//**********************************************
+	uint8_t restore(uint8_t delta);
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the decompressor
+	//**********************************************
+	Arducam_Qwiic_RleDecoder();
+
+	//**********************************************
+	//!
+	//! @brief Start a new frame
+	//!
+	//! @param pixel_format Format passed to the encoder
+	//!
+	//! @return Returns false for JPEG
+	//**********************************************
+	bool begin(CAM_IMAGE_PIX_FMT pixel_format);
+
+	//**********************************************
+	//!
+	//! @brief Decompress as much input as fits in the output
+	//!
+	//! @param  in Compressed data
+	//! @param  length Compressed length
+	//! @param  out Output buffer
+	//! @param  outSize Output buffer size
+	//! @param  consumed Set to the compressed bytes used, call again with the rest
+	//!
+	//! @return Return the bytes written to out
+	//**********************************************
+	size_t process(const uint8_t* in, size_t length, uint8_t* out, size_t outSize, size_t* consumed);
+};
+
+#if defined(ARDUINO)
+/**
+* @brief Print sink that compresses the data before forwarding it
+*
+* Pass it to readImageTo() and call finish() once the frame is read.
+*/
+class Arducam_Qwiic_RlePrint : public Print
+{
+private:
+	Arducam_Qwiic_RleEncoder& encoder;                  /**< Compressor to run */
+	Print& sink;                                        /**< Receiver of the output */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the compressing sink
+	//!
+	//! @param  encoder Compressor, begin() already called
+	//! @param  sink Receiver of the output
+	//**********************************************
+	Arducam_Qwiic_RlePrint(Arducam_Qwiic_RleEncoder& encoder, Print& sink);
+
+	size_t write(uint8_t data);
+	size_t write(const uint8_t* buffer, size_t size);
+
+	//**********************************************
+	//!
+	//! @brief Write the end of the compressed frame
+	//!
+	//! @return Returns false if the sink did not take all of it
+	//**********************************************
+	bool finish(void);
+};
+#endif
+
+#endif /*__ARDUCAM_QWIIC_COMPRESS_H*/
@@ -0,0 +1,80 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_FrameReader.h"
+#include <limits.h>
+
+#if defined(ARDUINO)
+
+Arducam_Qwiic_FrameReader::Arducam_Qwiic_FrameReader(Arducam_Qwiic_CAM& cam) : cam(cam)
+{
+    bufLen = 0;
+    bufPos = 0;
+}
+
+bool Arducam_Qwiic_FrameReader::fill(void)
+{
+    if (bufPos < bufLen) {
+        return true;
+    }
+    bufPos = 0;
+    bufLen = (uint16_t)cam.readImageBuf(buf, sizeof(buf));
+    return (bufLen > 0);
+}
+
+int Arducam_Qwiic_FrameReader::available(void)
+{
+    uint32_t remaining = cam.getUnreceivedLength() + (bufLen - bufPos);
+    return (remaining > (uint32_t)INT_MAX) ? INT_MAX : (int)remaining;
+}
+
+int Arducam_Qwiic_FrameReader::read(void)
+{
+    if (!fill()) {
+        return -1;
+    }
+    return buf[bufPos++];
+}
+
+int Arducam_Qwiic_FrameReader::peek(void)
+{
+    if (!fill()) {
+        return -1;
+    }
+    return buf[bufPos];
+}
+
+size_t Arducam_Qwiic_FrameReader::read(uint8_t* buffer, size_t length)
+{
+    size_t count = 0;
+
+    while (count < length && bufPos < bufLen) {
+        buffer[count++] = buf[bufPos++];
+    }
+    if (count < length) {
+        // Large reads go straight from the FIFO into the caller buffer
+        count += cam.readImageBuf(buffer + count, length - count);
+    }
+    return count;
+}
+
+size_t Arducam_Qwiic_FrameReader::write(uint8_t data)
+{
+    (void)data;
+    return 0;
+}
+
+void Arducam_Qwiic_FrameReader::reset(void)
+{
+    bufLen = 0;
+    bufPos = 0;
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_FRAME_READER_H
+#define __ARDUCAM_QWIIC_FRAME_READER_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+#if defined(ARDUINO)
+
+/**
+* @file Arducam_Qwiic_FrameReader.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+#if !defined(QWIIC_CAM_FRAME_READER_BUF_SIZE)
+#define QWIIC_CAM_FRAME_READER_BUF_SIZE 32 // Bytes fetched from the FIFO per refill
+#endif
+
+/**
+* @brief Read-only Arduino Stream over the frame waiting in the camera FIFO
+*
+* Lets any code that consumes a Stream take the image directly, e.g.
+* client.write() loops, file writers or decoders.
+*/
+class Arducam_Qwiic_FrameReader : public Stream
+{
+private:
+	Arducam_Qwiic_CAM& cam;                             /**< Camera holding the frame */
+	uint8_t buf[QWIIC_CAM_FRAME_READER_BUF_SIZE];       /**< Bytes read ahead from the FIFO */
+	uint16_t bufLen;                                    /**< Valid bytes in buf */
+	uint16_t bufPos;                                    /**< Next byte to return from buf */
+
+	//**********************************************
+	//!
+	//! @brief Fetch the next bytes from the FIFO if buf is empty
+	//!
+	//! @return Returns false at the end of the frame
+	//**********************************************
+	bool fill(void);
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the frame reader
+	//!
+	//! @param  cam Camera holding the frame
+	//**********************************************
+	explicit Arducam_Qwiic_FrameReader(Arducam_Qwiic_CAM& cam);
+
+	//**********************************************
+	//!
+	//! @brief Get the number of bytes left in the frame
+	//!
+	//! @return Return the remaining length
+	//**********************************************
+	int available(void);
+
+	int read(void);
+	int peek(void);
+
+	//**********************************************
+	//!
+	//! @brief Read several bytes of the frame
+	//!
+	//! @param  buffer Buffer for storing camera data
+	//! @param  length Size of the buffer
+	//!
+	//! @return Returns the length actually read
+	//**********************************************
+	size_t read(uint8_t* buffer, size_t length);
+
+	//**********************************************
+	//!
+	//! @brief The reader is read-only, writes are dropped
+	//!
+	//! @return Always returns 0
+	//**********************************************
+	size_t write(uint8_t data);
+
+	//**********************************************
+	//!
+	//! @brief Drop the read-ahead bytes, call after a new capture
+	//**********************************************
+	void reset(void);
+};
+
+#endif
+
+#endif /*__ARDUCAM_QWIIC_FRAME_READER_H*/
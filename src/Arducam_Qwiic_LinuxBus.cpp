@@ -0,0 +1,107 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_LinuxBus.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+Arducam_Qwiic_LinuxBus::Arducam_Qwiic_LinuxBus(const char* path)
+{
+    devicePath = path;
+    fd = -1;
+    ownsFd = true;
+}
+
+Arducam_Qwiic_LinuxBus::Arducam_Qwiic_LinuxBus(int fd)
+{
+    devicePath = NULL;
+    this->fd = fd;
+    ownsFd = false;
+}
+
+Arducam_Qwiic_LinuxBus::~Arducam_Qwiic_LinuxBus(void)
+{
+    if (ownsFd && fd >= 0) {
+        close(fd);
+    }
+}
+
+bool Arducam_Qwiic_LinuxBus::begin(void)
+{
+    if (fd < 0 && devicePath != NULL) {
+        fd = open(devicePath, O_RDWR);
+    }
+    return (fd >= 0);
+}
+
+void Arducam_Qwiic_LinuxBus::setClock(uint32_t hz)
+{
+    // The adapter clock is fixed by the kernel (device tree / module option)
+    (void)hz;
+}
+
+bool Arducam_Qwiic_LinuxBus::transfer(struct i2c_msg* msgs, uint32_t count)
+{
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = msgs;
+    data.nmsgs = count;
+    return (ioctl(fd, I2C_RDWR, &data) == (int)count);
+}
+
+bool Arducam_Qwiic_LinuxBus::write(uint8_t addr, const uint8_t* data, size_t length)
+{
+    // A message holds at most QWIIC_CAM_I2C_DEV_MAX_MSG bytes, a longer
+    // write cannot be split without changing its meaning
+    if (length > QWIIC_CAM_I2C_DEV_MAX_MSG) {
+        return false;
+    }
+    struct i2c_msg msg;
+    msg.addr = addr;
+    msg.flags = 0;
+    msg.len = (uint16_t)length;
+    msg.buf = (uint8_t*)data;
+    return transfer(&msg, 1);
+}
+
+size_t Arducam_Qwiic_LinuxBus::writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length)
+{
+    // Longer reads are cut to one message, the caller reads the rest
+    if (length > maxReadLength()) {
+        length = maxReadLength();
+    }
+    struct i2c_msg msgs[2];
+    msgs[0].addr = addr;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &reg;
+    msgs[1].addr = addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = (uint16_t)length;
+    msgs[1].buf = buf;
+    return transfer(msgs, 2) ? length : 0;
+}
+
+size_t Arducam_Qwiic_LinuxBus::maxReadLength(void) const
+{
+    return QWIIC_CAM_I2C_DEV_MAX_MSG;
+}
+
+int Arducam_Qwiic_LinuxBus::getFd(void) const
+{
+    return fd;
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_LINUX_BUS_H
+#define __ARDUCAM_QWIIC_LINUX_BUS_H
+
+#include "Arducam_Qwiic_Bus.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+struct i2c_msg;
+
+#define QWIIC_CAM_I2C_DEV_MAX_MSG 8192 // i2c-dev limit for one I2C_RDWR message
+
+/**
+* @file Arducam_Qwiic_LinuxBus.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+/**
+* @brief Bus backend on top of the Linux i2c-dev interface
+*
+* A register read is issued as one combined I2C_RDWR transfer (write message
+* plus read message), so the address byte and the data read are separated
+* by a repeated start instead of two system calls.
+*/
+class Arducam_Qwiic_LinuxBus : public Arducam_Qwiic_Bus
+{
+private:
+	const char* devicePath;                         /**< i2c-dev node, e.g. "/dev/i2c-1" */
+	int fd;                                         /**< Open file descriptor, -1 if closed */
+	bool ownsFd;                                    /**< Close fd in the destructor */
+
+protected:
+	//**********************************************
+	//!
+	//! @brief Run a combined transfer on the adapter
+	//!
+	//! @param  msgs Messages to run back to back
+	//! @param  count Number of messages
+	//!
+	//! @return Returns true if the whole transfer succeeded
+	//!
+	//! @note Override to run the backend against a device stand-in
+	//**********************************************
+	virtual bool transfer(struct i2c_msg* msgs, uint32_t count);
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor, the device node is opened by begin()
+	//!
+	//! @param  path i2c-dev node, e.g. "/dev/i2c-1"
+	//**********************************************
+	explicit Arducam_Qwiic_LinuxBus(const char* path);
+
+	//**********************************************
+	//!
+	//! @brief Constructor on an already open file descriptor
+	//!
+	//! @param  fd Open i2c-dev descriptor, not closed by this object
+	//**********************************************
+	explicit Arducam_Qwiic_LinuxBus(int fd);
+
+	~Arducam_Qwiic_LinuxBus(void);
+
+	bool begin(void);
+	void setClock(uint32_t hz);
+	bool write(uint8_t addr, const uint8_t* data, size_t length);
+	size_t writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length);
+	size_t maxReadLength(void) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the file descriptor
+	//!
+	//! @return Return the descriptor, -1 if the bus is not open
+	//**********************************************
+	int getFd(void) const;
+};
+
+#endif
+
+#endif /*__ARDUCAM_QWIIC_LINUX_BUS_H*/
@@ -0,0 +1,246 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_Motion.h"
+#include <string.h>
+
+Arducam_Qwiic_MotionDetector::Arducam_Qwiic_MotionDetector()
+{
+    width = 0;
+    height = 0;
+    tileThreshold = CAM_MOTION_DEFAULT_TILE_SAD;
+    minTiles = CAM_MOTION_DEFAULT_MIN_TILES;
+    learnShift = CAM_MOTION_DEFAULT_LEARN;
+    resetReference();
+    startFrame();
+}
+
+bool Arducam_Qwiic_MotionDetector::begin(CAM_IMAGE_MODE mode)
+{
+    uint16_t w = 0;
+    uint16_t h = 0;
+    if (!Arducam_Qwiic_CAM::getModeSize(mode, &w, &h)) {
+        return false;
+    }
+    return begin(w, h);
+}
+
+bool Arducam_Qwiic_MotionDetector::begin(uint16_t w, uint16_t h)
+{
+    if (w < CAM_MOTION_CELLS_X || h < CAM_MOTION_CELLS_Y) {
+        return false;
+    }
+    width = w;
+    height = h;
+    resetReference();
+    startFrame();
+    return true;
+}
+
+void Arducam_Qwiic_MotionDetector::setThreshold(uint16_t tileSad, uint16_t tiles, uint8_t learn)
+{
+    tileThreshold = tileSad;
+    minTiles = (tiles == 0) ? 1 : tiles;
+    learnShift = (learn > 7) ? 7 : learn;
+}
+
+void Arducam_Qwiic_MotionDetector::resetReference(void)
+{
+    hasReference = false;
+    memset(reference, 0, sizeof(reference));
+}
+
+uint16_t Arducam_Qwiic_MotionDetector::cellStart(uint8_t cell, uint8_t cells, uint16_t size)
+{
+    return (uint16_t)((uint32_t)cell * size / cells);
+}
+
+void Arducam_Qwiic_MotionDetector::startFrame(void)
+{
+    x = 0;
+    y = 0;
+    cellX = 0;
+    cellY = 0;
+    nextCellX = cellStart(1, CAM_MOTION_CELLS_X, width);
+    nextCellY = cellStart(1, CAM_MOTION_CELLS_Y, height);
+    memset(rowSums, 0, sizeof(rowSums));
+    memset(tileSad, 0, sizeof(tileSad));
+    memset(mask, 0, sizeof(mask));
+    changedTiles = 0;
+    changed = false;
+}
+
+void Arducam_Qwiic_MotionDetector::process(const uint8_t* in, size_t length)
+{
+    while (length > 0 && y < height) {
+        // Sum the run of pixels that falls in the current cell
+        size_t run = nextCellX - x;
+        if (run > length) {
+            run = length;
+        }
+        uint32_t sum = 0;
+        for (size_t i = 0; i < run; i++) {
+            sum += in[i];
+        }
+        rowSums[cellX] += sum;
+        in += run;
+        length -= run;
+        x += run;
+
+        if (x < nextCellX) {
+            continue;
+        }
+        if (x < width) {
+            cellX++;
+            nextCellX = cellStart(cellX + 1, CAM_MOTION_CELLS_X, width);
+            continue;
+        }
+
+        // End of a pixel row
+        x = 0;
+        cellX = 0;
+        nextCellX = cellStart(1, CAM_MOTION_CELLS_X, width);
+        y++;
+        if (y >= nextCellY) {
+            finishCellRow();
+            cellY++;
+            nextCellY = cellStart(cellY + 1, CAM_MOTION_CELLS_Y, height);
+        }
+    }
+}
+
+void Arducam_Qwiic_MotionDetector::finishCellRow(void)
+{
+    uint16_t rows = nextCellY - cellStart(cellY, CAM_MOTION_CELLS_Y, height);
+
+    for (uint8_t cx = 0; cx < CAM_MOTION_CELLS_X; cx++) {
+        uint16_t cols = cellStart(cx + 1, CAM_MOTION_CELLS_X, width) - cellStart(cx, CAM_MOTION_CELLS_X, width);
+        uint8_t mean = (uint8_t)(rowSums[cx] / ((uint32_t)rows * cols));
+        uint8_t& ref = reference[cellY][cx];
+
+        if (hasReference) {
+            int16_t diff = (int16_t)mean - (int16_t)ref;
+            tileSad[(cellY / 2) * QWIIC_CAM_MOTION_TILES_X + cx / 2] += (diff < 0) ? -diff : diff;
+            ref = (uint8_t)(ref + diff / (1 << learnShift));
+        } else {
+            ref = mean;
+        }
+        rowSums[cx] = 0;
+    }
+}
+
+bool Arducam_Qwiic_MotionDetector::endFrame(void)
+{
+    if (!hasReference) {
+        // Nothing to compare against, report the whole frame as changed
+        hasReference = (y >= height);
+        memset(mask, 0xff, sizeof(mask));
+        changedTiles = CAM_MOTION_TILE_COUNT;
+        changed = true;
+        return changed;
+    }
+
+    changedTiles = 0;
+    for (uint16_t i = 0; i < CAM_MOTION_TILE_COUNT; i++) {
+        if (tileSad[i] > tileThreshold) {
+            mask[i / 8] |= (uint8_t)(1 << (i % 8));
+            changedTiles++;
+        }
+    }
+    changed = (changedTiles >= minTiles);
+    return changed;
+}
+
+CamStatus Arducam_Qwiic_MotionDetector::check(Arducam_Qwiic_CAM& cam, CAM_IMAGE_MODE mode, bool* motion)
+{
+    uint16_t w = 0;
+    uint16_t h = 0;
+    if (!Arducam_Qwiic_CAM::getModeSize(mode, &w, &h)) {
+        return CAM_ERR_INVALID;
+    }
+    if (w != width || h != height) {
+        if (!begin(w, h)) {
+            return CAM_ERR_INVALID;
+        }
+    }
+
+    CAM_RETURN_IF_ERR(cam.takePicture(mode, CAM_IMAGE_PIX_FMT_Y8));
+
+    uint8_t buf[QWIIC_CAM_MOTION_READ_SIZE];
+    startFrame();
+    while (cam.getUnreceivedLength() > 0) {
+        size_t n = cam.readImageBuf(buf, sizeof(buf));
+        if (n == 0) {
+            break;
+        }
+        process(buf, n);
+    }
+    if (y < height) {
+        // A partial frame would be taken as the reference or compared
+        // against it
+        return CAM_ERR_NO_CALLBACK;
+    }
+
+    bool result = endFrame();
+    if (motion != NULL) {
+        *motion = result;
+    }
+    return CAM_ERR_NONE;
+}
+
+CamStatus Arducam_Qwiic_MotionDetector::captureOnMotion(Arducam_Qwiic_CAM& cam, CAM_IMAGE_MODE detectMode,
+                                                        CAM_IMAGE_MODE jpegMode, bool* captured)
+{
+    bool motion = false;
+    if (captured != NULL) {
+        *captured = false;
+    }
+    CAM_RETURN_IF_ERR(check(cam, detectMode, &motion));
+    if (!motion) {
+        return CAM_ERR_NONE;
+    }
+    CAM_RETURN_IF_ERR(cam.takePicture(jpegMode, CAM_IMAGE_PIX_FMT_JPG));
+    if (captured != NULL) {
+        *captured = true;
+    }
+    return CAM_ERR_NONE;
+}
+
+bool Arducam_Qwiic_MotionDetector::isChanged() const
+{
+    return changed;
+}
+
+const uint8_t* Arducam_Qwiic_MotionDetector::getChangedMask() const
+{
+    return mask;
+}
+
+uint16_t Arducam_Qwiic_MotionDetector::getChangedTiles() const
+{
+    return changedTiles;
+}
+
+bool Arducam_Qwiic_MotionDetector::isTileChanged(uint8_t tx, uint8_t ty) const
+{
+    if (tx >= QWIIC_CAM_MOTION_TILES_X || ty >= QWIIC_CAM_MOTION_TILES_Y) {
+        return false;
+    }
+    uint16_t i = ty * QWIIC_CAM_MOTION_TILES_X + tx;
+    return (mask[i / 8] >> (i % 8)) & 1;
+}
+
+uint16_t Arducam_Qwiic_MotionDetector::getTileSad(uint8_t tx, uint8_t ty) const
+{
+    if (tx >= QWIIC_CAM_MOTION_TILES_X || ty >= QWIIC_CAM_MOTION_TILES_Y) {
+        return 0;
+    }
+    return tileSad[ty * QWIIC_CAM_MOTION_TILES_X + tx];
+}
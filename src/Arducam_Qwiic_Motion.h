@@ -0,0 +1,235 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_MOTION_H
+#define __ARDUCAM_QWIIC_MOTION_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+/**
+* @file Arducam_Qwiic_Motion.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+#if !defined(QWIIC_CAM_MOTION_TILES_X)
+#define QWIIC_CAM_MOTION_TILES_X      8   // Tile columns
+#endif
+
+#if !defined(QWIIC_CAM_MOTION_TILES_Y)
+#define QWIIC_CAM_MOTION_TILES_Y      6   // Tile rows
+#endif
+
+#if !defined(QWIIC_CAM_MOTION_READ_SIZE)
+#define QWIIC_CAM_MOTION_READ_SIZE    64  // Stack buffer used by check()
+#endif
+
+#if QWIIC_CAM_MOTION_TILES_X > 127 || QWIIC_CAM_MOTION_TILES_Y > 127
+#error "Motion cells are indexed with uint8_t, use at most 127 tile columns and rows"
+#endif
+
+#define CAM_MOTION_TILE_COUNT         (QWIIC_CAM_MOTION_TILES_X * QWIIC_CAM_MOTION_TILES_Y)
+#define CAM_MOTION_CELLS_X            (QWIIC_CAM_MOTION_TILES_X * 2) // Each tile holds 2x2 reference cells
+#define CAM_MOTION_CELLS_Y            (QWIIC_CAM_MOTION_TILES_Y * 2)
+#define CAM_MOTION_MASK_SIZE          ((CAM_MOTION_TILE_COUNT + 7) / 8)
+
+#define CAM_MOTION_DEFAULT_TILE_SAD   48  // Sum over the 4 cells of |mean - reference|
+#define CAM_MOTION_DEFAULT_MIN_TILES  1
+#define CAM_MOTION_DEFAULT_LEARN      1   // Reference moves 1/2 of the way to each new frame
+
+/**
+* @brief Tile-based motion detector for Y8 frames
+*
+* Each tile is split into 2x2 cells. The detector keeps only the mean of
+* every cell as the reference and builds the new means row by row while
+* chunks are read, so the whole state is a few hundred bytes. A tile
+* changed when the sum of absolute differences of its cell means exceeds
+* the threshold.
+*/
+class Arducam_Qwiic_MotionDetector
+{
+private:
+	uint16_t width;                                     /**< Frame width */
+	uint16_t height;                                    /**< Frame height */
+	uint16_t x;                                         /**< Column of the next pixel */
+	uint16_t y;                                         /**< Row of the next pixel */
+	uint8_t cellX;                                      /**< Cell column of the next pixel */
+	uint8_t cellY;                                      /**< Cell row of the next pixel */
+	uint16_t nextCellX;                                 /**< First column of the next cell column */
+	uint16_t nextCellY;                                 /**< First row of the next cell row */
+	uint32_t rowSums[CAM_MOTION_CELLS_X];               /**< Pixel sums of the current cell row */
+	uint8_t reference[CAM_MOTION_CELLS_Y][CAM_MOTION_CELLS_X]; /**< Reference cell means */
+	bool hasReference;                                  /**< reference holds a frame */
+	uint16_t tileSad[CAM_MOTION_TILE_COUNT];            /**< Cell SAD of each tile in the last frame */
+	uint8_t mask[CAM_MOTION_MASK_SIZE];                 /**< Changed tiles of the last frame */
+	uint16_t changedTiles;                              /**< Number of changed tiles */
+	uint16_t tileThreshold;                             /**< Tile SAD above which it changed */
+	uint16_t minTiles;                                  /**< Changed tiles needed for motion */
+	uint8_t learnShift;                                 /**< Reference update weight, 0 replaces it */
+	bool changed;                                       /**< Verdict of the last frame */
+
+	//**********************************************
+	//!
+	//! @brief Compare a finished cell row against the reference
+	//**********************************************
+	void finishCellRow(void);
+
+	//**********************************************
+	//!
+	//! @brief Get the first column or row of a cell
+	//!
+	//! @return Return the pixel index
+	//**********************************************
+	static uint16_t cellStart(uint8_t cell, uint8_t cells, uint16_t size);
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the motion detector
+	//**********************************************
+	Arducam_Qwiic_MotionDetector();
+
+	//**********************************************
+	//!
+	//! @brief Set the frame size and forget the reference
+	//!
+	//! @param mode Resolution of the Y8 captures
+	//!
+	//! @return Returns false for unknown modes or frames smaller than the grid
+	//**********************************************
+	bool begin(CAM_IMAGE_MODE mode);
+
+	//**********************************************
+	//!
+	//! @brief Set the frame size and forget the reference
+	//!
+	//! @return Returns false for frames smaller than the grid
+	//**********************************************
+	bool begin(uint16_t w, uint16_t h);
+
+	//**********************************************
+	//!
+	//! @brief Set the sensitivity
+	//!
+	//! @param  tileSad Tile SAD above which a tile changed
+	//! @param  tiles Changed tiles needed to report motion
+	//! @param  learn Reference update weight 1/2^learn, 0 replaces it
+	//**********************************************
+	void setThreshold(uint16_t tileSad, uint16_t tiles = CAM_MOTION_DEFAULT_MIN_TILES,
+	                  uint8_t learn = CAM_MOTION_DEFAULT_LEARN);
+
+	//**********************************************
+	//!
+	//! @brief Start a new frame
+	//**********************************************
+	void startFrame(void);
+
+	//**********************************************
+	//!
+	//! @brief Accumulate the next chunk of Y8 pixels
+	//!
+	//! @param  in Chunk from readImageBuf()
+	//! @param  length Chunk length
+	//**********************************************
+	void process(const uint8_t* in, size_t length);
+
+	//**********************************************
+	//!
+	//! @brief Finish the frame and update the reference
+	//!
+	//! @return Returns true if motion was detected
+	//!
+	//! @note The first frame after begin() always reports motion
+	//**********************************************
+	bool endFrame(void);
+
+	//**********************************************
+	//!
+	//! @brief Capture a Y8 frame and run it through the detector
+	//!
+	//! @param  cam Camera to use
+	//! @param  mode Resolution passed to begin()
+	//! @param  motion Set to the verdict
+	//!
+	//! @return Return operation status, CAM_ERR_INVALID for a mode without
+	//! a size or smaller than the grid, CAM_ERR_NO_CALLBACK if the
+	//! frame could not be read in full
+	//!
+	//! @note A frame that ends early leaves the reference and the verdict
+	//! of the last frame in place
+	//**********************************************
+	CamStatus check(Arducam_Qwiic_CAM& cam, CAM_IMAGE_MODE mode, bool* motion);
+
+	//**********************************************
+	//!
+	//! @brief Capture a JPEG frame only if a Y8 frame shows motion
+	//!
+	//! @param  cam Camera to use
+	//! @param  detectMode Resolution of the Y8 frame, passed to begin()
+	//! @param  jpegMode Resolution of the JPEG frame
+	//! @param  captured Set to true if a JPEG frame is waiting in the FIFO
+	//!
+	//! @return Return operation status
+	//!
+	//! @note Switching between Y8 and JPEG costs a reconfiguration frame
+	//! with CAM_POLICY_RECONFIG
+	//**********************************************
+	CamStatus captureOnMotion(Arducam_Qwiic_CAM& cam, CAM_IMAGE_MODE detectMode,
+	                          CAM_IMAGE_MODE jpegMode, bool* captured);
+
+	//**********************************************
+	//!
+	//! @brief Get the verdict of the last frame
+	//!
+	//! @return Returns true if motion was detected
+	//**********************************************
+	bool isChanged() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the changed tiles of the last frame
+	//!
+	//! @return Return a bit mask, bit n of byte n / 8 for tile n in row order
+	//**********************************************
+	const uint8_t* getChangedMask() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the number of changed tiles in the last frame
+	//!
+	//! @return Return the tile count
+	//**********************************************
+	uint16_t getChangedTiles() const;
+
+	//**********************************************
+	//!
+	//! @brief Check one tile of the last frame
+	//!
+	//! @return Returns true if the tile changed
+	//**********************************************
+	bool isTileChanged(uint8_t tx, uint8_t ty) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the cell SAD of one tile in the last frame
+	//!
+	//! @return Return the SAD
+	//**********************************************
+	uint16_t getTileSad(uint8_t tx, uint8_t ty) const;
+
+	//**********************************************
+	//!
+	//! @brief Forget the reference, the next frame reports motion
+	//**********************************************
+	void resetReference(void);
+};
+
+#endif /*__ARDUCAM_QWIIC_MOTION_H*/
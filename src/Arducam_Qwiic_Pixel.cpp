@@ -0,0 +1,316 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_Pixel.h"
+#include <string.h>
+
+static inline uint8_t expand5(uint8_t v)
+{
+    return (uint8_t)((v << 3) | (v >> 2));
+}
+
+static inline uint8_t expand6(uint8_t v)
+{
+    return (uint8_t)((v << 2) | (v >> 4));
+}
+
+Arducam_Qwiic_PixelStream::Arducam_Qwiic_PixelStream()
+{
+    width = 0;
+    height = 0;
+    inBpp = 1;
+    output = CAM_PIXEL_OUT_NATIVE;
+    step = 1;
+    setCrop(0, 0, 0, 0);
+    reset();
+}
+
+bool Arducam_Qwiic_PixelStream::begin(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format, CAM_PIXEL_OUT out)
+{
+    uint16_t w = 0;
+    uint16_t h = 0;
+    if (!Arducam_Qwiic_CAM::getModeSize(mode, &w, &h)) {
+        return false;
+    }
+    return begin(w, h, pixel_format, out);
+}
+
+bool Arducam_Qwiic_PixelStream::begin(uint16_t w, uint16_t h, CAM_IMAGE_PIX_FMT pixel_format, CAM_PIXEL_OUT out)
+{
+    if (pixel_format == CAM_IMAGE_PIX_FMT_RGB565) {
+        inBpp = 2;
+    } else if (pixel_format == CAM_IMAGE_PIX_FMT_Y8) {
+        inBpp = 1;
+        if (out == CAM_PIXEL_OUT_RGB565_LE) {
+            return false;
+        }
+        if (out == CAM_PIXEL_OUT_Y8) {
+            out = CAM_PIXEL_OUT_NATIVE;
+        }
+    } else {
+        return false;
+    }
+
+    width = w;
+    height = h;
+    output = out;
+    step = 1;
+    setCrop(0, 0, w, h);
+    reset();
+    return true;
+}
+
+void Arducam_Qwiic_PixelStream::setCrop(uint16_t cx, uint16_t cy, uint16_t cw, uint16_t ch)
+{
+    if (cx > width) {
+        cx = width;
+    }
+    if (cy > height) {
+        cy = height;
+    }
+    cropX = cx;
+    cropY = cy;
+    cropW = (cw > width - cx) ? width - cx : cw;
+    cropH = (ch > height - cy) ? height - cy : ch;
+}
+
+bool Arducam_Qwiic_PixelStream::setDecimation(uint8_t factor)
+{
+    if (factor != 1 && factor != 2 && factor != 4) {
+        return false;
+    }
+    step = factor;
+    return true;
+}
+
+void Arducam_Qwiic_PixelStream::reset(void)
+{
+    x = 0;
+    y = 0;
+    hasCarry = false;
+}
+
+uint16_t Arducam_Qwiic_PixelStream::getOutputWidth() const
+{
+    return (cropW + step - 1) / step;
+}
+
+uint16_t Arducam_Qwiic_PixelStream::getOutputHeight() const
+{
+    return (cropH + step - 1) / step;
+}
+
+static uint8_t outputBpp(uint8_t output, uint8_t inBpp)
+{
+    switch (output) {
+    case CAM_PIXEL_OUT_Y8:     return 1;
+    case CAM_PIXEL_OUT_RGB888: return 3;
+    default:                   return inBpp;
+    }
+}
+
+uint32_t Arducam_Qwiic_PixelStream::getOutputLength() const
+{
+    return (uint32_t)getOutputWidth() * getOutputHeight() * outputBpp(output, inBpp);
+}
+
+size_t Arducam_Qwiic_PixelStream::getMaxOutputLength(size_t length) const
+{
+    // One extra pixel for a byte carried over from the previous chunk
+    return (length / inBpp + 1) * outputBpp(output, inBpp);
+}
+
+size_t Arducam_Qwiic_PixelStream::getMaxInputLength(size_t space) const
+{
+    size_t count = space / outputBpp(output, inBpp);
+    if (count == 0) {
+        return 0;
+    }
+    // Leave room for the pixel a carried byte completes
+    return (count - 1) * inBpp + (inBpp - 1);
+}
+
+size_t Arducam_Qwiic_PixelStream::process(const uint8_t* in, size_t length, uint8_t* out)
+{
+    size_t written = 0;
+
+    if (hasCarry && length > 0) {
+        uint8_t joined[2] = {carry, in[0]};
+        hasCarry = false;
+        written += pixels(joined, 1, out);
+        in++;
+        length--;
+    }
+
+    size_t count = length / inBpp;
+    written += pixels(in, count, out + written);
+
+    if (length % inBpp) {
+        carry = in[length - 1];
+        hasCarry = true;
+    }
+    return written;
+}
+
+size_t Arducam_Qwiic_PixelStream::pixels(const uint8_t* in, size_t count, uint8_t* out)
+{
+    size_t written = 0;
+
+    while (count > 0 && y < height) {
+        size_t run = width - x;
+        if (run > count) {
+            run = count;
+        }
+
+        // Rows outside the crop or between decimated rows are skipped whole
+        if (y >= cropY && y < cropY + cropH && ((y - cropY) % step) == 0) {
+            uint16_t first = (x > cropX) ? x : cropX;
+            uint16_t phase = (first - cropX) % step;
+            if (phase) {
+                first += step - phase;
+            }
+            uint32_t end = (uint32_t)cropX + cropW;
+            if (end > (uint32_t)x + run) {
+                end = (uint32_t)x + run;
+            }
+            if (first < end) {
+                size_t kept = (end - first + step - 1) / step;
+                written += convert(in + (size_t)(first - x) * inBpp, kept, (size_t)step * inBpp, out + written);
+            }
+        }
+
+        in += run * inBpp;
+        count -= run;
+        x += run;
+        if (x >= width) {
+            x = 0;
+            y++;
+        }
+    }
+    return written;
+}
+
+size_t Arducam_Qwiic_PixelStream::convert(const uint8_t* in, size_t count, size_t stride, uint8_t* out) const
+{
+    uint8_t* start = out;
+
+    if (inBpp == 1) {
+        if (output == CAM_PIXEL_OUT_RGB888) {
+            for (size_t i = 0; i < count; i++, in += stride) {
+                *out++ = *in;
+                *out++ = *in;
+                *out++ = *in;
+            }
+        } else if (stride == 1) {
+            memcpy(out, in, count);
+            out += count;
+        } else {
+            for (size_t i = 0; i < count; i++, in += stride) {
+                *out++ = *in;
+            }
+        }
+        return out - start;
+    }
+
+    switch (output) {
+    case CAM_PIXEL_OUT_Y8:
+        for (size_t i = 0; i < count; i++, in += stride) {
+            uint16_t v = (uint16_t)((in[0] << 8) | in[1]);
+            uint16_t r = expand5(v >> 11);
+            uint16_t g = expand6((v >> 5) & 0x3f);
+            uint16_t b = expand5(v & 0x1f);
+            *out++ = (uint8_t)((77 * r + 150 * g + 29 * b) >> 8);
+        }
+        break;
+
+    case CAM_PIXEL_OUT_RGB888:
+        for (size_t i = 0; i < count; i++, in += stride) {
+            uint16_t v = (uint16_t)((in[0] << 8) | in[1]);
+            *out++ = expand5(v >> 11);
+            *out++ = expand6((v >> 5) & 0x3f);
+            *out++ = expand5(v & 0x1f);
+        }
+        break;
+
+    case CAM_PIXEL_OUT_RGB565_LE:
+#if QWIIC_CAM_PIXEL_WORD_KERNELS
+        if (stride == 2) {
+            // Swap two pixels per 32-bit word
+            for (; count >= 2; count -= 2, in += 4, out += 4) {
+                uint32_t w;
+                memcpy(&w, in, 4);
+                w = ((w >> 8) & 0x00ff00ffUL) | ((w << 8) & 0xff00ff00UL);
+                memcpy(out, &w, 4);
+            }
+        }
+#endif
+        for (size_t i = 0; i < count; i++, in += stride) {
+            *out++ = in[1];
+            *out++ = in[0];
+        }
+        break;
+
+    default: // CAM_PIXEL_OUT_NATIVE
+        if (stride == 2) {
+            memcpy(out, in, count * 2);
+            out += count * 2;
+        } else {
+            for (size_t i = 0; i < count; i++, in += stride) {
+                *out++ = in[0];
+                *out++ = in[1];
+            }
+        }
+        break;
+    }
+    return out - start;
+}
+
+#if defined(ARDUINO)
+Arducam_Qwiic_PixelPrint::Arducam_Qwiic_PixelPrint(Arducam_Qwiic_PixelStream& pixels, Print& sink)
+    : pixels(pixels), sink(sink)
+{
+}
+
+size_t Arducam_Qwiic_PixelPrint::write(uint8_t data)
+{
+    return write(&data, 1);
+}
+
+size_t Arducam_Qwiic_PixelPrint::write(const uint8_t* buffer, size_t size)
+{
+    // Collect the output in one block, so that cropping and decimation do
+    // not turn every input chunk into a short sink write
+    uint8_t block[QWIIC_CAM_SINK_BLOCK_SIZE];
+    size_t fill = 0;
+    size_t done = 0;
+    size_t sent = 0;
+
+    while (done < size) {
+        size_t n = pixels.getMaxInputLength(sizeof(block) - fill);
+        if (n == 0) {
+            if (fill == 0 || sink.write(block, fill) != fill) {
+                return sent;
+            }
+            fill = 0;
+            sent = done;
+            continue;
+        }
+        if (n > size - done) {
+            n = size - done;
+        }
+        fill += pixels.process(buffer + done, n, block + fill);
+        done += n;
+    }
+    if (fill > 0 && sink.write(block, fill) != fill) {
+        return sent;
+    }
+    return done;
+}
+#endif
@@ -0,0 +1,223 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_PIXEL_H
+#define __ARDUCAM_QWIIC_PIXEL_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+/**
+* @file Arducam_Qwiic_Pixel.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+#if !defined(QWIIC_CAM_PIXEL_WORD_KERNELS)
+#if UINTPTR_MAX > 0xffff
+#define QWIIC_CAM_PIXEL_WORD_KERNELS 1 // Process RGB565 runs 32 bits at a time
+#else
+#define QWIIC_CAM_PIXEL_WORD_KERNELS 0
+#endif
+#endif
+
+/**
+ * @enum CAM_PIXEL_OUT
+ * @brief Output format of Arducam_Qwiic_PixelStream
+ */
+typedef enum {
+    CAM_PIXEL_OUT_NATIVE = 0,  /**< Same as the capture format */
+    CAM_PIXEL_OUT_Y8,          /**< 8-bit luma */
+    CAM_PIXEL_OUT_RGB888,      /**< 3 bytes per pixel, R first */
+    CAM_PIXEL_OUT_RGB565_LE    /**< RGB565 low byte first */
+} CAM_PIXEL_OUT;
+
+/**
+* @brief Crops, decimates and converts RGB565/Y8 frames chunk by chunk
+*
+* Feed the chunks returned by readImageBuf() to process() in order. Rows
+* and RGB565 pixels may be split across chunks. RGB565 from the FIFO is
+* high byte first.
+*/
+class Arducam_Qwiic_PixelStream
+{
+private:
+	uint16_t width;                                     /**< Frame width */
+	uint16_t height;                                    /**< Frame height */
+	uint8_t inBpp;                                      /**< Input bytes per pixel */
+	uint8_t output;                                     /**< CAM_PIXEL_OUT */
+	uint16_t cropX;                                     /**< First column kept */
+	uint16_t cropY;                                     /**< First row kept */
+	uint16_t cropW;                                     /**< Columns in the crop */
+	uint16_t cropH;                                     /**< Rows in the crop */
+	uint8_t step;                                       /**< Decimation factor */
+	uint16_t x;                                         /**< Column of the next input pixel */
+	uint16_t y;                                         /**< Row of the next input pixel */
+	uint8_t carry;                                      /**< First byte of a split RGB565 pixel */
+	bool hasCarry;                                      /**< carry holds a byte */
+
+	//**********************************************
+	//!
+	//! @brief Crop, decimate and convert whole input pixels
+	//!
+	//! @param  in Input pixels
+	//! @param  count Number of pixels
+	//! @param  out Output buffer
+	//!
+	//! @return Return the bytes written to out
+	//**********************************************
+	size_t pixels(const uint8_t* in, size_t count, uint8_t* out);
+
+	//**********************************************
+	//!
+	//! @brief Convert pixels taken every stride bytes
+	//!
+	//! @return Return the bytes written to out
+	//**********************************************
+	size_t convert(const uint8_t* in, size_t count, size_t stride, uint8_t* out) const;
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the pixel stream
+	//**********************************************
+	Arducam_Qwiic_PixelStream();
+
+	//**********************************************
+	//!
+	//! @brief Set up for a frame of a capture mode
+	//!
+	//! @param mode Resolution of the capture
+	//! @param pixel_format CAM_IMAGE_PIX_FMT_RGB565 or CAM_IMAGE_PIX_FMT_Y8
+	//! @param out Output format
+	//!
+	//! @return Returns false for JPEG, unknown modes or an impossible output
+	//!
+	//! @note Resets the crop to the full frame and the decimation to 1
+	//**********************************************
+	bool begin(CAM_IMAGE_MODE mode, CAM_IMAGE_PIX_FMT pixel_format, CAM_PIXEL_OUT out = CAM_PIXEL_OUT_NATIVE);
+
+	//**********************************************
+	//!
+	//! @brief Set up for a frame of any size
+	//!
+	//! @return Returns false for JPEG or an impossible output
+	//**********************************************
+	bool begin(uint16_t w, uint16_t h, CAM_IMAGE_PIX_FMT pixel_format, CAM_PIXEL_OUT out = CAM_PIXEL_OUT_NATIVE);
+
+	//**********************************************
+	//!
+	//! @brief Keep only a rectangle of the frame
+	//!
+	//! @note The rectangle is clipped to the frame
+	//**********************************************
+	void setCrop(uint16_t cx, uint16_t cy, uint16_t cw, uint16_t ch);
+
+	//**********************************************
+	//!
+	//! @brief Keep every factor-th pixel of every factor-th row
+	//!
+	//! @param factor 1, 2 or 4
+	//!
+	//! @return Returns false for other factors
+	//**********************************************
+	bool setDecimation(uint8_t factor);
+
+	//**********************************************
+	//!
+	//! @brief Process the next chunk of the frame
+	//!
+	//! @param  in Chunk from readImageBuf()
+	//! @param  length Chunk length
+	//! @param  out Output buffer of at least getMaxOutputLength(length) bytes
+	//!
+	//! @return Return the bytes written to out
+	//**********************************************
+	size_t process(const uint8_t* in, size_t length, uint8_t* out);
+
+	//**********************************************
+	//!
+	//! @brief Get the most bytes process() can write for a chunk
+	//!
+	//! @param  length Chunk length
+	//!
+	//! @return Return the output buffer size needed
+	//**********************************************
+	size_t getMaxOutputLength(size_t length) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the longest chunk whose output fits a buffer
+	//!
+	//! @param  space Output buffer size
+	//!
+	//! @return Return the chunk length, 0 if not even one pixel fits
+	//**********************************************
+	size_t getMaxInputLength(size_t space) const;
+
+	//**********************************************
+	//!
+	//! @brief Get the output size of a whole frame
+	//!
+	//! @return Return the length in bytes
+	//**********************************************
+	uint32_t getOutputLength() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the output image width
+	//!
+	//! @return Return the width in pixels
+	//**********************************************
+	uint16_t getOutputWidth() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the output image height
+	//!
+	//! @return Return the height in pixels
+	//**********************************************
+	uint16_t getOutputHeight() const;
+
+	//**********************************************
+	//!
+	//! @brief Start over at the first pixel of a new frame
+	//**********************************************
+	void reset(void);
+};
+
+#if defined(ARDUINO)
+/**
+* @brief Print sink that runs a pixel stream before forwarding the data
+*
+* Pass it to readImageTo() to send a cropped or converted frame.
+*/
+class Arducam_Qwiic_PixelPrint : public Print
+{
+private:
+	Arducam_Qwiic_PixelStream& pixels;                  /**< Kernels to run */
+	Print& sink;                                        /**< Receiver of the output */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the pixel sink
+	//!
+	//! @param  pixels Configured pixel stream
+	//! @param  sink Receiver of the output
+	//**********************************************
+	Arducam_Qwiic_PixelPrint(Arducam_Qwiic_PixelStream& pixels, Print& sink);
+
+	size_t write(uint8_t data);
+	size_t write(const uint8_t* buffer, size_t size);
+};
+#endif
+
+#endif /*__ARDUCAM_QWIIC_PIXEL_H*/
@@ -0,0 +1,329 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_Protocol.h"
+#include <string.h>
+
+enum {
+    DECODE_SYNC = 0,
+    DECODE_HEADER_SYNC,
+    DECODE_TYPE,
+    DECODE_LENGTH,
+    DECODE_PAYLOAD,
+    DECODE_CRC,
+    DECODE_TAIL_SYNC,
+    DECODE_TAIL_END,
+};
+
+// CRC-32 a nibble at a time, small enough for AVR RAM
+static const uint32_t crcNibble[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+    0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+    0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+static void putU32LE(uint8_t* out, uint32_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+size_t Arducam_Qwiic_PacketEncoder::encodeHeader(uint8_t* out, uint8_t type, uint32_t length, bool crc)
+{
+    out[0] = CAM_PROTO_SYNC;
+    out[1] = CAM_PROTO_HEADER_SYNC;
+    out[2] = crc ? (type | CAM_PROTO_CRC_FLAG) : type;
+    putU32LE(out + 3, length);
+    return CAM_PROTO_HEADER_SIZE;
+}
+
+size_t Arducam_Qwiic_PacketEncoder::encodeTail(uint8_t* out, bool crc, uint32_t crcValue)
+{
+    size_t pos = 0;
+    if (crc) {
+        putU32LE(out, crcValue);
+        pos = 4;
+    }
+    out[pos++] = CAM_PROTO_SYNC;
+    out[pos++] = CAM_PROTO_TAIL_SYNC;
+    return pos;
+}
+
+uint32_t Arducam_Qwiic_PacketEncoder::crc32(uint32_t crc, const uint8_t* data, size_t length)
+{
+    crc = ~crc;
+    while (length--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crcNibble[crc & 0x0f];
+        crc = (crc >> 4) ^ crcNibble[crc & 0x0f];
+    }
+    return ~crc;
+}
+
+#if defined(ARDUINO)
+Arducam_Qwiic_PacketWriter::Arducam_Qwiic_PacketWriter(Print& out, bool crc)
+    : out(out), useCrc(crc), crc(0), remaining(0)
+{
+}
+
+void Arducam_Qwiic_PacketWriter::setCrc(bool enable)
+{
+    useCrc = enable;
+}
+
+void Arducam_Qwiic_PacketWriter::begin(uint8_t type, uint32_t length)
+{
+    uint8_t header[CAM_PROTO_HEADER_SIZE];
+    Arducam_Qwiic_PacketEncoder::encodeHeader(header, type, length, useCrc);
+    out.write(header, sizeof(header));
+    crc = 0;
+    remaining = length;
+}
+
+size_t Arducam_Qwiic_PacketWriter::write(uint8_t data)
+{
+    return write(&data, 1);
+}
+
+size_t Arducam_Qwiic_PacketWriter::write(const uint8_t* data, size_t length)
+{
+    // Never send more than the header announced
+    if (length > remaining) {
+        length = remaining;
+    }
+    size_t written = out.write(data, length);
+    if (useCrc) {
+        crc = Arducam_Qwiic_PacketEncoder::crc32(crc, data, written);
+    }
+    remaining -= written;
+    return written;
+}
+
+void Arducam_Qwiic_PacketWriter::end(void)
+{
+    // Keep the host in sync when the payload came up short
+    static const uint8_t zeros[16] = {0};
+    while (remaining > 0) {
+        size_t n = (remaining > sizeof(zeros)) ? sizeof(zeros) : remaining;
+        if (write(zeros, n) == 0) {
+            break;
+        }
+    }
+
+    uint8_t tail[CAM_PROTO_TAIL_SIZE];
+    size_t tailLen = Arducam_Qwiic_PacketEncoder::encodeTail(tail, useCrc, crc);
+    out.write(tail, tailLen);
+}
+
+void Arducam_Qwiic_PacketWriter::send(uint8_t type, const uint8_t* data, uint32_t length)
+{
+    begin(type, length);
+    write(data, length);
+    end();
+}
+
+uint32_t Arducam_Qwiic_PacketWriter::sendImage(Arducam_Qwiic_CAM& cam, uint8_t type, size_t chunk)
+{
+    begin(type, cam.getTotalLength());
+    uint32_t sent = cam.readImageTo(*this, chunk);
+    end();
+    return sent;
+}
+#endif
+
+Arducam_Qwiic_CommandDecoder::Arducam_Qwiic_CommandDecoder()
+{
+    lastByteMs = 0;
+    reset();
+}
+
+void Arducam_Qwiic_CommandDecoder::reset(void)
+{
+    length = 0;
+    receiving = false;
+    ready = false;
+}
+
+CAM_PROTO_CMD_RESULT Arducam_Qwiic_CommandDecoder::feed(uint8_t b, unsigned long nowMs)
+{
+    checkTimeout(nowMs);
+    lastByteMs = nowMs;
+
+    if (!receiving) {
+        if (b == CAM_PROTO_SYNC) {
+            receiving = true;
+            ready = false;
+            length = 0;
+        }
+        return CAM_PROTO_CMD_NONE;
+    }
+
+    if (b == CAM_PROTO_CMD_END) {
+        receiving = false;
+        if (length > 0) {
+            ready = true;
+            return CAM_PROTO_CMD_READY;
+        }
+        return CAM_PROTO_CMD_NONE;
+    }
+
+    if (length >= QWIIC_CAM_PROTO_CMD_SIZE) {
+        reset();
+        return CAM_PROTO_CMD_OVERFLOW;
+    }
+    buf[length++] = b;
+    return CAM_PROTO_CMD_NONE;
+}
+
+void Arducam_Qwiic_CommandDecoder::checkTimeout(unsigned long nowMs)
+{
+    if (receiving && (nowMs - lastByteMs > QWIIC_CAM_PROTO_CMD_TIMEOUT_MS)) {
+        reset();
+    }
+}
+
+const uint8_t* Arducam_Qwiic_CommandDecoder::getCommand() const
+{
+    return buf;
+}
+
+uint8_t Arducam_Qwiic_CommandDecoder::getLength() const
+{
+    return ready ? length : 0;
+}
+
+Arducam_Qwiic_PacketDecoder::Arducam_Qwiic_PacketDecoder(uint32_t maxLength) : maxLength(maxLength)
+{
+    reset();
+}
+
+void Arducam_Qwiic_PacketDecoder::reset(void)
+{
+    state = DECODE_SYNC;
+    type = 0;
+    length = 0;
+    remaining = 0;
+    crc = 0;
+    rxCrc = 0;
+    fieldPos = 0;
+}
+
+size_t Arducam_Qwiic_PacketDecoder::feed(const uint8_t* data, size_t size, CamPacketEvent* ev)
+{
+    size_t pos = 0;
+    ev->event = CAM_PROTO_EVENT_NONE;
+    ev->data = NULL;
+
+    while (pos < size) {
+        if (state == DECODE_PAYLOAD) {
+            size_t n = size - pos;
+            if (n > remaining) {
+                n = remaining;
+            }
+            if (type & CAM_PROTO_CRC_FLAG) {
+                crc = Arducam_Qwiic_PacketEncoder::crc32(crc, data + pos, n);
+            }
+            remaining -= n;
+            if (remaining == 0) {
+                state = (type & CAM_PROTO_CRC_FLAG) ? DECODE_CRC : DECODE_TAIL_SYNC;
+                fieldPos = 0;
+                rxCrc = 0;
+            }
+            ev->event = CAM_PROTO_EVENT_PAYLOAD;
+            ev->type = type & ~CAM_PROTO_CRC_FLAG;
+            ev->hasCrc = (type & CAM_PROTO_CRC_FLAG) != 0;
+            ev->data = data + pos;
+            ev->length = n;
+            return pos + n;
+        }
+
+        uint8_t b = data[pos++];
+        switch (state) {
+        case DECODE_SYNC:
+            if (b == CAM_PROTO_SYNC) {
+                state = DECODE_HEADER_SYNC;
+            }
+            break;
+
+        case DECODE_HEADER_SYNC:
+            if (b != CAM_PROTO_SYNC) {
+                state = (b == CAM_PROTO_HEADER_SYNC) ? DECODE_TYPE : DECODE_SYNC;
+            }
+            break;
+
+        case DECODE_TYPE:
+            type = b;
+            length = 0;
+            fieldPos = 0;
+            state = DECODE_LENGTH;
+            break;
+
+        case DECODE_LENGTH:
+            length |= (uint32_t)b << (8 * fieldPos);
+            if (++fieldPos < 4) {
+                break;
+            }
+            if (length > maxLength) {
+                reset();
+                ev->event = CAM_PROTO_EVENT_ERROR;
+                return pos;
+            }
+            remaining = length;
+            crc = 0;
+            rxCrc = 0;
+            fieldPos = 0;
+            if (length > 0) {
+                state = DECODE_PAYLOAD;
+            } else {
+                state = (type & CAM_PROTO_CRC_FLAG) ? DECODE_CRC : DECODE_TAIL_SYNC;
+            }
+            ev->event = CAM_PROTO_EVENT_HEADER;
+            ev->type = type & ~CAM_PROTO_CRC_FLAG;
+            ev->hasCrc = (type & CAM_PROTO_CRC_FLAG) != 0;
+            ev->length = length;
+            return pos;
+
+        case DECODE_CRC:
+            rxCrc |= (uint32_t)b << (8 * fieldPos);
+            if (++fieldPos == 4) {
+                state = DECODE_TAIL_SYNC;
+            }
+            break;
+
+        case DECODE_TAIL_SYNC:
+            if (b != CAM_PROTO_SYNC) {
+                reset();
+                ev->event = CAM_PROTO_EVENT_ERROR;
+                return pos;
+            }
+            state = DECODE_TAIL_END;
+            break;
+
+        default: // DECODE_TAIL_END
+            if (b != CAM_PROTO_TAIL_SYNC) {
+                // The 0x55 may have been the start of the next packet
+                reset();
+                state = (b == CAM_PROTO_HEADER_SYNC) ? DECODE_TYPE : DECODE_SYNC;
+                ev->event = CAM_PROTO_EVENT_ERROR;
+                return pos;
+            }
+            ev->event = ((type & CAM_PROTO_CRC_FLAG) && rxCrc != crc) ? CAM_PROTO_EVENT_ERROR : CAM_PROTO_EVENT_END;
+            ev->type = type & ~CAM_PROTO_CRC_FLAG;
+            ev->hasCrc = (type & CAM_PROTO_CRC_FLAG) != 0;
+            ev->length = length;
+            reset();
+            return pos;
+        }
+    }
+    return pos;
+}
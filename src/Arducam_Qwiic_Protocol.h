@@ -0,0 +1,308 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_PROTOCOL_H
+#define __ARDUCAM_QWIIC_PROTOCOL_H
+
+#include "Arducam_Qwiic_CAM.h"
+
+/**
+* @file Arducam_Qwiic_Protocol.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*
+* Serial host protocol of the examples.
+*
+* Host to camera:  0x55 [command] [parameters...] 0xAA
+* Camera to host:  0x55 0xAA [type] [length, 4 bytes LE] [payload]
+*                  [CRC-32 LE, only if type has CAM_PROTO_CRC_FLAG] 0x55 0xBB
+*/
+
+#define CAM_PROTO_SYNC              0x55
+#define CAM_PROTO_CMD_END           0xAA
+#define CAM_PROTO_HEADER_SYNC       0xAA
+#define CAM_PROTO_TAIL_SYNC         0xBB
+#define CAM_PROTO_CRC_FLAG          0x80  // Packet type bit: a CRC-32 of the payload precedes the tail
+#define CAM_PROTO_HEADER_SIZE       7
+#define CAM_PROTO_TAIL_SIZE         6     // Largest tail, with CRC
+
+#if !defined(QWIIC_CAM_PROTO_CMD_SIZE)
+#define QWIIC_CAM_PROTO_CMD_SIZE    32    // Longest host command
+#endif
+
+#if !defined(QWIIC_CAM_PROTO_CMD_TIMEOUT_MS)
+#define QWIIC_CAM_PROTO_CMD_TIMEOUT_MS 200 // Gap that abandons a partial command
+#endif
+
+/**
+* @brief Builds the bytes of camera to host packets
+*/
+class Arducam_Qwiic_PacketEncoder
+{
+public:
+	//**********************************************
+	//!
+	//! @brief Encode a packet header
+	//!
+	//! @param  out Buffer of CAM_PROTO_HEADER_SIZE bytes
+	//! @param  type Packet type, CAM_PROTO_CRC_FLAG is added when crc is set
+	//! @param  length Payload length
+	//! @param  crc Packet carries a CRC-32
+	//!
+	//! @return Return the header size
+	//**********************************************
+	static size_t encodeHeader(uint8_t* out, uint8_t type, uint32_t length, bool crc);
+
+	//**********************************************
+	//!
+	//! @brief Encode a packet tail
+	//!
+	//! @param  out Buffer of CAM_PROTO_TAIL_SIZE bytes
+	//! @param  crc Packet carries a CRC-32
+	//! @param  crcValue CRC-32 of the payload
+	//!
+	//! @return Return the tail size
+	//**********************************************
+	static size_t encodeTail(uint8_t* out, bool crc, uint32_t crcValue);
+
+	//**********************************************
+	//!
+	//! @brief Continue a CRC-32 (IEEE 802.3, as zlib crc32())
+	//!
+	//! @param  crc CRC of the data so far, 0 to start
+	//! @param  data Next data
+	//! @param  length Data length
+	//!
+	//! @return Return the CRC including data
+	//**********************************************
+	static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length);
+};
+
+#if defined(ARDUINO)
+/**
+* @brief Writes camera to host packets to a Print sink
+*
+* Header, payload and tail each go out as one write. Between begin() and
+* end() the writer is itself a Print, so readImageTo() can stream the
+* FIFO straight into the payload.
+*/
+class Arducam_Qwiic_PacketWriter : public Print
+{
+private:
+	Print& out;                                         /**< Serial port or other sink */
+	bool useCrc;                                        /**< Send CAM_PROTO_CRC_FLAG packets */
+	uint32_t crc;                                       /**< CRC of the payload so far */
+	uint32_t remaining;                                 /**< Payload bytes still to send */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the packet writer
+	//!
+	//! @param  out Serial port or other sink
+	//! @param  crc Add a CRC-32 to every packet
+	//**********************************************
+	explicit Arducam_Qwiic_PacketWriter(Print& out, bool crc = false);
+
+	//**********************************************
+	//!
+	//! @brief Enable or disable the CRC-32
+	//**********************************************
+	void setCrc(bool enable);
+
+	//**********************************************
+	//!
+	//! @brief Start a packet
+	//!
+	//! @param  type Packet type
+	//! @param  length Exact payload length
+	//**********************************************
+	void begin(uint8_t type, uint32_t length);
+
+	size_t write(uint8_t data);
+	size_t write(const uint8_t* data, size_t length);
+
+	//**********************************************
+	//!
+	//! @brief Finish a packet, padding a short payload with zeros
+	//**********************************************
+	void end(void);
+
+	//**********************************************
+	//!
+	//! @brief Send a whole packet
+	//!
+	//! @param  type Packet type
+	//! @param  data Payload
+	//! @param  length Payload length
+	//**********************************************
+	void send(uint8_t type, const uint8_t* data, uint32_t length);
+
+	//**********************************************
+	//!
+	//! @brief Send the frame waiting in the camera FIFO as one packet
+	//!
+	//! @param  cam Camera holding the frame
+	//! @param  type Packet type
+	//! @param  chunk FIFO read size, 0 for the bus maximum
+	//!
+	//! @return Return the image bytes read from the camera
+	//!
+	//! @note The length is taken from getTotalLength(), so JPEG trimming
+	//! must be off
+	//**********************************************
+	uint32_t sendImage(Arducam_Qwiic_CAM& cam, uint8_t type, size_t chunk = 0);
+};
+#endif
+
+/**
+ * @enum CAM_PROTO_CMD_RESULT
+ * @brief Result of feeding bytes to Arducam_Qwiic_CommandDecoder
+ */
+typedef enum {
+    CAM_PROTO_CMD_NONE = 0,    /**< Need more bytes */
+    CAM_PROTO_CMD_READY,       /**< A command is complete */
+    CAM_PROTO_CMD_OVERFLOW     /**< The command was longer than QWIIC_CAM_PROTO_CMD_SIZE and was dropped */
+} CAM_PROTO_CMD_RESULT;
+
+/**
+* @brief Parses host to camera commands
+*/
+class Arducam_Qwiic_CommandDecoder
+{
+private:
+	uint8_t buf[QWIIC_CAM_PROTO_CMD_SIZE];              /**< Command bytes */
+	uint8_t length;                                     /**< Bytes in buf */
+	bool receiving;                                     /**< Start byte seen */
+	bool ready;                                         /**< buf holds a complete command */
+	unsigned long lastByteMs;                           /**< Time of the last byte */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the command decoder
+	//**********************************************
+	Arducam_Qwiic_CommandDecoder();
+
+	//**********************************************
+	//!
+	//! @brief Feed one received byte
+	//!
+	//! @param  b Received byte
+	//! @param  nowMs Current time, for the inter-byte timeout
+	//!
+	//! @return Return the decoder result
+	//**********************************************
+	CAM_PROTO_CMD_RESULT feed(uint8_t b, unsigned long nowMs);
+
+	//**********************************************
+	//!
+	//! @brief Drop a partial command after QWIIC_CAM_PROTO_CMD_TIMEOUT_MS of silence
+	//!
+	//! @param  nowMs Current time
+	//**********************************************
+	void checkTimeout(unsigned long nowMs);
+
+	//**********************************************
+	//!
+	//! @brief Get the last complete command, the command byte first
+	//!
+	//! @return Return the command bytes
+	//**********************************************
+	const uint8_t* getCommand() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the length of the last complete command
+	//!
+	//! @return Return the number of bytes, 0 if none is ready
+	//**********************************************
+	uint8_t getLength() const;
+
+	//**********************************************
+	//!
+	//! @brief Forget any partial command
+	//**********************************************
+	void reset(void);
+};
+
+/**
+ * @enum CAM_PROTO_EVENT
+ * @brief Event reported by Arducam_Qwiic_PacketDecoder
+ */
+typedef enum {
+    CAM_PROTO_EVENT_NONE = 0,  /**< All input consumed, no event */
+    CAM_PROTO_EVENT_HEADER,    /**< Header decoded, type and length are valid */
+    CAM_PROTO_EVENT_PAYLOAD,   /**< data/length hold the next payload piece */
+    CAM_PROTO_EVENT_END,       /**< Packet complete and intact */
+    CAM_PROTO_EVENT_ERROR      /**< Bad length, CRC or tail, the decoder resyncs */
+} CAM_PROTO_EVENT;
+
+/**
+ * @struct CamPacketEvent
+ * @brief Output of Arducam_Qwiic_PacketDecoder::feed()
+ */
+typedef struct {
+    uint8_t event;             /**< CAM_PROTO_EVENT */
+    uint8_t type;              /**< Packet type without CAM_PROTO_CRC_FLAG */
+    bool hasCrc;               /**< Packet carried a CRC-32 */
+    uint32_t length;           /**< Payload length of the packet, or of the piece for PAYLOAD */
+    const uint8_t* data;       /**< Payload piece, points into the input */
+} CamPacketEvent;
+
+/**
+* @brief Parses camera to host packets, for hosts and tests
+*
+* Payload is handed out in pieces that point into the input, so packets of
+* any size are decoded without a copy. After an error the decoder searches
+* for the next 0x55 0xAA.
+*/
+class Arducam_Qwiic_PacketDecoder
+{
+private:
+	uint8_t state;                                      /**< Parser state */
+	uint8_t type;                                       /**< Type byte of the current packet */
+	uint32_t length;                                    /**< Payload length of the current packet */
+	uint32_t remaining;                                 /**< Payload bytes still expected */
+	uint32_t crc;                                       /**< CRC of the payload so far */
+	uint32_t rxCrc;                                     /**< CRC received in the tail */
+	uint8_t fieldPos;                                   /**< Bytes of the current field seen */
+	uint32_t maxLength;                                 /**< Longest payload accepted */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the packet decoder
+	//!
+	//! @param  maxLength Longest payload accepted, longer headers are errors
+	//**********************************************
+	explicit Arducam_Qwiic_PacketDecoder(uint32_t maxLength = 0x80000);
+
+	//**********************************************
+	//!
+	//! @brief Decode received bytes up to the next event
+	//!
+	//! @param  data Received bytes
+	//! @param  length Number of bytes
+	//! @param  ev Event found
+	//!
+	//! @return Return the bytes consumed, call again with the rest
+	//**********************************************
+	size_t feed(const uint8_t* data, size_t length, CamPacketEvent* ev);
+
+	//**********************************************
+	//!
+	//! @brief Start searching for a new packet
+	//**********************************************
+	void reset(void);
+};
+
+#endif /*__ARDUCAM_QWIIC_PROTOCOL_H*/
@@ -0,0 +1,130 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+
+#include "Arducam_Qwiic_TimedBus.h"
+#include <string.h>
+
+Arducam_Qwiic_TimedBus::Arducam_Qwiic_TimedBus(Arducam_Qwiic_Bus& inner) : inner(inner)
+{
+    clockHz = 0;
+    overheadUs = QWIIC_CAM_BUS_OVERHEAD_US;
+    readStartUs = 0;
+    reset();
+}
+
+bool Arducam_Qwiic_TimedBus::begin(void)
+{
+    return inner.begin();
+}
+
+void Arducam_Qwiic_TimedBus::setClock(uint32_t hz)
+{
+    clockHz = hz;
+    inner.setClock(hz);
+}
+
+bool Arducam_Qwiic_TimedBus::write(uint8_t addr, const uint8_t* data, size_t length)
+{
+    unsigned long startUs = micros();
+    bool ok = inner.write(addr, data, length);
+    counters.busyUs += micros() - startUs;
+    counters.writes++;
+    counters.bytesOut += length;
+    return ok;
+}
+
+size_t Arducam_Qwiic_TimedBus::writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length)
+{
+    unsigned long startUs = micros();
+    size_t received = inner.writeRead(addr, reg, buf, length);
+    counters.busyUs += micros() - startUs;
+    counters.reads++;
+    counters.bytesOut++;
+    counters.bytesIn += received;
+    return received;
+}
+
+size_t Arducam_Qwiic_TimedBus::maxReadLength(void) const
+{
+    return inner.maxReadLength();
+}
+
+bool Arducam_Qwiic_TimedBus::startRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length)
+{
+    readStartUs = micros();
+    return inner.startRead(addr, reg, buf, length);
+}
+
+bool Arducam_Qwiic_TimedBus::pollRead(size_t* received)
+{
+    if (!inner.pollRead(received)) {
+        return false;
+    }
+    // Time in flight is counted as busy, the caller was free to work meanwhile
+    counters.busyUs += micros() - readStartUs;
+    counters.reads++;
+    counters.bytesOut++;
+    counters.bytesIn += *received;
+    return true;
+}
+
+void Arducam_Qwiic_TimedBus::cancelRead(void)
+{
+    inner.cancelRead();
+    counters.busyUs += micros() - readStartUs;
+    counters.reads++;
+    counters.bytesOut++;
+}
+
+#if defined(ARDUINO)
+size_t Arducam_Qwiic_TimedBus::writeReadTo(uint8_t addr, uint8_t reg, Print& out, size_t length)
+{
+    // The sink's own time is counted too, it is usually small next to the bus
+    unsigned long startUs = micros();
+    size_t received = inner.writeReadTo(addr, reg, out, length);
+    counters.busyUs += micros() - startUs;
+    counters.reads++;
+    counters.bytesOut++;
+    counters.bytesIn += received;
+    return received;
+}
+#endif
+
+void Arducam_Qwiic_TimedBus::setOverheadUs(uint16_t us)
+{
+    overheadUs = us;
+}
+
+uint32_t Arducam_Qwiic_TimedBus::getClock() const
+{
+    return clockHz;
+}
+
+const CamBusCounters& Arducam_Qwiic_TimedBus::getCounters() const
+{
+    return counters;
+}
+
+uint32_t Arducam_Qwiic_TimedBus::modelUs(uint32_t hz) const
+{
+    if (hz == 0) {
+        return 0;
+    }
+    // A write sends one address byte, a write-read two (before and after the repeated start)
+    uint64_t bytes = (uint64_t)counters.bytesOut + counters.bytesIn + counters.writes + 2ULL * counters.reads;
+    uint32_t transactions = counters.writes + counters.reads;
+    uint64_t us = bytes * 9 * 1000000ULL / hz + (uint64_t)transactions * overheadUs;
+    return (us > 0xffffffffULL) ? 0xffffffffUL : (uint32_t)us;
+}
+
+void Arducam_Qwiic_TimedBus::reset(void)
+{
+    memset(&counters, 0, sizeof(counters));
+}
@@ -0,0 +1,118 @@
+/*
+* This file is part of the Arducam Qwiic Camera project.
+*
+* Copyright 2026 Arducam Technology co., Ltd. All Rights Reserved.
+*
+* This work is licensed under the MIT license, see the file LICENSE for
+* details.
+*
+*/
+#ifndef __ARDUCAM_QWIIC_TIMEDBUS_H
+#define __ARDUCAM_QWIIC_TIMEDBUS_H
+
+#include "Arducam_Qwiic_Bus.h"
+
+/**
+* @file Arducam_Qwiic_TimedBus.h
+* @author Arducam
+* @date 2026/6/12
+* @version V2.0.0
+* @copyright Arducam
+*/
+
+#if !defined(QWIIC_CAM_BUS_OVERHEAD_US)
+#define QWIIC_CAM_BUS_OVERHEAD_US     20  // Default software and start/stop gap per transaction
+#endif
+
+/**
+ * @struct CamBusCounters
+ * @brief Traffic seen by Arducam_Qwiic_TimedBus
+ */
+typedef struct {
+    uint32_t writes;           /**< Write transactions */
+    uint32_t reads;            /**< Write-read transactions */
+    uint32_t bytesOut;         /**< Bytes sent after the address, register addresses included */
+    uint32_t bytesIn;          /**< Bytes received */
+    uint32_t busyUs;           /**< Measured time spent inside the wrapped bus */
+} CamBusCounters;
+
+/**
+* @brief Bus decorator that counts traffic and models its duration
+*
+* Wrap the real backend to measure how much of a capture is spent on the
+* bus, and to project the bus time of the same traffic at another clock.
+* A byte costs 9 clocks (8 bits and ACK), every transaction costs its
+* address bytes plus a fixed overhead.
+*/
+class Arducam_Qwiic_TimedBus : public Arducam_Qwiic_Bus
+{
+private:
+	Arducam_Qwiic_Bus& inner;                           /**< Backend doing the transfers */
+	uint32_t clockHz;                                   /**< Clock last set with setClock() */
+	uint16_t overheadUs;                                /**< Modelled cost per transaction */
+	CamBusCounters counters;                            /**< Traffic since reset() */
+	unsigned long readStartUs;                          /**< Start of the read in flight */
+
+public:
+	//**********************************************
+	//!
+	//! @brief Constructor of the timed bus
+	//!
+	//! @param  inner Backend doing the transfers
+	//**********************************************
+	explicit Arducam_Qwiic_TimedBus(Arducam_Qwiic_Bus& inner);
+
+	bool begin(void);
+	void setClock(uint32_t hz);
+	bool write(uint8_t addr, const uint8_t* data, size_t length);
+	size_t writeRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length);
+	size_t maxReadLength(void) const;
+	bool startRead(uint8_t addr, uint8_t reg, uint8_t* buf, size_t length);
+	bool pollRead(size_t* received);
+	void cancelRead(void);
+#if defined(ARDUINO)
+	size_t writeReadTo(uint8_t addr, uint8_t reg, Print& out, size_t length);
+#endif
+
+	//**********************************************
+	//!
+	//! @brief Set the modelled cost of a transaction beyond its bits
+	//!
+	//! @param  us Start/stop gap and driver time in microseconds
+	//**********************************************
+	void setOverheadUs(uint16_t us);
+
+	//**********************************************
+	//!
+	//! @brief Get the clock last set on the bus
+	//!
+	//! @return Return the clock in Hz, 0 before setClock()
+	//**********************************************
+	uint32_t getClock() const;
+
+	//**********************************************
+	//!
+	//! @brief Get the traffic since reset()
+	//!
+	//! @return Return the counters
+	//**********************************************
+	const CamBusCounters& getCounters() const;
+
+	//**********************************************
+	//!
+	//! @brief Model the bus time of the counted traffic
+	//!
+	//! @param  hz Bus clock to model
+	//!
+	//! @return Return the time in microseconds
+	//**********************************************
+	uint32_t modelUs(uint32_t hz) const;
+
+	//**********************************************
+	//!
+	//! @brief Clear the counters
+	//**********************************************
+	void reset(void);
+};
+
+#endif /*__ARDUCAM_QWIIC_TIMEDBUS_H*/